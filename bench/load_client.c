@@ -0,0 +1,116 @@
+/**
+ * @file load_client.c
+ * @brief Load generator for the gate controller server.
+ *
+ * Opens several connections to a running `ParkingGarageSystem --server`
+ * instance and keeps a fixed number of pipelined commands in flight on each,
+ * then prints the achieved request rate.
+ *
+ * Usage: LoadClient <socket> [connections] [requests per connection] [pipeline depth]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/// @brief Per-connection progress
+typedef struct {
+    int fd;
+    long sent;
+    long received;
+} Client;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Formats request number i of a connection.
+ *
+ * Cycles through entry, occupancy query and exit for a per-connection plate.
+ */
+static int format_request(char *buf, size_t size, int conn, long i) {
+    int minute = (int)(i / 3 % 600);
+    switch (i % 3) {
+        case 0:
+            return snprintf(buf, size, "ENTRY L%d-%ld %02d:%02d\n", conn, i / 3, 8 + minute / 60, minute % 60);
+        case 1:
+            return snprintf(buf, size, "OCC\n");
+        default:
+            return snprintf(buf, size, "EXIT L%d-%ld %02d:%02d\n", conn, i / 3, 9 + minute / 60, minute % 60);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <socket> [connections] [requests] [depth]\n", argv[0]);
+        return 1;
+    }
+    const char *path = argv[1];
+    int connections = argc > 2 ? atoi(argv[2]) : 8;
+    long requests = argc > 3 ? atol(argv[3]) : 100000;
+    int depth = argc > 4 ? atoi(argv[4]) : 32;
+
+    Client *clients = calloc((size_t)connections, sizeof(Client));
+    for (int c = 0; c < connections; ++c) {
+        struct sockaddr_un addr = {0};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+        clients[c].fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connect(clients[c].fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+            perror("connect");
+            return 1;
+        }
+    }
+
+    char *out = malloc((size_t)depth * 64);
+    char in[65536];
+    double start = now_seconds();
+    long done = 0;
+
+    // Round-robin over connections: top up each pipeline, then read what came back
+    while (done < (long)connections * requests) {
+        for (int c = 0; c < connections; ++c) {
+            Client *cl = &clients[c];
+            size_t len = 0;
+            while (cl->sent < requests && cl->sent - cl->received < depth) {
+                len += (size_t)format_request(out + len, 64, c, cl->sent);
+                cl->sent++;
+            }
+            if (len > 0 && write(cl->fd, out, len) != (ssize_t)len) {
+                perror("write");
+                return 1;
+            }
+        }
+        for (int c = 0; c < connections; ++c) {
+            Client *cl = &clients[c];
+            if (cl->received == cl->sent) continue;
+            ssize_t n = read(cl->fd, in, sizeof(in));
+            if (n <= 0) {
+                perror("read");
+                return 1;
+            }
+            for (ssize_t i = 0; i < n; ++i) {
+                if (in[i] == '\n') {
+                    cl->received++;
+                    done++;
+                }
+            }
+        }
+    }
+
+    double elapsed = now_seconds() - start;
+    printf("%d connections, %ld requests each, depth %d: %.0f req/s (%.3f s)\n",
+           connections, requests, depth, done / elapsed, elapsed);
+
+    for (int c = 0; c < connections; ++c) close(clients[c].fd);
+    free(clients);
+    free(out);
+    return 0;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file proto_bench.c
+ * @brief Throughput comparison of the text and binary gate protocols.
+ *
+ * Starts an in-process server on a temporary socket, then runs the same
+ * pipelined entry/query/exit workload once over the text protocol and once
+ * over the binary protocol and prints the request rate of each.
+ *
+ * Usage: ProtoBench [requests] [pipeline depth]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "binproto.h"
+#include "garage.h"
+#include "server.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *server_thread(void *arg) {
+    server_run((Server *)arg);
+    return NULL;
+}
+
+/// @brief Time of request i in the shared workload
+static Time workload_time(long i, int is_exit) {
+    int minute = (int)(i / 3 % 600);
+    Time t = {8 + is_exit + minute / 60, minute % 60};
+    return t;
+}
+
+static double run_text(const char *path, long requests, int depth) {
+    int fd = binclient_connect(path);
+    char *out = malloc((size_t)depth * 48);
+    char in[65536];
+    long sent = 0, received = 0;
+    double start = now_seconds();
+
+    while (received < requests) {
+        size_t len = 0;
+        while (sent < requests && sent - received < depth) {
+            Time t = workload_time(sent, sent % 3 == 2);
+            if (sent % 3 == 1) {
+                len += (size_t)sprintf(out + len, "OCC\n");
+            } else {
+                len += (size_t)sprintf(out + len, "%s P%ld %02d:%02d\n",
+                                       sent % 3 == 0 ? "ENTRY" : "EXIT", sent / 3, t.hour, t.minute);
+            }
+            sent++;
+        }
+        if (len > 0 && write(fd, out, len) != (ssize_t)len) break;
+
+        ssize_t n = read(fd, in, sizeof(in));
+        if (n <= 0) break;
+        for (ssize_t i = 0; i < n; ++i) {
+            if (in[i] == '\n') received++;
+        }
+    }
+
+    double elapsed = now_seconds() - start;
+    close(fd);
+    free(out);
+    return received / elapsed;
+}
+
+static double run_binary(const char *path, long requests, int depth) {
+    int fd = binclient_connect(path);
+    BinRequest *reqs = malloc((size_t)depth * sizeof(BinRequest));
+    BinResponse *resps = malloc((size_t)depth * sizeof(BinResponse));
+    long done = 0;
+    double start = now_seconds();
+
+    while (done < requests) {
+        int batch = 0;
+        while (batch < depth && done + batch < requests) {
+            long i = done + batch;
+            char plate[24]; // "P" and up to 20 digits of a long
+            snprintf(plate, sizeof(plate), "P%ld", i / 3);
+            BinOp op = i % 3 == 0 ? BIN_OP_ENTRY : i % 3 == 1 ? BIN_OP_OCCUPANCY : BIN_OP_EXIT;
+            binproto_make_request(&reqs[batch], op, plate, workload_time(i, i % 3 == 2), (uint32_t)i);
+            batch++;
+        }
+        if (binclient_send(fd, reqs, batch) != 0 || binclient_recv(fd, resps, batch) != 0) break;
+        done += batch;
+    }
+
+    double elapsed = now_seconds() - start;
+    close(fd);
+    free(reqs);
+    free(resps);
+    return done / elapsed;
+}
+
+int main(int argc, char *argv[]) {
+    long requests = argc > 1 ? atol(argv[1]) : 1000000;
+    int depth = argc > 2 ? atoi(argv[2]) : 64;
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/proto_bench_%d.sock", (int)getpid());
+
+    Garage g;
+    init_garage(&g);
+    Server *s = server_create(&g, path);
+    if (!s) return 1;
+
+    pthread_t tid;
+    pthread_create(&tid, NULL, server_thread, s);
+
+    double text_rate = run_text(path, requests, depth);
+    free_garage(&g); // server is idle between runs
+    init_garage(&g);
+    double binary_rate = run_binary(path, requests, depth);
+
+    server_stop(s);
+    pthread_join(tid, NULL);
+    server_destroy(s);
+    free_garage(&g);
+
+    printf("%ld requests, depth %d\n", requests, depth);
+    printf("  text:   %.0f req/s\n", text_rate);
+    printf("  binary: %.0f req/s (%.2fx)\n", binary_rate, binary_rate / text_rate);
+    return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file report_bench.c
+ * @brief Scaling of the batch report pool from 1 to N threads.
+ *
+ * Fills a number of garages with a full day of traffic (every slot used,
+ * most vehicles exited, some still inside), then writes all their reports
+ * into a directory with 1, 2, 4, ... threads up to the number of online
+ * CPUs (or the given maximum) and prints the time and speedup of each run.
+ * The reports are removed afterwards.
+ *
+ * Usage: ReportBench [garages] [directory] [max threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "garage.h"
+#include "functions.h"
+#include "report_pool.h"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void fill_garage(Garage *g, int seed) {
+    char plate[20];
+    init_garage(g);
+    for (int v = 0; v < GARAGE_CAPACITY; ++v) {
+        snprintf(plate, sizeof(plate), "B%d-%d", seed, v);
+        int minute = 6 * 60 + (v * 7 + seed) % (12 * 60);
+        register_entry(g, plate, (Time){minute / 60, minute % 60});
+        if ((v + seed) % 5 != 0) {
+            int exit = minute + 30 + (v * 13 + seed) % 240;
+            log_exit(g, plate, (Time){exit / 60, exit % 60});
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int garages = argc > 1 ? atoi(argv[1]) : 500;
+    const char *dir = argc > 2 ? argv[2] : "/tmp";
+    if (garages <= 0) return 1;
+    long cpus = argc > 3 ? atol(argv[3]) : sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus <= 0) cpus = 1;
+
+    Garage *all = malloc(sizeof(Garage) * (size_t)garages);
+    const Garage **list = malloc(sizeof(Garage *) * (size_t)garages);
+    char **paths = malloc(sizeof(char *) * (size_t)garages);
+    if (!all || !list || !paths) return 1;
+    for (int i = 0; i < garages; ++i) {
+        fill_garage(&all[i], i);
+        list[i] = &all[i];
+        paths[i] = malloc(256);
+        snprintf(paths[i], 256, "%s/report_bench_garage%04d.txt", dir, i);
+    }
+
+    printf("Writing reports for %d garages on up to %ld threads...\n", garages, cpus);
+    double baseline = 0;
+    for (int threads = 1;; threads *= 2) {
+        if (threads > cpus) threads = (int)cpus;
+        ReportSummary summary;
+        double start = now_seconds();
+        int result = report_pool_run(list, (const char *const *)paths, garages, threads, &summary);
+        double elapsed = now_seconds() - start;
+        if (result != 0) {
+            fprintf(stderr, "%d reports could not be written to '%s'.\n", summary.failed, dir);
+            return 1;
+        }
+        if (threads == 1) baseline = elapsed;
+        char amount[32];
+        format_cents(summary.revenue_cents, amount, sizeof(amount));
+        printf("%3d threads: %.3f s (%.0f reports/s, speedup %.2fx, %d stolen), "
+               "%d served, €%s, %d still inside\n",
+               threads, elapsed, garages / elapsed, baseline / elapsed, summary.stolen,
+               summary.served, amount, summary.still_inside);
+        if (threads == cpus) break;
+    }
+
+    for (int i = 0; i < garages; ++i) {
+        unlink(paths[i]);
+        free(paths[i]);
+    }
+    free(paths);
+    free(list);
+    free(all);
+    return 0;
+}
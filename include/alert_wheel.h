@@ -0,0 +1,79 @@
+#ifndef ALERT_WHEEL_H
+#define ALERT_WHEEL_H
+
+#include <stdint.h>
+#include "structs.h"
+
+/// @file alert_wheel.h
+/// @brief Overstay and closing-time alerts on a two-level timing wheel
+///
+/// Every vehicle inside has at most one timer, keyed by the minute of its
+/// next deadline: entry time plus the stay limit, or closing time. Timers
+/// are armed on entry and disarmed on exit in O(1). The wheel is advanced
+/// by event times (and garage_advance_clock()); each minute passed costs one
+/// bucket visit and each fired alert calls the handler once.
+
+#define ALERT_WHEEL_NEAR 64 ///< One-minute buckets of the first level
+#define ALERT_WHEEL_FAR 32  ///< 64-minute buckets of the second level (covers a whole day)
+
+/// @brief Why an alert fired
+typedef enum {
+    ALERT_OVERSTAY, ///< Vehicle exceeded the maximum stay
+    ALERT_CLOSING   ///< Vehicle still inside at closing time
+} AlertReason;
+
+/// @brief Called for every alert; must not modify the garage
+typedef void (*AlertHandler)(void *ctx, const Vehicle *v, AlertReason reason, Time deadline);
+
+/// @brief Timer of one record slot, linked into a wheel bucket
+typedef struct {
+    int16_t next;     ///< Next slot in the bucket, -1 at the end
+    int16_t prev;     ///< Previous slot in the bucket, -1 at the head
+    int16_t bucket;   ///< Bucket the timer is linked into, -1 if disarmed
+    int16_t deadline; ///< Deadline in minutes since midnight
+    uint8_t reason;   ///< AlertReason the timer fires with
+} AlertTimer;
+
+/// @brief Alert counters
+typedef struct {
+    long overstay; ///< Overstay alerts fired
+    long closing;  ///< Closing-time alerts fired
+} AlertStats;
+
+/// @brief Timing wheel state
+typedef struct AlertWheel {
+    int now;                                         ///< Last minute processed, -1 before the first
+    int max_stay;                                    ///< Stay limit in minutes, 0 for none
+    int closing;                                     ///< Closing minute, -1 for none
+    int16_t heads[ALERT_WHEEL_NEAR + ALERT_WHEEL_FAR]; ///< First slot of each bucket, -1 if empty
+    AlertTimer timers[GARAGE_CAPACITY];              ///< Intrusive timer per record slot
+    const Garage *garage;                            ///< Garage the slots belong to
+    AlertHandler handler;                            ///< Alert callback
+    void *handler_ctx;                               ///< Context passed to the handler
+    AlertStats stats;                                ///< Counters
+} AlertWheel;
+
+/// @brief Initializes an alert wheel
+/// @param w Wheel
+/// @param max_stay_minutes Maximum stay in minutes (0 disables overstay alerts)
+/// @param closing Closing time, or NULL to disable closing alerts
+/// @param handler Alert callback
+/// @param ctx Context passed to the handler
+void alert_wheel_init(AlertWheel *w, int max_stay_minutes, const Time *closing, AlertHandler handler, void *ctx);
+
+/// @brief Arms the timer of a vehicle that is inside (re-arms it if already armed)
+/// @param w Wheel
+/// @param slot Record slot of the vehicle
+void alert_wheel_arm(AlertWheel *w, int slot);
+
+/// @brief Disarms the timer of a slot (no-op if not armed)
+/// @param w Wheel
+/// @param slot Record slot
+void alert_wheel_disarm(AlertWheel *w, int slot);
+
+/// @brief Fires every timer due up to and including a minute
+/// @param w Wheel
+/// @param now Current minute since midnight; earlier minutes are ignored
+void alert_wheel_advance(AlertWheel *w, int now);
+
+#endif //ALERT_WHEEL_H
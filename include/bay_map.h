@@ -0,0 +1,62 @@
+#ifndef BAY_MAP_H
+#define BAY_MAP_H
+
+/// @file bay_map.h
+/// @brief Physical parking bays tracked in a three-level bitmap
+///
+/// Bays are numbered level by level, and within a level by distance from
+/// the entry ramp, so the lowest free bay number is always the nearest free
+/// bay. Free bays are bits in 64-bit words; a summary word marks words with
+/// a free bay and a top word marks non-empty summary words, so allocating
+/// the nearest bay and freeing a bay are O(1) for up to 262144 bays.
+
+#define BAY_MAP_MAX_BAYS (64 * 64 * 64) ///< Bays a map can hold
+
+/// @brief Opaque bay map
+typedef struct BayMap BayMap;
+
+/// @brief Creates a bay map with all bays free
+/// @param levels Number of parking levels
+/// @param bays_per_level Bays on each level
+/// @return Bay map, or NULL if the size is invalid or allocation failed
+BayMap *bay_map_create(int levels, int bays_per_level);
+
+/// @brief Frees a bay map
+/// @param m Bay map (may be NULL)
+void bay_map_destroy(BayMap *m);
+
+/// @brief Takes the nearest free bay
+/// @param m Bay map
+/// @return Bay number, or -1 if every bay is taken
+int bay_map_alloc(BayMap *m);
+
+/// @brief Returns a bay
+/// @param m Bay map
+/// @param bay Bay number from bay_map_alloc()
+/// @return 0 on success, -1 if the bay is out of range or already free
+int bay_map_free(BayMap *m, int bay);
+
+/// @brief Number of free bays
+/// @param m Bay map
+/// @return Free bays on all levels
+int bay_map_free_count(const BayMap *m);
+
+/// @brief Number of parking levels
+/// @param m Bay map
+/// @return Levels
+int bay_map_levels(const BayMap *m);
+
+/// @brief Number of free bays on one level
+/// @param m Bay map
+/// @param level Level index
+/// @return Free bays on the level
+int bay_map_level_free(const BayMap *m, int level);
+
+/// @brief Splits a bay number into level and bay on that level
+/// @param m Bay map
+/// @param bay Bay number
+/// @param level Receives the level
+/// @param number Receives the bay on the level (0 is nearest the ramp)
+void bay_map_locate(const BayMap *m, int bay, int *level, int *number);
+
+#endif //BAY_MAP_H
@@ -0,0 +1,98 @@
+#ifndef BINPROTO_H
+#define BINPROTO_H
+
+#include <stdint.h>
+#include "structs.h"
+
+/// @file binproto.h
+/// @brief Fixed-layout binary gate protocol and client library
+///
+/// A connection switches to the binary protocol when its first byte is
+/// BINPROTO_MAGIC. Every request is a BinRequest and gets exactly one
+/// BinResponse, in request order. Fields use host byte order, since the
+/// protocol is only spoken over local Unix domain sockets.
+
+#define BINPROTO_MAGIC 0xB1
+
+/// @brief Binary request operations
+typedef enum {
+    BIN_OP_ENTRY = 1,         ///< register_entry()
+    BIN_OP_EXIT = 2,          ///< log_exit()
+    BIN_OP_CORRECT_ENTRY = 3, ///< update_entry_time()
+    BIN_OP_CORRECT_EXIT = 4,  ///< update_exit_time()
+    BIN_OP_OCCUPANCY = 5      ///< Occupancy query
+} BinOp;
+
+/// @brief Binary response status codes
+typedef enum {
+    BIN_OK = 0,        ///< Request applied
+    BIN_FULL = 1,      ///< Entry rejected
+    BIN_NOT_FOUND = 2, ///< Vehicle not found (or not in the required state)
+    BIN_ERROR = 3,     ///< Malformed request
+    BIN_DUPLICATE = 4  ///< Entry rejected: plate is already inside
+} BinStatus;
+
+/// @brief Binary request (28 bytes)
+typedef struct {
+    uint8_t magic;          ///< Always BINPROTO_MAGIC
+    uint8_t op;             ///< BinOp
+    uint8_t hour;           ///< Event hour (0-23)
+    uint8_t minute;         ///< Event minute (0-59)
+    uint32_t tag;           ///< Echoed in the response to match pipelined requests
+    char license_plate[20]; ///< NUL-terminated license plate
+} BinRequest;
+
+/// @brief Binary response (16 bytes)
+typedef struct {
+    uint8_t magic;     ///< Always BINPROTO_MAGIC
+    uint8_t status;    ///< BinStatus
+    uint16_t reserved; ///< Zero
+    uint32_t tag;      ///< Tag of the request this answers
+    int32_t value;     ///< Fee for exits, vehicles inside for occupancy queries
+    int32_t value2;    ///< Free spots for occupancy queries
+} BinResponse;
+
+_Static_assert(sizeof(BinRequest) == 28, "BinRequest layout changed");
+_Static_assert(sizeof(BinResponse) == 16, "BinResponse layout changed");
+
+/// @brief Fills in a binary request
+/// @param req Request to fill
+/// @param op Operation
+/// @param plate License plate (ignored for occupancy queries)
+/// @param time Event time
+/// @param tag Caller-chosen tag echoed in the response
+void binproto_make_request(BinRequest *req, BinOp op, const char *plate, Time time, uint32_t tag);
+
+/// @brief Applies a binary request to the garage
+/// @param g Pointer to Garage
+/// @param req Request
+/// @param resp Response to fill
+void binproto_handle(Garage *g, const BinRequest *req, BinResponse *resp);
+
+/// @brief Connects to a gate controller server
+/// @param socket_path Path of the server socket
+/// @return Connected socket, or -1 on failure
+int binclient_connect(const char *socket_path);
+
+/// @brief Sends a batch of pipelined requests with a single write
+/// @param fd Connected socket
+/// @param reqs Requests
+/// @param n Number of requests
+/// @return 0 on success, -1 on failure
+int binclient_send(int fd, const BinRequest *reqs, int n);
+
+/// @brief Receives exactly n responses
+/// @param fd Connected socket
+/// @param resps Output responses
+/// @param n Number of responses to wait for
+/// @return 0 on success, -1 on failure or disconnect
+int binclient_recv(int fd, BinResponse *resps, int n);
+
+/// @brief Sends one request and waits for its response
+/// @param fd Connected socket
+/// @param req Request
+/// @param resp Response
+/// @return 0 on success, -1 on failure
+int binclient_call(int fd, const BinRequest *req, BinResponse *resp);
+
+#endif //BINPROTO_H
@@ -0,0 +1,33 @@
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#include <stdint.h>
+
+/// @file bloom.h
+/// @brief Counting Bloom filter over license plate hashes
+
+#define BLOOM_COUNTERS 1024 ///< Number of counters (power of two)
+#define BLOOM_HASHES 3      ///< Counters touched per plate
+
+/// @brief Counting Bloom filter; an all-zero filter is empty
+typedef struct {
+    uint8_t counters[BLOOM_COUNTERS]; ///< Saturating per-position counters
+} CountingBloom;
+
+/// @brief Adds a plate hash to the filter
+/// @param b Filter
+/// @param hash Plate hash from plate_hash()
+void bloom_add(CountingBloom *b, uint64_t hash);
+
+/// @brief Removes a plate hash previously added
+/// @param b Filter
+/// @param hash Plate hash from plate_hash()
+void bloom_remove(CountingBloom *b, uint64_t hash);
+
+/// @brief Tests whether a plate hash may be in the filter
+/// @param b Filter
+/// @param hash Plate hash from plate_hash()
+/// @return 0 if definitely absent, 1 if possibly present
+int bloom_maybe_contains(const CountingBloom *b, uint64_t hash);
+
+#endif //BLOOM_H
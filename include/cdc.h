@@ -0,0 +1,82 @@
+#ifndef CDC_H
+#define CDC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "structs.h"
+
+/// @file cdc.h
+/// @brief Change-data-capture ring of garage mutations
+///
+/// With a ring attached (garage_set_changes()), every entry, exit and
+/// correction the garage accepts is published as a compact CdcRecord with a
+/// sequence number. Any number of subscribers read the ring through their
+/// own CdcCursor, on any thread, at their own pace. The garage never waits
+/// for them: once the ring wraps, the oldest records are overwritten, and a
+/// subscriber that fell that far behind skips ahead and is told how many
+/// records it lost.
+
+/// @brief One garage mutation (40 bytes)
+typedef struct {
+    uint64_t seq;           ///< Sequence number, starting at 1
+    uint8_t op;             ///< EventType of the mutation
+    uint8_t vehicle_class;  ///< VehicleClass of the vehicle
+    int16_t slot;           ///< Record slot in the garage
+    int16_t before;         ///< Corrections: minute of the day before the change; -1 otherwise
+    int16_t after;          ///< Minute of the day of the entry, exit or corrected time
+    int32_t fee;            ///< Fee booked by an exit, fee change made by a correction, 0 otherwise
+    char license_plate[20]; ///< License plate
+} CdcRecord;
+
+_Static_assert(sizeof(CdcRecord) == 40, "CdcRecord layout changed");
+
+/// @brief Opaque ring state
+typedef struct CdcRing CdcRing;
+
+/// @brief Where a new cursor starts reading
+typedef enum {
+    CDC_FROM_OLDEST, ///< Oldest record still in the ring
+    CDC_FROM_NOW     ///< Next record published
+} CdcStart;
+
+/// @brief A subscriber's read position (owned by the subscriber, one thread at a time)
+typedef struct {
+    const CdcRing *ring; ///< Ring being read
+    uint64_t next;       ///< Sequence number of the next record to read
+    uint64_t lost;       ///< Records overwritten before this subscriber read them
+} CdcCursor;
+
+/// @brief Creates a ring
+/// @param capacity Records kept (rounded up to a power of two)
+/// @return Ring, or NULL on failure
+CdcRing *cdc_ring_create(size_t capacity);
+
+/// @brief Frees a ring (no cursor may be used afterwards)
+/// @param r Ring (may be NULL)
+void cdc_ring_destroy(CdcRing *r);
+
+/// @brief Publishes a record, overwriting the oldest one if the ring is full (single producer)
+/// @param r Ring
+/// @param rec Record to publish; its seq field is assigned by the ring
+/// @return Sequence number given to the record
+uint64_t cdc_ring_publish(CdcRing *r, const CdcRecord *rec);
+
+/// @brief Sequence number of the newest published record (0 if none)
+/// @param r Ring
+/// @return Newest sequence number
+uint64_t cdc_ring_head(const CdcRing *r);
+
+/// @brief Positions a cursor on a ring
+/// @param c Cursor
+/// @param r Ring
+/// @param start Where to start reading
+void cdc_cursor_init(CdcCursor *c, const CdcRing *r, CdcStart start);
+
+/// @brief Reads the next records in sequence order
+/// @param c Cursor
+/// @param out Receives up to max records
+/// @param max Capacity of out
+/// @return Number of records read (0 if the cursor is up to date)
+int cdc_cursor_poll(CdcCursor *c, CdcRecord *out, int max);
+
+#endif //CDC_H
@@ -0,0 +1,44 @@
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+#include <stdint.h>
+#include "structs.h"
+
+/// @file debounce.h
+/// @brief Coalesces repeated camera reads of the same plate
+///
+/// A plate camera reports the same vehicle several times while it passes a
+/// gate. The debouncer remembers recently seen (plate, event type) pairs in
+/// two time buckets of one window each and passes only the first read.
+
+#define DEBOUNCE_BUCKETS 256 ///< Reads remembered per time bucket (power of two)
+
+/// @brief One remembered read; hash == 0 marks an empty entry
+typedef struct {
+    uint64_t hash;    ///< Plate hash mixed with the event type
+    uint64_t seen_ms; ///< Time of the latest read
+} DebounceEntry;
+
+/// @brief Debouncer state
+typedef struct {
+    uint32_t window_ms;                          ///< Reads closer together than this are coalesced
+    uint64_t bucket_start_ms;                    ///< Start of the current bucket
+    int current;                                 ///< Index of the current bucket in buckets
+    DebounceEntry buckets[2][DEBOUNCE_BUCKETS];  ///< Current and previous bucket
+    uint64_t passed;                             ///< Reads passed on
+    uint64_t suppressed;                         ///< Reads dropped as repeats
+} Debouncer;
+
+/// @brief Initializes a debouncer
+/// @param d Debouncer
+/// @param window_ms Coalescing window in milliseconds (0 passes every read)
+void debouncer_init(Debouncer *d, uint32_t window_ms);
+
+/// @brief Decides whether a read should reach the garage
+/// @param d Debouncer
+/// @param ev Gate event built from the read
+/// @param now_ms Monotonic time of the read in milliseconds
+/// @return 1 if the event should be applied, 0 if it repeats a recent read
+int debouncer_accept(Debouncer *d, const GateEvent *ev, uint64_t now_ms);
+
+#endif //DEBOUNCE_H
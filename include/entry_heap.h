@@ -0,0 +1,50 @@
+#ifndef ENTRY_HEAP_H
+#define ENTRY_HEAP_H
+
+#include <stdint.h>
+
+/// @file entry_heap.h
+/// @brief Indexed min-heap of record slots ordered by entry minute
+
+#define ENTRY_HEAP_CAPACITY 256 ///< Slots the heap can hold (>= GARAGE_CAPACITY)
+
+/// @brief Heap element
+typedef struct {
+    int16_t key;  ///< Entry time in minutes since midnight
+    int16_t slot; ///< Record slot
+} EntryHeapNode;
+
+/// @brief Indexed min-heap; an all-zero heap is empty
+typedef struct {
+    EntryHeapNode nodes[ENTRY_HEAP_CAPACITY]; ///< Heap array, earliest entry at index 0
+    int16_t pos_plus_one[ENTRY_HEAP_CAPACITY]; ///< Heap index + 1 of each slot, 0 if absent
+    int size;                                  ///< Number of slots in the heap
+} EntryHeap;
+
+/// @brief Adds a slot (or moves it if already present)
+/// @param h Heap
+/// @param slot Record slot
+/// @param key Entry minute
+void entry_heap_set(EntryHeap *h, int slot, int key);
+
+/// @brief Removes a slot if present
+/// @param h Heap
+/// @param slot Record slot
+void entry_heap_remove(EntryHeap *h, int slot);
+
+/// @brief Lists the k slots with the earliest entries, earliest first
+/// @param h Heap
+/// @param k Number of slots wanted
+/// @param out Receives up to k slots
+/// @return Number of slots written
+int entry_heap_oldest(const EntryHeap *h, int k, int *out);
+
+/// @brief Lists every slot whose entry is before a minute (in heap order)
+/// @param h Heap
+/// @param key Exclusive upper bound on the entry minute
+/// @param out Receives the slots
+/// @param max Capacity of out
+/// @return Number of slots written
+int entry_heap_before(const EntryHeap *h, int key, int *out, int max);
+
+#endif //ENTRY_HEAP_H
@@ -4,6 +4,8 @@
 #ifndef FUNCTIONS_H
 #define FUNCTIONS_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include "structs.h"
 
 /// @file functions.h
@@ -11,13 +13,44 @@
 
 /// @brief Parses a time string in HH:MM format into a Time struct
 /// @param str Time string
-/// @return Parsed Time
+/// @return Parsed Time, or {-1, -1} if the string is not a valid time (see time_valid())
 Time parse_time(const char *str);
 
+/// @brief Checks that a time lies within a day (00:00-23:59)
+/// @param t Time
+/// @return 1 if valid, 0 otherwise
+int time_valid(Time t);
+
 /// @brief Calculates the duration between two times (rounded up to full hours)
 /// @param entry Entry time
 /// @param exit Exit time
 /// @return Duration in hours
 int calculate_duration(Time entry, Time exit);
 
+/// @brief Converts a time to minutes since midnight
+/// @param t Time
+/// @return Minutes since midnight (0-1439)
+int time_to_minutes(Time t);
+
+/// @brief Hashes a license plate (64-bit FNV-1a)
+/// @param plate License plate
+/// @return Hash value
+uint64_t plate_hash(const char *plate);
+
+/// @brief Formats an amount of cents as euros and cents ("12.50", "-2.00")
+/// @param cents Amount in cents
+/// @param buf Output buffer
+/// @param size Size of buf
+void format_cents(int64_t cents, char *buf, size_t size);
+
+/// @brief Returns the short name of a vehicle class ("EV", "DISABLED", ...)
+/// @param cls Vehicle class
+/// @return Class name, "?" for invalid values
+const char *vehicle_class_name(VehicleClass cls);
+
+/// @brief Parses a vehicle class name (case-sensitive, as returned by vehicle_class_name())
+/// @param name Class name
+/// @return Vehicle class, or -1 if unknown
+int parse_vehicle_class(const char *name);
+
 #endif //FUNCTIONS_Hf //PARKINGGARAGESYSTEM_FUNCTIONS_H
\ No newline at end of file
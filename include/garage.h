@@ -4,6 +4,7 @@
 #ifndef GARAGE_H
 #define GARAGE_H
 
+#include <stddef.h>
 #include "structs.h"
 
 /// @file garage.h
@@ -13,18 +14,64 @@
 /// @param g Pointer to Garage
 void init_garage(Garage *g);
 
+/// @brief Frees the stays archived when record slots were recycled
+/// @param g Pointer to Garage; it can be initialized again afterwards
+void free_garage(Garage *g);
+
 /// @brief Registers a vehicle entering the garage
 /// @param g Pointer to Garage
 /// @param plate License plate
 /// @param time Entry time
-/// @return 0 if success, -1 if garage is full
+/// @return 0 if success, -1 if the time is invalid or the garage is full, -2 if the plate is already inside and duplicates are rejected
 int register_entry(Garage *g, const char *plate, Time time);
 
+/// @brief Registers a vehicle entering the garage and issues a ticket
+/// @param g Pointer to Garage
+/// @param plate License plate
+/// @param time Entry time
+/// @param ticket Receives the ticket handle (may be NULL)
+/// @return 0 if success, -1 if the time is invalid or the garage is full, -2 if the plate is already inside and duplicates are rejected
+int register_entry_ticket(Garage *g, const char *plate, Time time, Ticket *ticket);
+
+/// @brief Registers a vehicle of a given class and issues a ticket
+/// @param g Pointer to Garage
+/// @param plate License plate
+/// @param time Entry time
+/// @param cls Vehicle class; admitted against its reserved spots or the general pool
+/// @param ticket Receives the ticket handle (may be NULL)
+/// @return 0 if success, -1 if the time is invalid or the garage or the class's spots are full,
+///         -2 if the plate is already inside and duplicates are rejected
+int register_entry_class(Garage *g, const char *plate, Time time, VehicleClass cls, Ticket *ticket);
+
+/// @brief Reserves spots for a vehicle class
+/// @param g Pointer to Garage
+/// @param cls Vehicle class (not CLASS_STANDARD, which always uses the general pool)
+/// @param spots Reserved spots, 0 to let the class use the general pool
+/// @return 0 on success, -1 if the class is invalid or the reservations exceed the capacity
+int set_class_quota(Garage *g, VehicleClass cls, int spots);
+
+/// @brief Number of vehicles of a class inside (safe to call from any thread)
+/// @param g Pointer to Garage
+/// @param cls Vehicle class
+/// @return Vehicles of the class inside
+int class_occupancy(const Garage *g, VehicleClass cls);
+
+/// @brief Free spots available to a class: its reserved spots, or the general pool
+/// @param g Pointer to Garage
+/// @param cls Vehicle class
+/// @return Free spots
+int class_free_spots(const Garage *g, VehicleClass cls);
+
+/// @brief Chooses how entries for plates already inside are handled
+/// @param g Pointer to Garage
+/// @param policy Duplicate policy
+void set_duplicate_policy(Garage *g, DuplicatePolicy policy);
+
 /// @brief Logs the exit of a vehicle and calculates the fee
 /// @param g Pointer to Garage
 /// @param plate License plate
 /// @param time Exit time
-/// @return Fee if success, -1 if vehicle not found or already exited
+/// @return Fee if success, -1 if the time is invalid or the vehicle is not found or already exited
 int log_exit(Garage *g, const char *plate, Time time);
 
 /// @brief Prints the current occupancy
@@ -39,14 +86,191 @@ void list_unexited(const Garage *g);
 /// @param g Pointer to Garage
 /// @param plate License plate to search for
 /// @param new_time New entry time
-/// @return 0 if success, -1 if vehicle not found
+/// @return 0 if success, -1 if the time is invalid, the vehicle is not found or the entry would come after the exit
 int update_entry_time(Garage *g, const char *plate, Time new_time);
 
 /// @brief Update the exit time of a vehicle
 /// @param g Pointer to Garage
 /// @param plate License plate to search for
 /// @param new_time New exit time
-/// @return 0 if success, -1 if vehicle not found or not yet exited
+/// @return 0 if success, -1 if the time is invalid, the vehicle is not found or not yet exited,
+///         or the exit would come before the entry
 int update_exit_time(Garage *g, const char *plate, Time new_time);
 
+/// @brief Fee for a stay: 2 euros per started hour (exits earlier than the entry ran past midnight)
+/// @param entry Entry time
+/// @param exit Exit time
+/// @return Fee in euros, never negative
+int calculate_fee(Time entry, Time exit);
+
+/// @brief Copies the correction journal, oldest first
+/// @param g Pointer to Garage
+/// @param out Receives up to max corrections
+/// @param max Capacity of out
+/// @return Number of corrections copied (at most CORRECTION_JOURNAL_CAPACITY are kept)
+int garage_corrections(const Garage *g, Correction *out, int max);
+
+/// @brief Breaks the day's revenue down into booked fees and correction adjustments
+/// @param g Pointer to Garage
+/// @param audit Output breakdown
+void garage_revenue_audit(const Garage *g, RevenueAudit *audit);
+
+/// @brief Revenue of the exits in a range of hours, from the hourly buckets
+/// @param g Pointer to Garage
+/// @param from_hour First hour (0-23)
+/// @param to_hour Hour after the last one (1-24)
+/// @return Revenue in cents
+int64_t garage_revenue_between(const Garage *g, int from_hour, int to_hour);
+
+/// @brief Initializes a filter selecting vehicles by state only
+/// @param filter Filter to initialize
+/// @param state Vehicles to select
+void vehicle_filter_init(VehicleFilter *filter, VehicleState state);
+
+/// @brief Starts iterating over the vehicles matching a filter
+/// @param it Iterator to initialize
+/// @param g Pointer to Garage
+/// @param filter Selection criteria, or NULL for all vehicles
+void vehicle_iter_init(VehicleIterator *it, const Garage *g, const VehicleFilter *filter);
+
+/// @brief Returns the next matching vehicle, archived stays first
+/// @param it Iterator
+/// @return Pointer into the garage's records or archive, or NULL when done
+const Vehicle *vehicle_iter_next(VehicleIterator *it);
+
+/// @brief Callback for garage_for_each()
+/// @param v Matching vehicle (points into the garage, not a copy)
+/// @param ctx Caller context
+/// @return 0 to continue, non-zero to stop iterating
+typedef int (*VehicleVisitor)(const Vehicle *v, void *ctx);
+
+/// @brief Calls a visitor for every vehicle matching a filter, archived stays first, then in record order
+/// @param g Pointer to Garage
+/// @param filter Selection criteria, or NULL for all vehicles
+/// @param visit Visitor callback
+/// @param ctx Context passed to the visitor
+/// @return Number of vehicles visited
+int garage_for_each(const Garage *g, const VehicleFilter *filter, VehicleVisitor visit, void *ctx);
+
+/// @brief Logs an exit using the ticket issued on entry, in constant time
+/// @param g Pointer to Garage
+/// @param ticket Ticket handle
+/// @param time Exit time
+/// @return Fee if success, -1 if the time or the ticket is invalid, or the ticket is stale or already used
+int log_exit_by_ticket(Garage *g, Ticket ticket, Time time);
+
+/// @brief Update the entry time of the vehicle holding a ticket
+/// @param g Pointer to Garage
+/// @param ticket Ticket handle
+/// @param new_time New entry time
+/// @return 0 if success, -1 if the time or the ticket is invalid, the ticket is stale,
+///         or the entry would come after the exit
+int update_entry_time_by_ticket(Garage *g, Ticket ticket, Time new_time);
+
+/// @brief Update the exit time of the vehicle holding a ticket
+/// @param g Pointer to Garage
+/// @param ticket Ticket handle
+/// @param new_time New exit time
+/// @return 0 if success, -1 if the time or the ticket is invalid, the ticket is stale or not yet exited,
+///         or the exit would come before the entry
+int update_exit_time_by_ticket(Garage *g, Ticket ticket, Time new_time);
+
+/// @brief Looks up the vehicle holding a ticket
+/// @param g Pointer to Garage
+/// @param ticket Ticket handle
+/// @return Vehicle record, or NULL if the ticket is invalid or stale
+const Vehicle *find_vehicle_by_ticket(const Garage *g, Ticket ticket);
+
+/// @brief Formats a ticket as a 10-digit ticket number (for printing or barcodes)
+/// @param ticket Ticket handle
+/// @param buf Output buffer (at least 11 bytes)
+/// @param size Size of buf
+void format_ticket(Ticket ticket, char *buf, size_t size);
+
+/// @brief Parses a ticket number printed by format_ticket()
+/// @param str Ticket number
+/// @return Ticket handle, or TICKET_INVALID if malformed
+Ticket parse_ticket(const char *str);
+
+/// @brief Reports lookup statistics, including the Bloom filter false-positive rate
+/// @param g Pointer to Garage
+/// @param stats Output statistics
+void get_garage_stats(const Garage *g, GarageStats *stats);
+
+/// @brief Returns the number of vehicles currently inside the garage
+/// @param g Pointer to Garage
+/// @return Number of vehicles that have not exited
+int current_occupancy(const Garage *g);
+
+/// @brief Lists the vehicles that have been inside the longest
+/// @param g Pointer to Garage
+/// @param k Number of vehicles wanted
+/// @param out Receives up to k vehicles, earliest entry first
+/// @return Number of vehicles written
+int garage_longest_parked(const Garage *g, int k, const Vehicle **out);
+
+/// @brief Lists the vehicles still inside that entered before a time
+/// @param g Pointer to Garage
+/// @param t Exclusive upper bound on the entry time
+/// @param out Receives the vehicles (not sorted)
+/// @param max Capacity of out
+/// @return Number of vehicles written
+int garage_active_entered_before(const Garage *g, Time t, const Vehicle **out, int max);
+
+/// @brief Lists the recorded vehicles that were inside at a time
+/// @param g Pointer to Garage
+/// @param t Time; a vehicle is inside from its entry until (excluding) its exit
+/// @param out Receives the vehicles, archived stays first
+/// @param max Capacity of out
+/// @return Number of vehicles written
+int garage_inside_at(const Garage *g, Time t, const Vehicle **out, int max);
+
+/// @brief Lists the recorded vehicles that were inside at any time in a range
+/// @param g Pointer to Garage
+/// @param from Start of the range
+/// @param to End of the range (inclusive)
+/// @param out Receives the vehicles, archived stays first
+/// @param max Capacity of out
+/// @return Number of vehicles written
+int garage_inside_between(const Garage *g, Time from, Time to, const Vehicle **out, int max);
+
+/// @brief Computes the per-minute occupancy of the day
+/// @param g Pointer to Garage
+/// @param curve Receives MINUTES_PER_DAY values, vehicles inside during each minute
+/// @param peak Receives the peak (may be NULL)
+void garage_occupancy_curve(const Garage *g, int *curve, OccupancyPeak *peak);
+
+/// @brief Attaches an alert wheel; vehicles already inside are armed at once
+/// @param g Pointer to Garage
+/// @param w Wheel initialized with alert_wheel_init(), or NULL to detach
+void garage_set_alerts(Garage *g, struct AlertWheel *w);
+
+/// @brief Attaches a bay map; entries then get the nearest free bay and exits free it
+/// @param g Pointer to Garage
+/// @param m Bay map created with bay_map_create(), or NULL to detach.
+///          Vehicles already inside are assigned bays at once, and the
+///          bays they held in the previous map are freed.
+void garage_set_bays(Garage *g, struct BayMap *m);
+
+/// @brief Attaches a replicator; every accepted entry, exit and correction is then shipped to the standby
+/// @param g Pointer to Garage
+/// @param r Replicator created with replicator_create(), or NULL to detach
+void garage_set_replicator(Garage *g, struct Replicator *r);
+
+/// @brief Attaches a change-data-capture ring; every accepted entry, exit and correction is published to it
+/// @param g Pointer to Garage
+/// @param r Ring created with cdc_ring_create(), or NULL to detach
+void garage_set_changes(Garage *g, struct CdcRing *r);
+
+/// @brief Advances the alert clock without a gate event
+/// @param g Pointer to Garage
+/// @param now Current time
+void garage_advance_clock(Garage *g, Time now);
+
+/// @brief Applies a gate event to the garage
+/// @param g Pointer to Garage
+/// @param ev Event to apply
+/// @return Result of the underlying garage call (fee for exits, 0/-1 otherwise)
+int apply_gate_event(Garage *g, const GateEvent *ev);
+
 #endif //GARAGE_HARAGESYSTEM_GARAGE_H
\ No newline at end of file
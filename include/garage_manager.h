@@ -0,0 +1,93 @@
+#ifndef GARAGE_MANAGER_H
+#define GARAGE_MANAGER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "structs.h"
+
+/// @file garage_manager.h
+/// @brief Many garages in one process, sharded across pinned worker threads
+///
+/// Garage i is owned by worker i % workers and is only ever touched from
+/// that worker's thread, so garages need no locks and never share state.
+/// Every producer thread (a server, a gate, a log replayer) gets its own SPSC
+/// ring to each worker and routes an event by garage id. Each worker
+/// republishes its garages' counters in atomics after every event, so the
+/// totals across all garages can be read from any thread without stopping
+/// or locking a shard.
+
+/// @brief Opaque manager state
+typedef struct GarageManager GarageManager;
+
+/// @brief Called on the owning worker thread after each event has been applied
+typedef void (*ManagerResultHandler)(void *ctx, int garage, const GateEvent *ev, int result);
+
+/// @brief Totals across all garages (each garage's counters are consistent, the sum is not a snapshot)
+typedef struct {
+    int garages;        ///< Number of garages
+    int inside;         ///< Vehicles currently inside
+    int served;         ///< Vehicles served today
+    int64_t revenue_cents; ///< Revenue collected today, in cents
+    uint64_t applied;   ///< Events applied by the workers
+    uint64_t ring_full; ///< Submissions rejected because a ring was full
+} ManagerTotals;
+
+/// @brief Creates the garages and one ring per producer and worker
+/// @param garages Number of garages (ids 0 .. garages-1)
+/// @param workers Number of worker threads (capped at the number of garages)
+/// @param producers Number of producer threads that will submit events
+/// @param ring_capacity Events per ring (rounded up to a power of two)
+/// @return Manager handle, or NULL on failure
+GarageManager *garage_manager_create(int garages, int workers, int producers, size_t ring_capacity);
+
+/// @brief Returns a garage for setup or inspection
+/// @param m Manager (must not be running; the worker owns the garage while it runs)
+/// @param id Garage id
+/// @return Garage, or NULL if the id is invalid
+Garage *garage_manager_garage(GarageManager *m, int id);
+
+/// @brief Returns the worker that owns a garage
+/// @param m Manager
+/// @param id Garage id
+/// @return Worker index, or -1 if the id is invalid
+int garage_manager_worker_of(const GarageManager *m, int id);
+
+/// @brief Installs a handler receiving the result of every applied event
+/// @param m Manager (must not be running)
+/// @param handler Result handler, or NULL
+/// @param ctx Context passed to the handler (called from several workers at once)
+void garage_manager_set_result_handler(GarageManager *m, ManagerResultHandler handler, void *ctx);
+
+/// @brief Starts the workers, pinning worker w to CPU w modulo the online CPUs
+/// @param m Manager
+/// @return 0 on success, -1 on failure
+int garage_manager_start(GarageManager *m);
+
+/// @brief Routes an event to the worker owning a garage, without blocking
+/// @param m Manager
+/// @param producer Producer index; each producer must be used by exactly one thread
+/// @param garage Garage id
+/// @param ev Event to apply
+/// @return 0 on success, -1 if an index is invalid or the ring is full
+int garage_manager_submit(GarageManager *m, int producer, int garage, const GateEvent *ev);
+
+/// @brief Vehicles inside one garage (safe to call from any thread)
+/// @param m Manager
+/// @param id Garage id
+/// @return Vehicles inside, or -1 if the id is invalid
+int garage_manager_occupancy(const GarageManager *m, int id);
+
+/// @brief Sums the counters of all garages (safe to call from any thread)
+/// @param m Manager
+/// @param totals Output totals
+void garage_manager_totals(const GarageManager *m, ManagerTotals *totals);
+
+/// @brief Stops the workers after draining all rings
+/// @param m Manager
+void garage_manager_stop(GarageManager *m);
+
+/// @brief Frees the manager and its garages (stops it first if still running)
+/// @param m Manager (may be NULL)
+void garage_manager_destroy(GarageManager *m);
+
+#endif //GARAGE_MANAGER_H
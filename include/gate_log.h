@@ -0,0 +1,60 @@
+#ifndef GATE_LOG_H
+#define GATE_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "structs.h"
+
+/// @file gate_log.h
+/// @brief Per-gate event log lines and a streaming k-way merge of gate logs
+///
+/// Every gate writes its own log with one event per line in the text
+/// protocol command format (e.g. "ENTRY B-AB123 08:15"), in time order.
+/// gate_log_merge() reads N such logs sequentially, each through a large
+/// fixed buffer, and emits the union in time order using a loser tree, so
+/// memory stays bounded regardless of log length.
+
+#define GATE_LOG_READ_BUFFER (256 * 1024) ///< stdio buffer per open log
+
+/// @brief Receives each merged event
+typedef void (*GateEventSink)(void *ctx, int source, const GateEvent *ev);
+
+/// @brief Merge counters
+typedef struct {
+    uint64_t events;    ///< Events emitted
+    uint64_t malformed; ///< Lines skipped because they could not be parsed
+    uint64_t unsorted;  ///< Events earlier than the previous one of the same log
+    uint64_t rejected;  ///< Events the garage rejected (gate_log_replay() only)
+} GateLogStats;
+
+/// @brief Parses one event line ("<ENTRY|EXIT|CORRECT_ENTRY|CORRECT_EXIT> <plate> <HH:MM> [class]")
+/// @param line Line without or with trailing newline
+/// @param ev Output event
+/// @return 0 on success, -1 if the line is malformed
+int gate_event_parse(const char *line, GateEvent *ev);
+
+/// @brief Formats an event as a log line including the newline
+/// @param ev Event
+/// @param out Output buffer
+/// @param size Size of the output buffer
+/// @return Length written (as snprintf)
+int gate_event_format(const GateEvent *ev, char *out, size_t size);
+
+/// @brief Merges time-ordered gate logs into one time-ordered stream
+/// @param paths Log file paths
+/// @param n Number of logs
+/// @param sink Called once per event, in time order (ties in log order)
+/// @param ctx Context passed to the sink
+/// @param stats Output counters (may be NULL)
+/// @return 0 on success, -1 if a log could not be opened
+int gate_log_merge(const char *const *paths, int n, GateEventSink sink, void *ctx, GateLogStats *stats);
+
+/// @brief Merges gate logs and applies the stream to the garage
+/// @param g Pointer to Garage
+/// @param paths Log file paths
+/// @param n Number of logs
+/// @param stats Output counters (may be NULL)
+/// @return 0 on success, -1 if a log could not be opened
+int gate_log_replay(Garage *g, const char *const *paths, int n, GateLogStats *stats);
+
+#endif //GATE_LOG_H
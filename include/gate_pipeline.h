@@ -0,0 +1,87 @@
+#ifndef GATE_PIPELINE_H
+#define GATE_PIPELINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "structs.h"
+
+/// @file gate_pipeline.h
+/// @brief Per-gate event rings drained by a single garage core thread
+///
+/// Every gate thread owns one SPSC ring and publishes its events there
+/// without ever blocking. One core thread drains all rings in batches and is
+/// the only thread that touches the Garage. Repeated camera reads can be
+/// debounced on the gate side so they never reach the rings, and the core can
+/// put events from all gates back into event-time order before applying them.
+
+/// @brief Opaque pipeline state
+typedef struct GatePipeline GatePipeline;
+
+/// @brief Called on the core thread after each event has been applied
+typedef void (*GateResultHandler)(void *ctx, int gate, const GateEvent *ev, int result);
+
+/// @brief Pipeline counters
+typedef struct {
+    uint64_t submitted;        ///< Events accepted into a ring
+    uint64_t ring_full;        ///< Submissions rejected because the ring was full
+    uint64_t debounced;        ///< Submissions dropped as repeated reads
+    uint64_t applied;          ///< Events taken from the rings by the core
+    uint64_t late;             ///< Events that arrived too late to be reordered
+    uint64_t dropped;          ///< Reordered events the garage rejected
+    uint64_t batches;          ///< Non-empty drain rounds of the core thread
+    uint64_t total_latency_ns; ///< Sum of submit-to-apply latencies
+    uint64_t max_latency_ns;   ///< Worst submit-to-apply latency
+} GatePipelineStats;
+
+/// @brief Creates a pipeline with one ring per gate
+/// @param g Pointer to Garage owned by the core thread while running
+/// @param gates Number of gates (one producer thread each)
+/// @param ring_capacity Events per ring (rounded up to a power of two)
+/// @return Pipeline handle, or NULL on failure
+GatePipeline *gate_pipeline_create(Garage *g, int gates, size_t ring_capacity);
+
+/// @brief Installs a handler receiving the result of every applied event
+/// @param p Pipeline (must not be running)
+/// @param handler Result handler, or NULL
+/// @param ctx Context passed to the handler
+void gate_pipeline_set_result_handler(GatePipeline *p, GateResultHandler handler, void *ctx);
+
+/// @brief Enables debouncing of repeated reads on every gate
+/// @param p Pipeline (must not be running)
+/// @param window_ms Reads of the same plate and event type closer together
+///                  than this are submitted only once (0 disables debouncing)
+void gate_pipeline_set_debounce(GatePipeline *p, uint32_t window_ms);
+
+/// @brief Applies events in event-time order through a reorder buffer
+/// @param p Pipeline (must not be running)
+/// @param lateness_minutes Allowed lateness (see reorder.h); negative disables reordering
+/// @return 0 on success, -1 on allocation failure
+int gate_pipeline_set_reorder(GatePipeline *p, int lateness_minutes);
+
+/// @brief Starts the core thread
+/// @param p Pipeline
+/// @return 0 on success, -1 on failure
+int gate_pipeline_start(GatePipeline *p);
+
+/// @brief Publishes an event from a gate thread without blocking
+/// @param p Pipeline
+/// @param gate Gate index; each gate must be used by exactly one thread
+/// @param ev Event to publish
+/// @return 0 on success, 1 if the event was dropped as a repeated read,
+///         -1 if the gate's ring is full
+int gate_pipeline_submit(GatePipeline *p, int gate, const GateEvent *ev);
+
+/// @brief Stops the core thread after draining all rings and the reorder buffer
+/// @param p Pipeline
+void gate_pipeline_stop(GatePipeline *p);
+
+/// @brief Copies the pipeline counters
+/// @param p Pipeline
+/// @param stats Output counters
+void gate_pipeline_get_stats(GatePipeline *p, GatePipelineStats *stats);
+
+/// @brief Frees the pipeline (stops it first if still running)
+/// @param p Pipeline
+void gate_pipeline_destroy(GatePipeline *p);
+
+#endif //GATE_PIPELINE_H
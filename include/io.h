@@ -4,14 +4,54 @@
 #ifndef IO_H
 #define IO_H
 
+#include <stdint.h>
 #include "structs.h"
 
 /// @file io.h
 /// @brief Contains file input/output functions
 
+/// @brief Magic bytes opening a stays export
+#define STAYS_MAGIC "PGSTAYS1"
+
+/// @brief Columns of a stays export start at multiples of this many bytes
+#define STAYS_ALIGNMENT 64
+
+/// @brief Header of a columnar stays export (64 bytes, little-endian as written by x86/ARM hosts)
+///
+/// Every column starts at the given file offset, aligned to STAYS_ALIGNMENT,
+/// and holds one value per row in record order. Plates use the Arrow string
+/// layout: rows + 1 offsets into the concatenated plate bytes. A tool can
+/// map the file and view each column as a typed array without parsing.
+typedef struct {
+    char magic[8];          ///< STAYS_MAGIC (not NUL-terminated)
+    uint32_t rows;          ///< Vehicles exported
+    uint32_t plate_bytes;   ///< Size of the plate data column
+    uint64_t plate_offsets; ///< uint32[rows + 1]: start of each plate in the plate data
+    uint64_t plate_data;    ///< char[plate_bytes]: plates, concatenated without terminators
+    uint64_t entry_minute;  ///< int16[rows]: entry time as minute of the day
+    uint64_t exit_minute;   ///< int16[rows]: exit time as minute of the day, -1 while inside
+    uint64_t fee_cents;     ///< int32[rows]: fee booked on exit, in cents (0 while inside)
+    uint64_t vehicle_class; ///< uint8[rows]: VehicleClass
+} StaysHeader;
+
+_Static_assert(sizeof(StaysHeader) == 64, "StaysHeader layout changed");
+
 /// @brief Writes the end-of-day report to a file
 /// @param g Pointer to Garage
 /// @param filename Name of the output file
-void write_report(const Garage *g, const char *filename);
+/// @return 0 on success, -1 if the file could not be written
+int write_report(const Garage *g, const char *filename);
+
+/// @brief Writes the per-minute occupancy curve of the day as CSV
+/// @param g Pointer to Garage
+/// @param filename Name of the output file
+/// @return 0 on success, -1 if the file could not be written
+int write_occupancy_csv(const Garage *g, const char *filename);
+
+/// @brief Exports the day's vehicles as a columnar binary file (see StaysHeader)
+/// @param g Pointer to Garage
+/// @param filename Name of the output file
+/// @return 0 on success, -1 if the file could not be written
+int write_stays_columnar(const Garage *g, const char *filename);
 
 #endif //IO_HKINGGARAGESYSTEM_IO_H
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef OCCUPANCY_FEED_H
+#define OCCUPANCY_FEED_H
+
+#include <stdint.h>
+#include "structs.h"
+
+/// @file occupancy_feed.h
+/// @brief Live occupancy published in POSIX shared memory for signs and dashboards
+///
+/// The garage process is the only writer. Readers map the same segment
+/// read-only and copy a consistent snapshot without any system call; a
+/// sequence lock tells them to retry if they raced with an update.
+
+#define FEED_MAX_ZONES 8
+
+/// @brief Occupancy data published to readers
+typedef struct {
+    int capacity;                  ///< Total number of spots
+    int occupied;                  ///< Vehicles currently inside
+    int free_spots;                ///< Spots left
+    int total_served;              ///< Vehicles served today
+    int64_t revenue_cents;         ///< Revenue collected today, in cents
+    int zone_count;                ///< Number of valid entries in zone_free
+    int zone_free[FEED_MAX_ZONES]; ///< Free spots per zone (per parking level when bays are tracked)
+    int class_free[VEHICLE_CLASS_COUNT]; ///< Free spots available to each vehicle class
+    uint64_t updates;              ///< Number of publishes since the feed was created
+} OccupancySnapshot;
+
+/// @brief Opaque handle to a mapped feed segment
+typedef struct OccupancyFeed OccupancyFeed;
+
+/// @brief Creates (or replaces) a feed segment for writing
+/// @param name Shared memory object name, e.g. "/garage_feed"
+/// @return Feed handle, or NULL on failure
+OccupancyFeed *occupancy_feed_create(const char *name);
+
+/// @brief Publishes the current garage state
+/// @param f Feed created with occupancy_feed_create()
+/// @param g Pointer to Garage
+void occupancy_feed_publish(OccupancyFeed *f, const Garage *g);
+
+/// @brief Opens an existing feed segment for reading
+/// @param name Shared memory object name
+/// @return Feed handle, or NULL if the segment does not exist or was written with another layout
+OccupancyFeed *occupancy_feed_open(const char *name);
+
+/// @brief Copies a consistent snapshot from the feed
+/// @param f Feed handle
+/// @param out Output snapshot
+void occupancy_feed_read(const OccupancyFeed *f, OccupancySnapshot *out);
+
+/// @brief Unmaps the feed; the writer also removes the segment name
+/// @param f Feed handle (may be NULL)
+void occupancy_feed_close(OccupancyFeed *f);
+
+#endif //OCCUPANCY_FEED_H
@@ -0,0 +1,93 @@
+#ifndef PARTITIONED_GARAGE_H
+#define PARTITIONED_GARAGE_H
+
+#include <stdint.h>
+#include "structs.h"
+
+/// @file partitioned_garage.h
+/// @brief One logical garage partitioned by plate across shards
+///
+/// A consistent-hash ring with PARTITION_VNODES points per shard maps each
+/// plate hash to the shard that owns the plate's records and index. Every
+/// shard is a Garage behind its own mutex, so threads working on plates of
+/// different shards never contend. Admission checks a single atomic
+/// occupancy counter against the capacity of the whole site before the
+/// shard is locked.
+
+#define PARTITION_VNODES 64
+
+/// @brief Opaque partitioned garage
+typedef struct PartitionedGarage PartitionedGarage;
+
+/// @brief Totals across all shards
+typedef struct {
+    int shards;     ///< Number of shards
+    int capacity;   ///< Vehicles the site admits at once
+    int inside;     ///< Vehicles currently inside
+    int served;     ///< Vehicles served today
+    int64_t revenue_cents; ///< Revenue collected today, in cents
+} PartitionStats;
+
+/// @brief Creates a partitioned garage
+/// @param shards Number of shards
+/// @param capacity Vehicles admitted at once, capped at shards * GARAGE_CAPACITY.
+///                 A shard also rejects entries once all of its own records are in use.
+/// @return Handle, or NULL on failure
+PartitionedGarage *partitioned_garage_create(int shards, int capacity);
+
+/// @brief Frees a partitioned garage
+/// @param pg Handle (may be NULL)
+void partitioned_garage_destroy(PartitionedGarage *pg);
+
+/// @brief Returns the shard owning a plate
+/// @param pg Handle
+/// @param plate License plate
+/// @return Shard index
+int partitioned_garage_shard_of(const PartitionedGarage *pg, const char *plate);
+
+/// @brief Registers a vehicle entering the site (thread-safe)
+/// @param pg Handle
+/// @param plate License plate
+/// @param time Entry time
+/// @param cls Vehicle class
+/// @return 0 if success, -1 if the site or the owning shard is full,
+///         -2 if the plate is already inside
+int partitioned_garage_entry(PartitionedGarage *pg, const char *plate, Time time, VehicleClass cls);
+
+/// @brief Logs the exit of a vehicle (thread-safe)
+/// @param pg Handle
+/// @param plate License plate
+/// @param time Exit time
+/// @return Fee if success, -1 if the vehicle is not inside
+int partitioned_garage_exit(PartitionedGarage *pg, const char *plate, Time time);
+
+/// @brief Copies the record of a vehicle that is inside (thread-safe)
+/// @param pg Handle
+/// @param plate License plate
+/// @param out Receives the record
+/// @return 0 if found, -1 if the plate is not inside
+int partitioned_garage_find(PartitionedGarage *pg, const char *plate, Vehicle *out);
+
+/// @brief Vehicles currently inside (lock-free)
+/// @param pg Handle
+/// @return Vehicles inside
+int partitioned_garage_occupancy(const PartitionedGarage *pg);
+
+/// @brief Sums the counters of all shards (locks each shard briefly)
+/// @param pg Handle
+/// @param stats Output totals
+void partitioned_garage_stats(PartitionedGarage *pg, PartitionStats *stats);
+
+/// @brief Changes the number of shards, moving the records to their new owners
+///
+/// Only the plates whose owner changes on the new ring (about
+/// |new - old| / max(new, old) of them) move to a different shard; all
+/// shards are rebuilt from their records in record order. Meant for
+/// startup: no other call may run concurrently.
+/// @param pg Handle
+/// @param shards New number of shards
+/// @param moved Receives the number of records that changed shard (may be NULL)
+/// @return 0 on success, -1 if the shards cannot hold the records (nothing changes)
+int partitioned_garage_rebalance(PartitionedGarage *pg, int shards, int *moved);
+
+#endif //PARTITIONED_GARAGE_H
@@ -0,0 +1,46 @@
+#ifndef PLATE_INDEX_H
+#define PLATE_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// @file plate_index.h
+/// @brief Open-addressing hash index from license plate to record slot
+
+#define PLATE_INDEX_SIZE 256 ///< Number of buckets (power of two, > 2x capacity)
+
+/// @brief One bucket; slot_plus_one == 0 marks an empty bucket
+typedef struct {
+    uint32_t hash;         ///< Low bits of the plate hash
+    int32_t slot_plus_one; ///< Record slot + 1
+} PlateIndexEntry;
+
+/// @brief Plate index; an all-zero index is empty
+typedef struct {
+    PlateIndexEntry entries[PLATE_INDEX_SIZE]; ///< Linear-probing buckets
+} PlateIndex;
+
+/// @brief Finds the slot indexed for a plate
+/// @param idx Index
+/// @param plates License plate of each record slot, indexed by slot
+/// @param plate_stride Distance in bytes between consecutive plates in plates
+/// @param plate Plate to look up
+/// @param hash plate_hash(plate)
+/// @return Record slot, or -1 if the plate is not indexed
+int plate_index_find(const PlateIndex *idx, const char *plates, size_t plate_stride,
+                     const char *plate, uint64_t hash);
+
+/// @brief Adds a plate's slot to the index
+/// @param idx Index
+/// @param hash plate_hash() of the plate stored in slot
+/// @param slot Record slot
+void plate_index_insert(PlateIndex *idx, uint64_t hash, int slot);
+
+/// @brief Removes a slot from the index if it is indexed
+/// @param idx Index
+/// @param hash plate_hash() of the plate stored in slot
+/// @param slot Record slot
+/// @return 1 if the slot was removed, 0 if it was not indexed
+int plate_index_remove(PlateIndex *idx, uint64_t hash, int slot);
+
+#endif //PLATE_INDEX_H
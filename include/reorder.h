@@ -0,0 +1,78 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include <stdint.h>
+#include "structs.h"
+
+/// @file reorder.h
+/// @brief Event-time reorder buffer in front of the garage
+///
+/// Buffered gate controllers may deliver an exit before the matching entry.
+/// The reorder buffer holds events in a min-heap keyed by event time and
+/// applies them only once the watermark (latest event time seen minus the
+/// allowed lateness) has passed them, so the garage sees them in time order.
+/// Event times are minutes of one day; the buffer should be flushed at the
+/// end of the day.
+
+#define REORDER_CAPACITY 256 ///< Events held at most; the earliest is released when full
+
+/// @brief Called for every event applied to the garage
+typedef void (*ReorderHandler)(void *ctx, int source, const GateEvent *ev, int result);
+
+/// @brief Buffered event
+typedef struct {
+    GateEvent ev;  ///< Event
+    int source;    ///< Caller-defined origin (e.g. gate index)
+    uint32_t seq;  ///< Arrival order, breaks ties between equal times
+} ReorderItem;
+
+/// @brief Reorder buffer counters
+typedef struct {
+    uint64_t pushed;   ///< Events handed to the buffer
+    uint64_t applied;  ///< Events applied to the garage
+    uint64_t late;     ///< Events older than the last applied one (applied immediately)
+    uint64_t dropped;  ///< Applied events the garage rejected (e.g. exit without entry)
+    uint64_t forced;   ///< Events released early because the buffer was full
+    int max_depth;     ///< Most events buffered at once
+} ReorderStats;
+
+/// @brief Reorder buffer state
+typedef struct {
+    Garage *g;                           ///< Garage events are applied to
+    int lateness;                        ///< Allowed lateness in minutes
+    int max_seen;                        ///< Latest event time seen (-1 before the first)
+    int applied_upto;                    ///< Time of the last applied event (-1 before the first)
+    uint32_t next_seq;                   ///< Next arrival number
+    int size;                            ///< Events in the heap
+    ReorderItem heap[REORDER_CAPACITY];  ///< Min-heap by (time, entries first, arrival)
+    ReorderHandler handler;              ///< Optional result handler
+    void *handler_ctx;                   ///< Context passed to the handler
+    ReorderStats stats;                  ///< Counters
+} ReorderBuffer;
+
+/// @brief Initializes a reorder buffer
+/// @param rb Reorder buffer
+/// @param g Garage to apply events to
+/// @param lateness_minutes How far behind the latest event an event may arrive
+///                         and still be applied in order
+void reorder_init(ReorderBuffer *rb, Garage *g, int lateness_minutes);
+
+/// @brief Installs a handler receiving the result of every applied event
+/// @param rb Reorder buffer
+/// @param handler Result handler, or NULL
+/// @param ctx Context passed to the handler
+void reorder_set_handler(ReorderBuffer *rb, ReorderHandler handler, void *ctx);
+
+/// @brief Adds an event and applies every event the watermark has passed
+/// @param rb Reorder buffer
+/// @param source Caller-defined origin passed to the handler
+/// @param ev Event
+/// @return Number of events applied by this call
+int reorder_push(ReorderBuffer *rb, int source, const GateEvent *ev);
+
+/// @brief Applies all buffered events in time order
+/// @param rb Reorder buffer
+/// @return Number of events applied
+int reorder_flush(ReorderBuffer *rb);
+
+#endif //REORDER_H
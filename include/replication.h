@@ -0,0 +1,124 @@
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "structs.h"
+
+/// @file replication.h
+/// @brief Log shipping from a primary garage to a warm standby
+///
+/// With a Replicator attached (garage_set_replicator()), every entry, exit
+/// and correction the primary's Garage accepts is appended to an in-memory
+/// log with a sequence number. A sender thread ships the unacknowledged
+/// tail of the log to the standby over a Unix domain socket, one batch per
+/// write, and waits for the standby to acknowledge the last sequence number
+/// it applied. The standby applies the events to its own Garage, so it is
+/// current when it is promoted.
+///
+/// Every event carries the ticket of the record the primary changed, and the
+/// standby applies exits and corrections by that ticket, so a later record
+/// of the same plate is never mistaken for an earlier one. The standby's
+/// entries must therefore land in the same slots: it must be started with
+/// the same duplicate policy, class quotas and bay layout as the primary,
+/// and an event its garage refuses makes it diverged. After
+/// a disconnect the sender reconnects and resends everything not yet
+/// acknowledged; the standby skips sequence numbers it already applied.
+/// A standby that missed events cannot catch up from the log and has to be
+/// rebuilt: when the primary's log overflows the stream is marked broken
+/// and shipping stops, and a standby that learns of it (or that is reached
+/// by a restarted primary after applying events, or refused an event)
+/// reports itself diverged and refuses promotion.
+
+#define REPL_BATCH 256
+
+/// @brief One replicated change
+typedef struct {
+    GateEvent ev;  ///< Entry, exit or correction as the primary applied it
+    Ticket ticket; ///< Ticket of the record the primary changed (for entries, the ticket it issued)
+} ReplEvent;
+
+/// @brief Opaque primary-side state
+typedef struct Replicator Replicator;
+
+/// @brief Opaque standby-side state
+typedef struct Standby Standby;
+
+/// @brief Replication counters of the primary
+typedef struct {
+    uint64_t appended;           ///< Events logged (sequence number of the newest event)
+    uint64_t acked;              ///< Newest event the standby confirmed applying
+    uint64_t lag_events;         ///< Events logged but not yet acknowledged
+    uint64_t lag_ns;             ///< Age of the oldest unacknowledged event, 0 if none
+    uint64_t batches;            ///< Batches acknowledged
+    uint64_t dropped;            ///< Events lost because the log was full
+    uint64_t reconnects;         ///< Connections made to the standby
+    uint64_t last_ack_latency_ns; ///< Send-to-acknowledgement time of the latest batch
+    uint64_t max_ack_latency_ns;  ///< Worst send-to-acknowledgement time
+    int connected;               ///< 1 while connected to the standby
+    int broken;                  ///< 1 once events were lost or the standby diverged; the standby must be rebuilt
+    int standby_diverged;        ///< 1 if the standby reported it can no longer follow this primary
+} ReplicationStats;
+
+/// @brief Replication counters of the standby
+typedef struct {
+    uint64_t applied_seq; ///< Newest sequence number applied
+    uint64_t batches;     ///< Batches received
+    uint64_t rejected;    ///< Events the standby's garage refused; the first one makes it diverged
+    int connected;        ///< 1 while a primary is connected
+    int diverged;         ///< 1 if the primary lost events or restarted, or an event was refused; the standby must not be promoted
+} StandbyStats;
+
+/// @brief Starts shipping to a standby (connects in the background and keeps retrying)
+/// @param standby_path Socket path the standby listens on
+/// @param log_capacity Unacknowledged events kept before new ones are dropped
+/// @return Replicator handle, or NULL on failure
+Replicator *replicator_create(const char *standby_path, size_t log_capacity);
+
+/// @brief Appends an event to the log (called by the garage; never blocks on the network)
+/// @param r Replicator
+/// @param ev Applied event and the ticket of the record it changed
+/// @return 0 on success, -1 if the log is full or the stream is already broken and the event was dropped
+int replicator_append(Replicator *r, const ReplEvent *ev);
+
+/// @brief Waits until the standby acknowledged every event appended so far
+/// @param r Replicator
+/// @param timeout_ms Maximum wait in milliseconds
+/// @return 0 if caught up, -1 on timeout or if the stream is broken
+int replicator_sync(Replicator *r, int timeout_ms);
+
+/// @brief Copies the primary's replication counters
+/// @param r Replicator
+/// @param stats Output counters
+void replicator_get_stats(Replicator *r, ReplicationStats *stats);
+
+/// @brief Stops the sender thread and frees the replicator (does not wait for the standby)
+/// @param r Replicator (may be NULL)
+void replicator_destroy(Replicator *r);
+
+/// @brief Creates a standby listening for a primary
+/// @param g Garage kept in sync with the primary
+/// @param socket_path Filesystem path of the socket (replaced if it exists)
+/// @return Standby handle, or NULL on failure
+Standby *standby_create(Garage *g, const char *socket_path);
+
+/// @brief Applies the primary's log until standby_stop() is called
+/// @param s Standby
+/// @return 0 when stopped (the garage is then ready to take over),
+///         -1 on error or if the standby diverged (the garage must not take over)
+int standby_run(Standby *s);
+
+/// @brief Asks a running standby to stop (safe from a signal handler or another thread)
+/// @param s Standby
+void standby_stop(Standby *s);
+
+/// @brief Copies the standby's counters (safe from any thread)
+/// @param s Standby
+/// @param stats Output counters
+void standby_get_stats(Standby *s, StandbyStats *stats);
+
+/// @brief Closes the connection, removes the socket file and frees the standby
+/// @param s Standby (may be NULL)
+void standby_destroy(Standby *s);
+
+#endif //REPLICATION_H
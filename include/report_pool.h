@@ -0,0 +1,40 @@
+#ifndef REPORT_POOL_H
+#define REPORT_POOL_H
+
+#include "structs.h"
+
+/// @file report_pool.h
+/// @brief End-of-day reports for many garages on a work-stealing thread pool
+///
+/// The garages are dealt out to the threads in contiguous blocks. Each
+/// thread writes the reports in its own deque and, once it runs dry,
+/// steals from the other end of another thread's deque, so a few garages
+/// with long reports do not leave the other threads idle.
+
+/// @brief Totals merged from all reports of a batch
+typedef struct {
+    int reports;      ///< Reports written
+    int failed;       ///< Reports that could not be written
+    int served;       ///< Vehicles served in all garages
+    int64_t revenue_cents; ///< Revenue collected in all garages, in cents
+    int still_inside; ///< Vehicles still inside in all garages
+    int stolen;       ///< Reports written by a thread that stole them
+} ReportSummary;
+
+/// @brief Writes one report per garage in parallel
+/// @param garages Garages (only read; must not change while the batch runs)
+/// @param paths Report file for each garage
+/// @param n Number of garages
+/// @param threads Number of threads, or 0 to use one per online CPU
+/// @param summary Receives the merged totals
+/// @return 0 if every report was written, -1 otherwise
+int report_pool_run(const Garage *const *garages, const char *const *paths, int n, int threads,
+                    ReportSummary *summary);
+
+/// @brief Writes the merged totals of a batch
+/// @param summary Totals from report_pool_run()
+/// @param filename Name of the output file
+/// @return 0 on success, -1 if the file could not be written
+int write_report_summary(const ReportSummary *summary, const char *filename);
+
+#endif //REPORT_POOL_H
@@ -0,0 +1,55 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stddef.h>
+#include "structs.h"
+#include "occupancy_feed.h"
+
+/// @file server.h
+/// @brief Unix domain socket server for gate controllers
+///
+/// Gate controllers connect to the socket and send one command per line:
+///   ENTRY <plate> <HH:MM> [class]  -> OK | FULL | DUPLICATE
+///                                     (class: EV, DISABLED, MOTORCYCLE or PERMIT)
+///   EXIT <plate> <HH:MM>           -> FEE <euros> | NOTFOUND
+///   CORRECT_ENTRY <plate> <HH:MM>  -> OK | NOTFOUND
+///   CORRECT_EXIT <plate> <HH:MM>   -> OK | NOTFOUND
+///   OCC                            -> OCC <inside> <free>
+/// Commands may be pipelined; responses are returned in request order.
+
+/// @brief Opaque server state
+typedef struct Server Server;
+
+/// @brief Handles a single text command against the garage
+/// @param g Pointer to Garage
+/// @param line Command line without the trailing newline
+/// @param out Buffer for the response line (including newline)
+/// @param out_size Size of the response buffer
+/// @return Length of the response written to out
+int server_handle_line(Garage *g, const char *line, char *out, size_t out_size);
+
+/// @brief Creates a server listening on a Unix domain socket
+/// @param g Pointer to Garage all connections are serialized into
+/// @param socket_path Filesystem path of the socket (replaced if it exists)
+/// @return Server handle, or NULL on failure
+Server *server_create(Garage *g, const char *socket_path);
+
+/// @brief Publishes garage state to an occupancy feed after every handled batch
+/// @param s Server handle
+/// @param feed Feed created with occupancy_feed_create(), or NULL to disable
+void server_set_feed(Server *s, OccupancyFeed *feed);
+
+/// @brief Runs the event loop until server_stop() is called
+/// @param s Server handle
+/// @return 0 on clean shutdown, -1 on error
+int server_run(Server *s);
+
+/// @brief Asks a running server to stop (safe to call from a signal handler or another thread)
+/// @param s Server handle
+void server_stop(Server *s);
+
+/// @brief Closes all connections, removes the socket file and frees the server
+/// @param s Server handle
+void server_destroy(Server *s);
+
+#endif //SERVER_H
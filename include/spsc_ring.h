@@ -0,0 +1,52 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/// @file spsc_ring.h
+/// @brief Lock-free single-producer/single-consumer ring buffer
+
+#define CACHE_LINE_SIZE 64
+
+/// @brief Bounded SPSC ring of fixed-size elements
+///
+/// The producer and consumer indices live on separate cache lines so the two
+/// threads never write to the same line. Each side also keeps a cached copy
+/// of the other side's index and only reloads it when the ring looks full
+/// (producer) or holds less than a full batch (consumer).
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t head; ///< Next slot to read (written by consumer)
+    size_t cached_tail;                           ///< Consumer's copy of tail
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t tail; ///< Next slot to write (written by producer)
+    size_t cached_head;                           ///< Producer's copy of head
+    _Alignas(CACHE_LINE_SIZE) size_t mask;        ///< Capacity - 1 (capacity is a power of two)
+    size_t elem_size;                             ///< Size of one element in bytes
+    unsigned char *slots;                         ///< Element storage
+} SpscRing;
+
+/// @brief Allocates the ring storage
+/// @param r Ring to initialize
+/// @param capacity Number of elements, rounded up to a power of two
+/// @param elem_size Size of one element in bytes
+/// @return 0 on success, -1 if out of memory
+int spsc_ring_init(SpscRing *r, size_t capacity, size_t elem_size);
+
+/// @brief Frees the ring storage
+/// @param r Ring
+void spsc_ring_free(SpscRing *r);
+
+/// @brief Appends one element (producer side only)
+/// @param r Ring
+/// @param elem Element to copy in
+/// @return 0 on success, -1 if the ring is full
+int spsc_ring_push(SpscRing *r, const void *elem);
+
+/// @brief Removes up to max elements (consumer side only)
+/// @param r Ring
+/// @param out Output array with room for max elements
+/// @param max Maximum number of elements to take
+/// @return Number of elements copied to out
+size_t spsc_ring_pop_batch(SpscRing *r, void *out, size_t max);
+
+#endif //SPSC_RING_H
@@ -0,0 +1,73 @@
+#ifndef STAY_INDEX_H
+#define STAY_INDEX_H
+
+#include <stdint.h>
+
+/// @file stay_index.h
+/// @brief Hourly bitmaps of the record slots whose stay overlaps each hour, and
+///        hourly lists of the archived stays
+
+#define STAY_INDEX_HOURS 24   ///< One bucket per hour of the day
+#define STAY_INDEX_WORDS 2    ///< 64-bit words per bucket
+#define STAY_INDEX_SLOTS (64 * STAY_INDEX_WORDS) ///< Record slots the index can hold
+
+/// @brief Slot bitmap of one hour
+typedef struct {
+    uint64_t words[STAY_INDEX_WORDS]; ///< Bit s set if slot s may be inside during the hour
+} StaySet;
+
+/// @brief Stay index; an all-zero index is empty
+typedef struct {
+    StaySet hours[STAY_INDEX_HOURS]; ///< Per-hour slot bitmaps
+} StayIndex;
+
+/// @brief Per-hour lists of archived stays; an all-zero index is empty
+typedef struct {
+    int *stays[STAY_INDEX_HOURS];   ///< Archive positions of the stays overlapping each hour, ascending
+    int count[STAY_INDEX_HOURS];    ///< Entries used per hour
+    int capacity[STAY_INDEX_HOURS]; ///< Entries allocated per hour
+} StayArchiveIndex;
+
+/// @brief Marks a slot in every hour from first_hour to last_hour
+/// @param idx Index
+/// @param slot Record slot
+/// @param first_hour First hour of the stay
+/// @param last_hour Last hour of the stay (>= first_hour)
+void stay_index_add(StayIndex *idx, int slot, int first_hour, int last_hour);
+
+/// @brief Clears a slot from every hour from first_hour to last_hour
+/// @param idx Index
+/// @param slot Record slot
+/// @param first_hour First hour of the stay
+/// @param last_hour Last hour of the stay
+void stay_index_remove(StayIndex *idx, int slot, int first_hour, int last_hour);
+
+/// @brief Collects the slots marked in any hour from first_hour to last_hour
+/// @param idx Index
+/// @param first_hour First hour
+/// @param last_hour Last hour
+/// @param out Union of the hourly bitmaps
+void stay_index_candidates(const StayIndex *idx, int first_hour, int last_hour, StaySet *out);
+
+/// @brief Removes and returns the lowest slot of a set
+/// @param set Slot bitmap
+/// @return Lowest slot, or -1 if the set is empty
+int stay_set_pop(StaySet *set);
+
+/// @brief Makes room for one more stay in every hour, so the next stay_archive_add() cannot fail
+/// @param idx Archive index
+/// @return 0 on success, -1 if out of memory
+int stay_archive_reserve(StayArchiveIndex *idx);
+
+/// @brief Lists an archived stay in every hour from first_hour to last_hour
+/// @param idx Archive index with room reserved by stay_archive_reserve()
+/// @param stay Position of the stay in the archive
+/// @param first_hour First hour of the stay
+/// @param last_hour Last hour of the stay (>= first_hour)
+void stay_archive_add(StayArchiveIndex *idx, int stay, int first_hour, int last_hour);
+
+/// @brief Frees the hourly lists; the index is empty afterwards
+/// @param idx Archive index
+void stay_archive_free(StayArchiveIndex *idx);
+
+#endif //STAY_INDEX_H
@@ -4,26 +4,194 @@
 /// @file structs.h
 /// @brief Contains data structures used throughout the parking garage system
 
+#include <stdatomic.h>
+#include <stdint.h>
+#include "bloom.h"
+#include "plate_index.h"
+#include "entry_heap.h"
+#include "stay_index.h"
+
+/// @brief Number of parking spots (and vehicle records) in the garage
+#define GARAGE_CAPACITY 100
+
+/// @brief Minutes in a day, i.e. points of the occupancy curve
+#define MINUTES_PER_DAY 1440
+
+/// @brief Hours in a day, i.e. revenue buckets
+#define HOURS_PER_DAY 24
+
+/// @brief Revenue is accumulated in whole cents
+#define CENTS_PER_EURO 100
+
+/// @brief Ticket handle returned on entry: generation << 8 | record slot
+typedef uint32_t Ticket;
+
+/// @brief Value never used for a valid ticket
+#define TICKET_INVALID 0u
+
 /// @brief Structure for representing a time (HH:MM)
 typedef struct {
     int hour;   ///< Hour component (0-23)
     int minute; ///< Minute component (0-59)
 } Time;
 
+/// @brief Vehicle classes; every class except CLASS_STANDARD can be given reserved spots
+typedef enum {
+    CLASS_STANDARD,     ///< Regular car, parks in the general pool
+    CLASS_EV,           ///< Electric vehicle using a charging spot
+    CLASS_DISABLED,     ///< Disabled badge holder
+    CLASS_MOTORCYCLE,   ///< Motorcycle
+    CLASS_PERMIT,       ///< Permit holder
+    VEHICLE_CLASS_COUNT ///< Number of classes
+} VehicleClass;
+
 /// @brief Structure for representing a parked vehicle
 typedef struct {
     char license_plate[20]; ///< License plate number
     Time entry_time;        ///< Time of vehicle entry
     Time exit_time;         ///< Time of vehicle exit
     int has_exited;         ///< Flag to check if the vehicle exited (1 = yes, 0 = no)
+    uint32_t generation;    ///< Incremented each time the record slot is (re)used
+    int bay;                ///< Bay assigned on entry, -1 if bays are not tracked
+    uint8_t vehicle_class;  ///< VehicleClass of the vehicle
+    int fee;                ///< Fee booked on exit, kept current by corrections; 0 while inside
 } Vehicle;
 
+/// @brief Corrections kept in a garage's journal before the oldest are overwritten
+#define CORRECTION_JOURNAL_CAPACITY 128
+
+/// @brief One timestamp correction and its effect on the fee
+typedef struct {
+    char license_plate[20]; ///< License plate
+    uint8_t type;           ///< EVENT_CORRECT_ENTRY or EVENT_CORRECT_EXIT
+    int16_t slot;           ///< Record slot
+    Time old_time;          ///< Time before the correction
+    Time new_time;          ///< Corrected time
+    int old_fee;            ///< Fee booked before the correction (0 while inside)
+    int new_fee;            ///< Fee booked after the correction
+} Correction;
+
+/// @brief Journal of the day's corrections
+typedef struct {
+    Correction entries[CORRECTION_JOURNAL_CAPACITY]; ///< Newest corrections, oldest at head
+    int head;       ///< Index of the oldest entry
+    int count;      ///< Entries held
+    long total;     ///< Corrections made, including ones no longer held
+    int64_t fee_delta_cents; ///< Net revenue change of all corrections, in cents
+} CorrectionJournal;
+
+/// @brief What register_entry() does when the plate is already inside
+typedef enum {
+    DUPLICATE_REJECT,         ///< Refuse the new entry (default)
+    DUPLICATE_CLOSE_PREVIOUS, ///< Log an exit for the earlier record at the new entry time, then register
+    DUPLICATE_ALLOW           ///< Register anyway; exits close the earliest record first
+} DuplicatePolicy;
+
+/// @brief Lookup counters kept by the garage
+typedef struct {
+    long plate_lookups;         ///< Plate searches in log_exit() and the update functions
+    long bloom_rejects;         ///< Searches skipped because the filter ruled the plate out
+    long bloom_false_positives; ///< Searches the filter let through that found nothing
+    long duplicate_entries;     ///< Entries for plates that were already inside
+} GarageCounters;
+
+struct AlertWheel;
+struct BayMap;
+struct Replicator;
+struct CdcRing;
+
 /// @brief Structure for the parking garage
 typedef struct {
-    Vehicle vehicles[100];  ///< Fixed-size array for 100 vehicles max
-    int count;              ///< Current number of vehicles in the garage
+    Vehicle vehicles[GARAGE_CAPACITY]; ///< Fixed-size array for 100 vehicles max
+    int count;              ///< Number of record slots in use
     int total_served;       ///< Total number of vehicles served during the day
-    double total_revenue;   ///< Total revenue generated
+    int64_t revenue_cents;  ///< Revenue collected today, in cents
+    int64_t revenue_by_hour[HOURS_PER_DAY];        ///< Revenue in cents by hour of the exit
+    int64_t revenue_by_class[VEHICLE_CLASS_COUNT]; ///< Revenue in cents by vehicle class
+    int occupied;           ///< Vehicles currently inside
+    int free_slots[GARAGE_CAPACITY]; ///< Exited record slots, oldest first, reused once all slots are in use
+    int free_head;          ///< Index of the oldest entry in free_slots
+    int free_count;         ///< Number of entries in free_slots
+    Vehicle *history;       ///< Stays moved out of recycled slots, oldest first (freed by free_garage())
+    int history_count;      ///< Number of stays in history
+    int history_capacity;   ///< Allocated entries of history
+    StayArchiveIndex history_stays; ///< Positions in history by the hours their stay overlaps
+    CountingBloom active_plates;   ///< Plates of vehicles still inside
+    CountingBloom recorded_plates; ///< Plates of all vehicles held in the records
+    PlateIndex active_index;       ///< Plate -> slot of the earliest record still inside
+    EntryHeap active_by_entry;     ///< Slots of vehicles inside, ordered by entry time
+    StayIndex stays;               ///< Slots by the hours their stay overlaps
+    int16_t occupancy_delta[MINUTES_PER_DAY]; ///< Entries minus exits per minute of the day (+1 at minute 0 per overnight stay)
+    DuplicatePolicy duplicate_policy; ///< Handling of entries for plates already inside
+    GarageCounters counters;       ///< Lookup statistics
+    CorrectionJournal corrections; ///< Timestamp corrections and their revenue effect
+    struct AlertWheel *alerts;     ///< Optional overstay/closing alerts, NULL if disabled
+    struct BayMap *bays;           ///< Optional physical bay assignment, NULL if disabled
+    struct Replicator *replica;    ///< Optional log shipping to a standby, NULL if disabled
+    struct CdcRing *changes;       ///< Optional change-data-capture stream, NULL if disabled
+    int class_capacity[VEHICLE_CLASS_COUNT];    ///< Spots reserved per class, 0 if the class uses the general pool
+    atomic_int class_inside[VEHICLE_CLASS_COUNT]; ///< Vehicles inside per class (readable from any thread)
 } Garage;
 
+/// @brief Snapshot of the garage statistics
+typedef struct {
+    long plate_lookups;                ///< Plate searches performed
+    long bloom_rejects;                ///< Searches answered by the Bloom filter alone
+    long bloom_false_positives;        ///< Filter said "maybe" but the plate was absent
+    double bloom_false_positive_rate;  ///< False positives / lookups for absent plates
+    long duplicate_entries;            ///< Entries for plates that were already inside
+} GarageStats;
+
+/// @brief Breakdown of the day's revenue, from running totals
+typedef struct {
+    int64_t booked_cents;     ///< Fees as booked at the exits
+    int64_t adjustment_cents; ///< Net change made by corrections
+    long corrections;         ///< Number of corrections
+    int64_t total_cents;      ///< Revenue after corrections (booked + adjustments)
+} RevenueAudit;
+
+/// @brief Highest point of the occupancy curve
+typedef struct {
+    int occupied; ///< Most vehicles inside at once
+    Time time;    ///< First minute at which that many were inside
+} OccupancyPeak;
+
+/// @brief Which vehicles a VehicleFilter selects by state
+typedef enum {
+    VEHICLES_ALL,    ///< Every recorded vehicle
+    VEHICLES_ACTIVE, ///< Vehicles still inside
+    VEHICLES_EXITED  ///< Vehicles that already left
+} VehicleState;
+
+/// @brief Filter for iterating over the garage's vehicles
+typedef struct {
+    VehicleState state;  ///< Active, exited or all vehicles
+    int entered_before;  ///< Only vehicles that entered before this minute of the day, -1 for no limit
+    int (*match)(const Vehicle *v, void *ctx); ///< Optional extra predicate, non-zero to select
+    void *match_ctx;     ///< Context passed to match
+} VehicleFilter;
+
+/// @brief Cursor over the vehicles selected by a VehicleFilter
+typedef struct {
+    const Garage *garage;  ///< Garage being iterated
+    VehicleFilter filter;  ///< Selection criteria
+    int next;              ///< Next index to examine: archived stays first, then the record slots
+} VehicleIterator;
+
+/// @brief Kind of event reported by a gate controller
+typedef enum {
+    EVENT_ENTRY,         ///< Vehicle entered the garage
+    EVENT_EXIT,          ///< Vehicle left the garage
+    EVENT_CORRECT_ENTRY, ///< Correction of a logged entry time
+    EVENT_CORRECT_EXIT   ///< Correction of a logged exit time
+} EventType;
+
+/// @brief Structure for a single gate event (entry, exit or correction)
+typedef struct {
+    EventType type;         ///< What happened at the gate
+    char license_plate[20]; ///< License plate number
+    Time time;              ///< Time of the event
+    uint8_t vehicle_class;  ///< VehicleClass for entries (CLASS_STANDARD if not reported)
+} GateEvent;
+
 #endif //STRUCTS_HUCTS_H
\ No newline at end of file
@@ -0,0 +1,135 @@
+/**
+ * @file alert_wheel.c
+ * @brief Implements the two-level timing wheel for overstay and closing alerts.
+ *
+ * Timers due within the next 64 minutes sit in one-minute buckets; later
+ * ones sit in 64-minute buckets and are cascaded into the first level when
+ * the wheel reaches their block. Buckets are doubly linked lists threaded
+ * through the per-slot timers, so arming and disarming never allocate.
+ */
+
+#include <string.h>
+#include "alert_wheel.h"
+#include "functions.h"
+
+/**
+ * @brief Initializes an alert wheel.
+ *
+ * @param w Wheel
+ * @param max_stay_minutes Maximum stay in minutes (0 disables overstay alerts)
+ * @param closing Closing time, or NULL
+ * @param handler Alert callback
+ * @param ctx Context passed to the handler
+ */
+void alert_wheel_init(AlertWheel *w, int max_stay_minutes, const Time *closing, AlertHandler handler, void *ctx) {
+    memset(w, 0, sizeof(*w));
+    w->now = -1;
+    w->max_stay = max_stay_minutes > 0 ? max_stay_minutes : 0;
+    w->closing = closing ? time_to_minutes(*closing) : -1;
+    w->handler = handler;
+    w->handler_ctx = ctx;
+    memset(w->heads, 0xff, sizeof(w->heads));
+    for (int i = 0; i < GARAGE_CAPACITY; ++i) w->timers[i].bucket = -1;
+}
+
+static void unlink_timer(AlertWheel *w, int slot) {
+    AlertTimer *t = &w->timers[slot];
+    if (t->prev >= 0) w->timers[t->prev].next = t->next;
+    else w->heads[t->bucket] = t->next;
+    if (t->next >= 0) w->timers[t->next].prev = t->prev;
+    t->bucket = -1;
+}
+
+static void fire(AlertWheel *w, int slot) {
+    AlertTimer *t = &w->timers[slot];
+    AlertReason reason = (AlertReason)t->reason;
+    Time deadline = {t->deadline / 60, t->deadline % 60};
+
+    if (reason == ALERT_OVERSTAY) w->stats.overstay++;
+    else w->stats.closing++;
+    if (w->handler) w->handler(w->handler_ctx, &w->garage->vehicles[slot], reason, deadline);
+}
+
+/**
+ * @brief Links a timer into the bucket for its deadline, or fires it if due.
+ */
+static void schedule(AlertWheel *w, int slot, int deadline, AlertReason reason) {
+    AlertTimer *t = &w->timers[slot];
+    t->deadline = (int16_t)deadline;
+    t->reason = (uint8_t)reason;
+
+    if (deadline <= w->now) {
+        fire(w, slot);
+        // An overstay that is already due still leaves the closing alert
+        if (reason == ALERT_OVERSTAY && w->closing > deadline) schedule(w, slot, w->closing, ALERT_CLOSING);
+        return;
+    }
+
+    int bucket = deadline - w->now < ALERT_WHEEL_NEAR
+                     ? deadline % ALERT_WHEEL_NEAR
+                     : ALERT_WHEEL_NEAR + (deadline / ALERT_WHEEL_NEAR) % ALERT_WHEEL_FAR;
+    t->bucket = (int16_t)bucket;
+    t->prev = -1;
+    t->next = w->heads[bucket];
+    if (t->next >= 0) w->timers[t->next].prev = (int16_t)slot;
+    w->heads[bucket] = (int16_t)slot;
+}
+
+/**
+ * @brief Arms the timer of a vehicle that is inside.
+ *
+ * @param w Wheel
+ * @param slot Record slot of the vehicle
+ */
+void alert_wheel_arm(AlertWheel *w, int slot) {
+    alert_wheel_disarm(w, slot);
+    int entry = time_to_minutes(w->garage->vehicles[slot].entry_time);
+
+    if (w->max_stay > 0 && (w->closing < 0 || entry + w->max_stay < w->closing)) {
+        schedule(w, slot, entry + w->max_stay, ALERT_OVERSTAY);
+    } else if (w->closing >= 0) {
+        schedule(w, slot, w->closing, ALERT_CLOSING);
+    }
+}
+
+/**
+ * @brief Disarms the timer of a slot.
+ *
+ * @param w Wheel
+ * @param slot Record slot
+ */
+void alert_wheel_disarm(AlertWheel *w, int slot) {
+    if (w->timers[slot].bucket >= 0) unlink_timer(w, slot);
+}
+
+/**
+ * @brief Fires every timer due up to and including a minute.
+ *
+ * @param w Wheel
+ * @param now Current minute since midnight
+ */
+void alert_wheel_advance(AlertWheel *w, int now) {
+    while (w->now < now) {
+        int minute = ++w->now;
+
+        // Entering a new 64-minute block: move its timers to the first level
+        if (minute % ALERT_WHEEL_NEAR == 0) {
+            int far = ALERT_WHEEL_NEAR + (minute / ALERT_WHEEL_NEAR) % ALERT_WHEEL_FAR;
+            while (w->heads[far] >= 0) {
+                int slot = w->heads[far];
+                unlink_timer(w, slot);
+                schedule(w, slot, w->timers[slot].deadline, (AlertReason)w->timers[slot].reason);
+            }
+        }
+
+        int near = minute % ALERT_WHEEL_NEAR;
+        while (w->heads[near] >= 0) {
+            int slot = w->heads[near];
+            unlink_timer(w, slot);
+            fire(w, slot);
+            if (w->timers[slot].reason == ALERT_OVERSTAY && w->closing > minute) {
+                schedule(w, slot, w->closing, ALERT_CLOSING);
+            }
+        }
+    }
+}
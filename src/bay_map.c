@@ -0,0 +1,159 @@
+/**
+ * @file bay_map.c
+ * @brief Implements the hierarchical bitmap bay allocator.
+ *
+ * A set bit means "free". Allocation follows the lowest set bit down from
+ * the top word to the summary word to the bay word with three
+ * count-trailing-zeros; freeing sets the bay bit and the parent bits. A
+ * parent bit is cleared only when its child word becomes zero.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "bay_map.h"
+
+struct BayMap {
+    int levels;
+    int per_level;
+    int total;
+    int free;
+    int *level_free;   ///< Free bays per level
+    uint64_t top;      ///< Bit s set if summary[s] != 0
+    uint64_t summary[64]; ///< Bit w % 64 of summary[w / 64] set if words[w] != 0
+    uint64_t *words;   ///< Bit b % 64 of words[b / 64] set if bay b is free
+};
+
+/**
+ * @brief Creates a bay map with all bays free.
+ *
+ * @param levels Number of parking levels
+ * @param bays_per_level Bays on each level
+ * @return Bay map, or NULL on failure
+ */
+BayMap *bay_map_create(int levels, int bays_per_level) {
+    if (levels <= 0 || bays_per_level <= 0 || levels > BAY_MAP_MAX_BAYS / bays_per_level) return NULL;
+
+    BayMap *m = calloc(1, sizeof(BayMap));
+    if (!m) return NULL;
+    m->levels = levels;
+    m->per_level = bays_per_level;
+    m->total = levels * bays_per_level;
+    m->free = m->total;
+
+    int nwords = (m->total + 63) / 64;
+    m->words = calloc((size_t)nwords, sizeof(uint64_t));
+    m->level_free = malloc(sizeof(int) * (size_t)levels);
+    if (!m->words || !m->level_free) {
+        bay_map_destroy(m);
+        return NULL;
+    }
+
+    for (int l = 0; l < levels; ++l) m->level_free[l] = bays_per_level;
+    for (int w = 0; w < nwords; ++w) {
+        int bits = m->total - w * 64 < 64 ? m->total - w * 64 : 64;
+        m->words[w] = bits == 64 ? UINT64_MAX : (1ull << bits) - 1;
+        m->summary[w / 64] |= 1ull << (w % 64);
+        m->top |= 1ull << (w / 64);
+    }
+    return m;
+}
+
+/**
+ * @brief Frees a bay map.
+ *
+ * @param m Bay map (may be NULL)
+ */
+void bay_map_destroy(BayMap *m) {
+    if (!m) return;
+    free(m->words);
+    free(m->level_free);
+    free(m);
+}
+
+/**
+ * @brief Takes the nearest free bay.
+ *
+ * @param m Bay map
+ * @return Bay number, or -1 if full
+ */
+int bay_map_alloc(BayMap *m) {
+    if (m->top == 0) return -1;
+    int s = __builtin_ctzll(m->top);
+    int w = s * 64 + __builtin_ctzll(m->summary[s]);
+    int bay = w * 64 + __builtin_ctzll(m->words[w]);
+
+    m->words[w] &= m->words[w] - 1;
+    if (m->words[w] == 0) {
+        m->summary[s] &= ~(1ull << (w % 64));
+        if (m->summary[s] == 0) m->top &= ~(1ull << s);
+    }
+    m->free--;
+    m->level_free[bay / m->per_level]--;
+    return bay;
+}
+
+/**
+ * @brief Returns a bay.
+ *
+ * @param m Bay map
+ * @param bay Bay number
+ * @return 0 on success, -1 if out of range or already free
+ */
+int bay_map_free(BayMap *m, int bay) {
+    if (bay < 0 || bay >= m->total) return -1;
+    int w = bay / 64;
+    uint64_t bit = 1ull << (bay % 64);
+    if (m->words[w] & bit) return -1;
+
+    m->words[w] |= bit;
+    m->summary[w / 64] |= 1ull << (w % 64);
+    m->top |= 1ull << (w / 64);
+    m->free++;
+    m->level_free[bay / m->per_level]++;
+    return 0;
+}
+
+/**
+ * @brief Number of free bays.
+ *
+ * @param m Bay map
+ * @return Free bays
+ */
+int bay_map_free_count(const BayMap *m) {
+    return m->free;
+}
+
+/**
+ * @brief Number of parking levels.
+ *
+ * @param m Bay map
+ * @return Levels
+ */
+int bay_map_levels(const BayMap *m) {
+    return m->levels;
+}
+
+/**
+ * @brief Number of free bays on one level.
+ *
+ * @param m Bay map
+ * @param level Level index
+ * @return Free bays on the level, 0 for an invalid level
+ */
+int bay_map_level_free(const BayMap *m, int level) {
+    if (level < 0 || level >= m->levels) return 0;
+    return m->level_free[level];
+}
+
+/**
+ * @brief Splits a bay number into level and bay on that level.
+ *
+ * @param m Bay map
+ * @param bay Bay number
+ * @param level Receives the level
+ * @param number Receives the bay on the level
+ */
+void bay_map_locate(const BayMap *m, int bay, int *level, int *number) {
+    *level = bay / m->per_level;
+    *number = bay % m->per_level;
+}
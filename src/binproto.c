@@ -0,0 +1,170 @@
+/**
+ * @file binproto.c
+ * @brief Implements the binary gate protocol and its client library.
+ *
+ * Requests and responses have a fixed layout, so the server can apply them
+ * without any text parsing. The client functions send whole batches of
+ * requests in one write and read responses back in bulk.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "binproto.h"
+#include "garage.h"
+
+/**
+ * @brief Fills in a binary request.
+ *
+ * @param req Request to fill
+ * @param op Operation
+ * @param plate License plate, may be NULL for occupancy queries
+ * @param time Event time
+ * @param tag Caller-chosen tag echoed in the response
+ */
+void binproto_make_request(BinRequest *req, BinOp op, const char *plate, Time time, uint32_t tag) {
+    memset(req, 0, sizeof(*req));
+    req->magic = BINPROTO_MAGIC;
+    req->op = (uint8_t)op;
+    req->hour = (uint8_t)time.hour;
+    req->minute = (uint8_t)time.minute;
+    req->tag = tag;
+    if (plate) strncpy(req->license_plate, plate, sizeof(req->license_plate) - 1);
+}
+
+/**
+ * @brief Applies a binary request to the garage.
+ *
+ * @param g Pointer to the Garage structure
+ * @param req Request
+ * @param resp Response to fill
+ */
+void binproto_handle(Garage *g, const BinRequest *req, BinResponse *resp) {
+    memset(resp, 0, sizeof(*resp));
+    resp->magic = BINPROTO_MAGIC;
+    resp->tag = req->tag;
+
+    if (req->magic != BINPROTO_MAGIC) {
+        resp->status = BIN_ERROR;
+        return;
+    }
+
+    if (req->op == BIN_OP_OCCUPANCY) {
+        resp->value = current_occupancy(g);
+        resp->value2 = GARAGE_CAPACITY - resp->value;
+        return;
+    }
+
+    if (req->hour > 23 || req->minute > 59 ||
+        memchr(req->license_plate, '\0', sizeof(req->license_plate)) == NULL) {
+        resp->status = BIN_ERROR;
+        return;
+    }
+
+    GateEvent ev;
+    ev.vehicle_class = CLASS_STANDARD; // the binary request has no class field
+    switch (req->op) {
+        case BIN_OP_ENTRY: ev.type = EVENT_ENTRY; break;
+        case BIN_OP_EXIT: ev.type = EVENT_EXIT; break;
+        case BIN_OP_CORRECT_ENTRY: ev.type = EVENT_CORRECT_ENTRY; break;
+        case BIN_OP_CORRECT_EXIT: ev.type = EVENT_CORRECT_EXIT; break;
+        default:
+            resp->status = BIN_ERROR;
+            return;
+    }
+    memcpy(ev.license_plate, req->license_plate, sizeof(ev.license_plate));
+    ev.time.hour = req->hour;
+    ev.time.minute = req->minute;
+
+    int result = apply_gate_event(g, &ev);
+    if (ev.type == EVENT_EXIT && result >= 0) {
+        resp->value = result;
+    } else if (result == -2 && ev.type == EVENT_ENTRY) {
+        resp->status = BIN_DUPLICATE;
+    } else if (result != 0) {
+        resp->status = ev.type == EVENT_ENTRY ? BIN_FULL : BIN_NOT_FOUND;
+    }
+}
+
+/**
+ * @brief Connects to a gate controller server.
+ *
+ * @param socket_path Path of the server socket
+ * @return Connected socket, or -1 on failure
+ */
+int binclient_connect(const char *socket_path) {
+    struct sockaddr_un addr = {0};
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) return -1;
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Sends a batch of pipelined requests.
+ *
+ * @param fd Connected socket
+ * @param reqs Requests
+ * @param n Number of requests
+ * @return 0 on success, -1 on failure
+ */
+int binclient_send(int fd, const BinRequest *reqs, int n) {
+    const char *data = (const char *)reqs;
+    size_t left = (size_t)n * sizeof(BinRequest);
+    while (left > 0) {
+        ssize_t w = write(fd, data, left);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += w;
+        left -= (size_t)w;
+    }
+    return 0;
+}
+
+/**
+ * @brief Receives exactly n responses.
+ *
+ * @param fd Connected socket
+ * @param resps Output responses
+ * @param n Number of responses
+ * @return 0 on success, -1 on failure or disconnect
+ */
+int binclient_recv(int fd, BinResponse *resps, int n) {
+    char *data = (char *)resps;
+    size_t left = (size_t)n * sizeof(BinResponse);
+    while (left > 0) {
+        ssize_t r = read(fd, data, left);
+        if (r == 0) return -1;
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += r;
+        left -= (size_t)r;
+    }
+    return 0;
+}
+
+/**
+ * @brief Sends one request and waits for its response.
+ *
+ * @param fd Connected socket
+ * @param req Request
+ * @param resp Response
+ * @return 0 on success, -1 on failure
+ */
+int binclient_call(int fd, const BinRequest *req, BinResponse *resp) {
+    if (binclient_send(fd, req, 1) != 0) return -1;
+    return binclient_recv(fd, resp, 1);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file bloom.c
+ * @brief Implements the counting Bloom filter used to reject unknown plates.
+ *
+ * Counter positions are derived from one 64-bit plate hash by double
+ * hashing (h1 + i * h2). Counters saturate at 255 and are then never
+ * decremented again, so a saturated position can only cause false
+ * positives, never false negatives.
+ */
+
+#include "bloom.h"
+
+static unsigned bloom_position(uint64_t hash, int i) {
+    uint32_t h1 = (uint32_t)hash;
+    uint32_t h2 = (uint32_t)(hash >> 32) | 1u;
+    return (h1 + (uint32_t)i * h2) & (BLOOM_COUNTERS - 1);
+}
+
+/**
+ * @brief Adds a plate hash to the filter.
+ *
+ * @param b Filter
+ * @param hash Plate hash
+ */
+void bloom_add(CountingBloom *b, uint64_t hash) {
+    for (int i = 0; i < BLOOM_HASHES; ++i) {
+        uint8_t *c = &b->counters[bloom_position(hash, i)];
+        if (*c < UINT8_MAX) (*c)++;
+    }
+}
+
+/**
+ * @brief Removes a plate hash previously added with bloom_add().
+ *
+ * @param b Filter
+ * @param hash Plate hash
+ */
+void bloom_remove(CountingBloom *b, uint64_t hash) {
+    for (int i = 0; i < BLOOM_HASHES; ++i) {
+        uint8_t *c = &b->counters[bloom_position(hash, i)];
+        if (*c > 0 && *c < UINT8_MAX) (*c)--;
+    }
+}
+
+/**
+ * @brief Tests whether a plate hash may be in the filter.
+ *
+ * @param b Filter
+ * @param hash Plate hash
+ * @return 0 if definitely absent, 1 if possibly present
+ */
+int bloom_maybe_contains(const CountingBloom *b, uint64_t hash) {
+    for (int i = 0; i < BLOOM_HASHES; ++i) {
+        if (b->counters[bloom_position(hash, i)] == 0) return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file cdc.c
+ * @brief Implements the change-data-capture broadcast ring.
+ *
+ * Every slot carries the sequence number of the record it holds and is
+ * written like the occupancy feed's seqlock: the producer marks the slot
+ * busy (sequence 0), copies the record in and then publishes its sequence
+ * number. A reader copies the record out and keeps it only if the slot
+ * held the expected sequence number both before and after the copy;
+ * otherwise the producer lapped it, and it skips to the oldest record that
+ * is still in the ring.
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cdc.h"
+#include "spsc_ring.h"
+
+/// @brief Ring slot
+typedef struct {
+    atomic_uint_fast64_t seq; ///< Sequence number of rec, 0 while being written
+    CdcRecord rec;
+} CdcSlot;
+
+struct CdcRing {
+    size_t mask;   ///< Capacity - 1
+    CdcSlot *slots;
+    _Alignas(CACHE_LINE_SIZE) atomic_uint_fast64_t head; ///< Newest published sequence number
+};
+
+/**
+ * @brief Creates a ring.
+ *
+ * @param capacity Records kept
+ * @return Ring, or NULL on failure
+ */
+CdcRing *cdc_ring_create(size_t capacity) {
+    size_t cap = 2;
+    while (cap < capacity) cap <<= 1;
+
+    CdcRing *r = aligned_alloc(CACHE_LINE_SIZE, sizeof(CdcRing));
+    if (!r) return NULL;
+    memset(r, 0, sizeof(*r));
+    r->slots = calloc(cap, sizeof(CdcSlot));
+    if (!r->slots) {
+        free(r);
+        return NULL;
+    }
+    r->mask = cap - 1;
+    return r;
+}
+
+/**
+ * @brief Frees a ring.
+ *
+ * @param r Ring (may be NULL)
+ */
+void cdc_ring_destroy(CdcRing *r) {
+    if (!r) return;
+    free(r->slots);
+    free(r);
+}
+
+/**
+ * @brief Publishes a record, overwriting the oldest one if the ring is full.
+ *
+ * @param r Ring
+ * @param rec Record to publish
+ * @return Sequence number given to the record
+ */
+uint64_t cdc_ring_publish(CdcRing *r, const CdcRecord *rec) {
+    uint64_t seq = atomic_load_explicit(&r->head, memory_order_relaxed) + 1;
+    CdcSlot *slot = &r->slots[seq & r->mask];
+
+    atomic_store_explicit(&slot->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&slot->rec, rec, sizeof(*rec));
+    slot->rec.seq = seq;
+    atomic_store_explicit(&slot->seq, seq, memory_order_release);
+    atomic_store_explicit(&r->head, seq, memory_order_release);
+    return seq;
+}
+
+/**
+ * @brief Sequence number of the newest published record.
+ *
+ * @param r Ring
+ * @return Newest sequence number, 0 if none
+ */
+uint64_t cdc_ring_head(const CdcRing *r) {
+    return atomic_load_explicit(&((CdcRing *)r)->head, memory_order_acquire);
+}
+
+/**
+ * @brief Positions a cursor on a ring.
+ *
+ * @param c Cursor
+ * @param r Ring
+ * @param start Where to start reading
+ */
+void cdc_cursor_init(CdcCursor *c, const CdcRing *r, CdcStart start) {
+    uint64_t head = cdc_ring_head(r);
+    c->ring = r;
+    c->lost = 0;
+    if (start == CDC_FROM_NOW) c->next = head + 1;
+    else c->next = head > r->mask + 1 ? head - r->mask : 1;
+}
+
+/**
+ * @brief Reads the next records in sequence order.
+ *
+ * @param c Cursor
+ * @param out Receives up to max records
+ * @param max Capacity of out
+ * @return Number of records read
+ */
+int cdc_cursor_poll(CdcCursor *c, CdcRecord *out, int max) {
+    CdcRing *r = (CdcRing *)c->ring;
+    int n = 0;
+
+    while (n < max) {
+        uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (c->next > head) break;
+        if (head - c->next > r->mask) {
+            // Lapped: everything before the oldest record still in the ring is gone
+            c->lost += head - r->mask - c->next;
+            c->next = head - r->mask;
+        }
+
+        CdcSlot *slot = &r->slots[c->next & r->mask];
+        uint64_t before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        memcpy(&out[n], &slot->rec, sizeof(CdcRecord));
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t after = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+        if (before != c->next || after != c->next) continue; // overwritten while copying; re-check head
+
+        c->next++;
+        n++;
+    }
+    return n;
+}
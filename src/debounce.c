@@ -0,0 +1,101 @@
+/**
+ * @file debounce.c
+ * @brief Implements the two-bucket debouncer for repeated plate reads.
+ *
+ * Reads are kept in small open-addressing tables, one per time bucket of
+ * window_ms. When the current bucket is over, it becomes the previous one
+ * and the oldest is cleared, so every read younger than one window is
+ * always found and memory stays fixed. Only camera events (entries and
+ * exits) are debounced; corrections always pass.
+ */
+
+#include <string.h>
+#include "debounce.h"
+#include "functions.h"
+
+/**
+ * @brief Initializes a debouncer.
+ *
+ * @param d Debouncer
+ * @param window_ms Coalescing window in milliseconds
+ */
+void debouncer_init(Debouncer *d, uint32_t window_ms) {
+    memset(d, 0, sizeof(*d));
+    d->window_ms = window_ms;
+}
+
+/**
+ * @brief Moves to the bucket containing now_ms, clearing expired buckets.
+ */
+static void debouncer_advance(Debouncer *d, uint64_t now_ms) {
+    if (now_ms < d->bucket_start_ms + d->window_ms) return;
+
+    if (now_ms >= d->bucket_start_ms + 2ull * d->window_ms) {
+        // Both buckets are older than one window
+        memset(d->buckets, 0, sizeof(d->buckets));
+        d->bucket_start_ms = now_ms;
+        return;
+    }
+    d->current ^= 1;
+    memset(d->buckets[d->current], 0, sizeof(d->buckets[d->current]));
+    d->bucket_start_ms += d->window_ms;
+}
+
+/**
+ * @brief Finds a hash in a bucket.
+ *
+ * @return Matching entry, or the empty entry where it would be inserted,
+ *         or NULL if the bucket is full
+ */
+static DebounceEntry *bucket_probe(DebounceEntry *bucket, uint64_t hash) {
+    unsigned pos = (unsigned)hash & (DEBOUNCE_BUCKETS - 1);
+    for (int i = 0; i < DEBOUNCE_BUCKETS; ++i) {
+        DebounceEntry *e = &bucket[(pos + (unsigned)i) & (DEBOUNCE_BUCKETS - 1)];
+        if (e->hash == hash || e->hash == 0) return e;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Decides whether a read should reach the garage.
+ *
+ * @param d Debouncer
+ * @param ev Gate event built from the read
+ * @param now_ms Monotonic time of the read in milliseconds
+ * @return 1 if the event should be applied, 0 if it repeats a recent read
+ */
+int debouncer_accept(Debouncer *d, const GateEvent *ev, uint64_t now_ms) {
+    if (d->window_ms == 0 || (ev->type != EVENT_ENTRY && ev->type != EVENT_EXIT)) {
+        d->passed++;
+        return 1;
+    }
+    debouncer_advance(d, now_ms);
+
+    // Keep entry and exit reads of the same plate apart; never hash to 0
+    uint64_t hash = (plate_hash(ev->license_plate) ^ ((uint64_t)ev->type * 0x9E3779B97F4A7C15ull)) | 1u;
+
+    DebounceEntry *prev = bucket_probe(d->buckets[d->current ^ 1], hash);
+    DebounceEntry *cur = bucket_probe(d->buckets[d->current], hash);
+    uint64_t last = 0;
+    int seen = 0;
+    if (cur && cur->hash == hash) {
+        last = cur->seen_ms;
+        seen = 1;
+    } else if (prev && prev->hash == hash) {
+        last = prev->seen_ms;
+        seen = 1;
+    }
+
+    // A plate held in front of the camera keeps refreshing its entry
+    if (cur) {
+        cur->hash = hash;
+        cur->seen_ms = now_ms;
+    }
+
+    if (seen && now_ms - last < d->window_ms) {
+        d->suppressed++;
+        return 0;
+    }
+    d->passed++;
+    return 1;
+}
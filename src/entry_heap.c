@@ -0,0 +1,156 @@
+/**
+ * @file entry_heap.c
+ * @brief Implements the indexed min-heap of active vehicles by entry time.
+ *
+ * Each slot's position in the heap is tracked, so removing a vehicle on
+ * exit or moving it after an entry-time correction is O(log n). Oldest-K
+ * queries walk the heap best-first with a small candidate heap and touch
+ * O(K log K) nodes; entered-before queries prune every subtree whose root
+ * is already too late.
+ */
+
+#include "entry_heap.h"
+
+/// @brief Heap order: earlier entry first, lower slot on ties
+static int node_before(EntryHeapNode a, EntryHeapNode b) {
+    if (a.key != b.key) return a.key < b.key;
+    return a.slot < b.slot;
+}
+
+static void place(EntryHeap *h, int i, EntryHeapNode n) {
+    h->nodes[i] = n;
+    h->pos_plus_one[n.slot] = (int16_t)(i + 1);
+}
+
+static void sift_up(EntryHeap *h, int i) {
+    EntryHeapNode n = h->nodes[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!node_before(n, h->nodes[parent])) break;
+        place(h, i, h->nodes[parent]);
+        i = parent;
+    }
+    place(h, i, n);
+}
+
+static void sift_down(EntryHeap *h, int i) {
+    EntryHeapNode n = h->nodes[i];
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= h->size) break;
+        if (child + 1 < h->size && node_before(h->nodes[child + 1], h->nodes[child])) child++;
+        if (!node_before(h->nodes[child], n)) break;
+        place(h, i, h->nodes[child]);
+        i = child;
+    }
+    place(h, i, n);
+}
+
+/**
+ * @brief Adds a slot or moves it to a new key.
+ *
+ * @param h Heap
+ * @param slot Record slot
+ * @param key Entry minute
+ */
+void entry_heap_set(EntryHeap *h, int slot, int key) {
+    EntryHeapNode n = {(int16_t)key, (int16_t)slot};
+    int i = h->pos_plus_one[slot] - 1;
+    if (i < 0) {
+        i = h->size++;
+        place(h, i, n);
+        sift_up(h, i);
+        return;
+    }
+    h->nodes[i] = n;
+    sift_up(h, i);
+    sift_down(h, h->pos_plus_one[slot] - 1);
+}
+
+/**
+ * @brief Removes a slot if present.
+ *
+ * @param h Heap
+ * @param slot Record slot
+ */
+void entry_heap_remove(EntryHeap *h, int slot) {
+    int i = h->pos_plus_one[slot] - 1;
+    if (i < 0) return;
+    h->pos_plus_one[slot] = 0;
+
+    EntryHeapNode last = h->nodes[--h->size];
+    if (i == h->size) return;
+    place(h, i, last);
+    sift_up(h, i);
+    sift_down(h, h->pos_plus_one[last.slot] - 1);
+}
+
+/**
+ * @brief Lists the k slots with the earliest entries, earliest first.
+ *
+ * The candidates are heap indices whose parent has been output; the
+ * earliest candidate is always the next answer.
+ *
+ * @param h Heap
+ * @param k Number of slots wanted
+ * @param out Receives up to k slots
+ * @return Number of slots written
+ */
+int entry_heap_oldest(const EntryHeap *h, int k, int *out) {
+    int cand[ENTRY_HEAP_CAPACITY];
+    int ncand = 0, n = 0;
+    if (h->size > 0) cand[ncand++] = 0;
+
+    while (n < k && ncand > 0) {
+        // Pop the earliest candidate from the candidate heap
+        int top = cand[0];
+        int last = cand[--ncand];
+        int i = 0;
+        for (;;) {
+            int child = 2 * i + 1;
+            if (child >= ncand) break;
+            if (child + 1 < ncand && node_before(h->nodes[cand[child + 1]], h->nodes[cand[child]])) child++;
+            if (!node_before(h->nodes[cand[child]], h->nodes[last])) break;
+            cand[i] = cand[child];
+            i = child;
+        }
+        if (ncand > 0) cand[i] = last;
+
+        out[n++] = h->nodes[top].slot;
+
+        // Its children become candidates
+        for (int c = 2 * top + 1; c <= 2 * top + 2 && c < h->size; ++c) {
+            int j = ncand++;
+            while (j > 0 && node_before(h->nodes[c], h->nodes[cand[(j - 1) / 2]])) {
+                cand[j] = cand[(j - 1) / 2];
+                j = (j - 1) / 2;
+            }
+            cand[j] = c;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief Lists every slot whose entry is before a minute.
+ *
+ * @param h Heap
+ * @param key Exclusive upper bound on the entry minute
+ * @param out Receives the slots
+ * @param max Capacity of out
+ * @return Number of slots written
+ */
+int entry_heap_before(const EntryHeap *h, int key, int *out, int max) {
+    int stack[ENTRY_HEAP_CAPACITY];
+    int depth = 0, n = 0;
+    if (h->size > 0) stack[depth++] = 0;
+
+    while (depth > 0 && n < max) {
+        int i = stack[--depth];
+        if (h->nodes[i].key >= key) continue; // so is everything below it
+        out[n++] = h->nodes[i].slot;
+        if (2 * i + 1 < h->size) stack[depth++] = 2 * i + 1;
+        if (2 * i + 2 < h->size) stack[depth++] = 2 * i + 2;
+    }
+    return n;
+}
@@ -13,22 +13,67 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "functions.h"
 
 /**
  * @brief Parses a time string in the format "HH:MM" into a Time struct.
  *
  * This function converts a string input into hour and minute values.
+ * Trailing whitespace (such as the newline read by fgets()) is accepted;
+ * anything else, or a time outside 00:00-23:59, is rejected.
  *
  * @param str The input time string in "HH:MM" format
- * @return Time struct containing hour and minute fields
+ * @return Time struct containing hour and minute fields, or {-1, -1} if the string is not a valid time
  */
 Time parse_time(const char *str) {
-    Time t;
-    sscanf(str, "%d:%d", &t.hour, &t.minute);
+    Time t = {-1, -1};
+    int h, m;
+    char extra;
+    if (sscanf(str, "%d:%d %c", &h, &m, &extra) != 2) return t;
+    t.hour = h;
+    t.minute = m;
+    if (!time_valid(t)) t.hour = t.minute = -1;
     return t;
 }
 
+/**
+ * @brief Checks that a time lies within a day (00:00-23:59).
+ *
+ * @param t Time to check
+ * @return 1 if valid, 0 otherwise
+ */
+int time_valid(Time t) {
+    return t.hour >= 0 && t.hour <= 23 && t.minute >= 0 && t.minute <= 59;
+}
+
+/**
+ * @brief Converts a time to minutes since midnight.
+ *
+ * @param t Time to convert
+ * @return Minutes since midnight
+ */
+int time_to_minutes(Time t) {
+    return t.hour * 60 + t.minute;
+}
+
+/**
+ * @brief Hashes a license plate with 64-bit FNV-1a.
+ *
+ * Shared by the plate lookup structures so a plate is hashed once per call.
+ *
+ * @param plate License plate
+ * @return Hash value
+ */
+uint64_t plate_hash(const char *plate) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const unsigned char *p = (const unsigned char *)plate; *p; ++p) {
+        hash ^= *p;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
 /**
  * @brief Calculates the duration between two times, rounded up to full hours.
  *
@@ -54,4 +99,46 @@ int calculate_duration(Time entry, Time exit) {
 
     // Round up to the next full hour
     return (diff + 59) / 60;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Formats an amount of cents as euros and cents.
+ *
+ * @param cents Amount in cents
+ * @param buf Output buffer
+ * @param size Size of buf
+ */
+void format_cents(int64_t cents, char *buf, size_t size) {
+    uint64_t abs_cents = cents < 0 ? 0 - (uint64_t)cents : (uint64_t)cents;
+    snprintf(buf, size, "%s%llu.%02llu", cents < 0 ? "-" : "",
+             (unsigned long long)(abs_cents / CENTS_PER_EURO),
+             (unsigned long long)(abs_cents % CENTS_PER_EURO));
+}
+
+static const char *const VEHICLE_CLASS_NAMES[VEHICLE_CLASS_COUNT] = {
+    "STANDARD", "EV", "DISABLED", "MOTORCYCLE", "PERMIT"
+};
+
+/**
+ * @brief Returns the short name of a vehicle class.
+ *
+ * @param cls Vehicle class
+ * @return Class name, "?" for invalid values
+ */
+const char *vehicle_class_name(VehicleClass cls) {
+    if ((unsigned)cls >= VEHICLE_CLASS_COUNT) return "?";
+    return VEHICLE_CLASS_NAMES[cls];
+}
+
+/**
+ * @brief Parses a vehicle class name.
+ *
+ * @param name Class name
+ * @return Vehicle class, or -1 if unknown
+ */
+int parse_vehicle_class(const char *name) {
+    for (int i = 0; i < VEHICLE_CLASS_COUNT; ++i) {
+        if (strcmp(name, VEHICLE_CLASS_NAMES[i]) == 0) return i;
+    }
+    return -1;
+}
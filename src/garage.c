@@ -6,6 +6,33 @@
  * such as registering vehicles, logging exits, calculating fees, correcting timestamps,
  * and displaying garage occupancy.
  *
+ * Plate searches are guarded by two counting Bloom filters: one over the
+ * vehicles still inside (for exits) and one over every plate held in the
+ * records (for corrections). Misread or unknown plates are usually rejected
+ * by the filter without scanning the records. Vehicles still inside are also
+ * indexed by plate, which makes exits and duplicate-entry checks O(1).
+ * A heap of the vehicles inside ordered by entry time answers
+ * longest-parked and entered-before queries without a scan and sort, and
+ * hourly stay bitmaps narrow "who was inside at T" audits to the vehicles
+ * whose stay overlaps T's hour. A per-minute difference array of entries
+ * and exits yields the day's occupancy curve with one prefix-sum sweep.
+ * Vehicle classes with reserved spots are admitted against their own
+ * counter, all other classes against the general pool; the per-class
+ * counters are atomics so other threads can report them without locking.
+ * With a bay map attached, every entry is given the nearest free bay and
+ * the garage counts as full when no bay is left. With an alert wheel
+ * attached, entries arm and exits disarm per-vehicle overstay/closing
+ * timers, and every event advances the wheel to its time.
+ * Revenue is kept in integer cents, in total and in buckets per hour of
+ * the exit and per vehicle class, so revenue-by-hour queries and report
+ * totals read at most 24 buckets instead of the exits.
+ * Corrections re-price only the stay they touch, apply the fee change to
+ * the revenue and record it in a journal, so the day's revenue stays exact
+ * and auditable without a re-pricing pass.
+ * With a replicator attached, every accepted change is logged as a gate
+ * event for the standby, whichever API function made it; with a change
+ * ring attached, it is also published to the change-data-capture stream.
+ *
  * @author
  * Mohamad Sakkal
  * @date 14.08.25
@@ -13,20 +40,508 @@
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "garage.h"
+#include "bloom.h"
+#include "functions.h"
+#include "plate_index.h"
+#include "alert_wheel.h"
+#include "entry_heap.h"
+#include "stay_index.h"
+#include "bay_map.h"
+#include "replication.h"
+#include "cdc.h"
+
+#define TICKET_SLOT_BITS 8
+#define TICKET_SLOT_MASK ((1u << TICKET_SLOT_BITS) - 1)
+
+_Static_assert(GARAGE_CAPACITY <= (1 << TICKET_SLOT_BITS), "record slot does not fit in a ticket");
+_Static_assert(GARAGE_CAPACITY <= ENTRY_HEAP_CAPACITY, "entry heap too small");
+_Static_assert(GARAGE_CAPACITY <= STAY_INDEX_SLOTS, "stay index too small");
 
 /**
  * @brief Initializes the garage state.
  *
- * Sets all counters (number of vehicles, total served, total revenue) to zero.
+ * Clears all vehicle records and sets all counters (number of vehicles,
+ * total served, total revenue) to zero.
  *
  * @param g Pointer to the Garage structure to initialize
  */
 void init_garage(Garage *g) {
-    g->count = 0;
-    g->total_served = 0;
-    g->total_revenue = 0.0;
+    memset(g, 0, sizeof(*g));
+}
+
+/**
+ * @brief Frees the stays archived from recycled record slots.
+ *
+ * @param g Pointer to the Garage structure
+ */
+void free_garage(Garage *g) {
+    free(g->history);
+    stay_archive_free(&g->history_stays);
+    g->history = NULL;
+    g->history_count = 0;
+    g->history_capacity = 0;
+}
+
+/**
+ * @brief Makes room in the archive for one more stay.
+ *
+ * @param g Pointer to the Garage structure
+ * @return 0 on success, -1 if the archive cannot grow
+ */
+static int reserve_history(Garage *g) {
+    if (stay_archive_reserve(&g->history_stays) != 0) return -1;
+    if (g->history_count < g->history_capacity) return 0;
+    int capacity = g->history_capacity ? g->history_capacity * 2 : GARAGE_CAPACITY;
+    Vehicle *history = realloc(g->history, sizeof(Vehicle) * (size_t)capacity);
+    if (!history) return -1;
+    g->history = history;
+    g->history_capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief Picks the record slot for a new entry.
+ *
+ * Unused slots are handed out first, so on a normal day every vehicle keeps
+ * its own record for the report. Once all slots have been used, the slot of
+ * the vehicle that exited longest ago is recycled; the caller archives its
+ * stay first so the report and exports still list it.
+ *
+ * @param g Pointer to the Garage structure
+ * @return Slot index, or -1 if no slot is available
+ */
+static int take_slot(Garage *g) {
+    if (g->count < GARAGE_CAPACITY) return g->count++;
+    if (g->free_count == 0) return -1;
+
+    int slot = g->free_slots[g->free_head];
+    g->free_head = (g->free_head + 1) % GARAGE_CAPACITY;
+    g->free_count--;
+    return slot;
+}
+
+/**
+ * @brief Remembers an exited slot so it can be recycled later.
+ *
+ * @param g Pointer to the Garage structure
+ * @param slot Slot of the vehicle that just exited
+ */
+static void release_slot(Garage *g, int slot) {
+    g->free_slots[(g->free_head + g->free_count) % GARAGE_CAPACITY] = slot;
+    g->free_count++;
+}
+
+/**
+ * @brief Looks up the indexed record of a plate that is still inside.
+ *
+ * @param g Pointer to the Garage structure
+ * @param plate License plate
+ * @param hash plate_hash(plate)
+ * @return Slot of the earliest active record for the plate, or -1
+ */
+static int find_active(const Garage *g, const char *plate, uint64_t hash) {
+    return plate_index_find(&g->active_index, g->vehicles[0].license_plate, sizeof(Vehicle), plate, hash);
+}
+
+/**
+ * @brief Re-indexes a plate after its indexed record exited.
+ *
+ * Only needed when duplicates are allowed: another record with the same
+ * plate may still be inside. The counting filter tells us whether that is
+ * possible at all before the records are scanned.
+ *
+ * @param g Pointer to the Garage structure
+ * @param plate License plate that just left
+ * @param hash plate_hash(plate)
+ */
+static void reindex_duplicate(Garage *g, const char *plate, uint64_t hash) {
+    if (!bloom_maybe_contains(&g->active_plates, hash)) return;
+
+    int earliest = -1;
+    for (int i = 0; i < g->count; ++i) {
+        const Vehicle *v = &g->vehicles[i];
+        if (v->has_exited || strcmp(v->license_plate, plate) != 0) continue;
+        if (earliest < 0 || time_to_minutes(v->entry_time) < time_to_minutes(g->vehicles[earliest].entry_time)) {
+            earliest = i;
+        }
+    }
+    if (earliest >= 0) plate_index_insert(&g->active_index, hash, earliest);
+}
+
+/**
+ * @brief Whether a record's stay ran past midnight (it exited before the time it entered).
+ */
+static int stay_overnight(const Vehicle *v) {
+    return v->has_exited && time_to_minutes(v->exit_time) < time_to_minutes(v->entry_time);
+}
+
+/**
+ * @brief Hour ranges of the day a record's stay overlaps.
+ *
+ * Vehicles inside stay until the end of the day. An overnight stay covers
+ * [entry, 24:00) and [00:00, exit), so it gets two ranges.
+ *
+ * @return Number of ranges written to first/last (1 or 2)
+ */
+static int stay_hours(const Vehicle *v, int first[2], int last[2]) {
+    first[0] = v->entry_time.hour;
+    last[0] = STAY_INDEX_HOURS - 1;
+    if (stay_overnight(v)) {
+        if (v->exit_time.hour >= first[0]) {
+            first[0] = 0; // both parts touch the entry hour: every hour
+            return 1;
+        }
+        first[1] = 0;
+        last[1] = v->exit_time.hour;
+        return 2;
+    }
+    if (v->has_exited) last[0] = v->exit_time.hour > first[0] ? v->exit_time.hour : first[0];
+    return 1;
+}
+
+static void index_stay(Garage *g, int slot) {
+    int first[2], last[2];
+    int ranges = stay_hours(&g->vehicles[slot], first, last);
+    for (int i = 0; i < ranges; ++i) stay_index_add(&g->stays, slot, first[i], last[i]);
+}
+
+static void unindex_stay(Garage *g, int slot) {
+    int first[2], last[2];
+    int ranges = stay_hours(&g->vehicles[slot], first, last);
+    for (int i = 0; i < ranges; ++i) stay_index_remove(&g->stays, slot, first[i], last[i]);
+}
+
+/**
+ * @brief Adds a record's stay to the per-minute occupancy deltas, or removes it (sign -1).
+ *
+ * A stay counts +1 at its entry minute and -1 at its exit minute. An
+ * overnight stay is [00:00, exit) plus [entry, 24:00), so it also counts
+ * +1 at minute 0.
+ */
+static void count_stay(Garage *g, const Vehicle *v, int sign) {
+    g->occupancy_delta[time_to_minutes(v->entry_time)] += sign;
+    if (!v->has_exited) return;
+    g->occupancy_delta[time_to_minutes(v->exit_time)] -= sign;
+    if (stay_overnight(v)) g->occupancy_delta[0] += sign;
+}
+
+/**
+ * @brief Moves a record's stay to the archive and lists it in the archive's hourly buckets.
+ *
+ * @param g Pointer to the Garage structure, with room reserved by reserve_history()
+ * @param v Exited record about to be recycled
+ */
+static void archive_stay(Garage *g, const Vehicle *v) {
+    int first[2], last[2];
+    int ranges = stay_hours(v, first, last);
+    for (int i = 0; i < ranges; ++i) stay_archive_add(&g->history_stays, g->history_count, first[i], last[i]);
+    g->history[g->history_count++] = *v;
+}
+
+/**
+ * @brief Whether a stay is listed in any hour's bucket from first_hour to last_hour.
+ */
+static int stay_listed_between(const Vehicle *v, int first_hour, int last_hour) {
+    int first[2], last[2];
+    int ranges = stay_hours(v, first, last);
+    for (int i = 0; i < ranges; ++i) {
+        if (first[i] <= last_hour && last[i] >= first_hour) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Ticket of the record currently held in a slot.
+ */
+static Ticket slot_ticket(const Garage *g, int slot) {
+    return (g->vehicles[slot].generation << TICKET_SLOT_BITS) | (uint32_t)slot;
+}
+
+/**
+ * @brief Hands an accepted change to the standby and the change stream, if attached.
+ *
+ * @param g Pointer to the Garage structure
+ * @param type Kind of change
+ * @param slot Record slot after the change
+ * @param before Corrected time before the change (ignored for entries and exits)
+ * @param after Entry, exit or corrected time
+ * @param fee Fee booked by an exit, fee change made by a correction, 0 otherwise
+ */
+static void publish_change(Garage *g, EventType type, int slot, Time before, Time after, int fee) {
+    const Vehicle *v = &g->vehicles[slot];
+    if (g->replica) {
+        ReplEvent re = {0};
+        re.ev.type = type;
+        strcpy(re.ev.license_plate, v->license_plate);
+        re.ev.time = after;
+        re.ev.vehicle_class = v->vehicle_class;
+        re.ticket = slot_ticket(g, slot);
+        replicator_append(g->replica, &re);
+    }
+    if (g->changes) {
+        CdcRecord rec = {0};
+        rec.op = (uint8_t)type;
+        rec.vehicle_class = v->vehicle_class;
+        rec.slot = (int16_t)slot;
+        rec.before = (int16_t)(type == EVENT_CORRECT_ENTRY || type == EVENT_CORRECT_EXIT
+                               ? time_to_minutes(before) : -1);
+        rec.after = (int16_t)time_to_minutes(after);
+        rec.fee = fee;
+        strcpy(rec.license_plate, v->license_plate);
+        cdc_ring_publish(g->changes, &rec);
+    }
+}
+
+/**
+ * @brief Adds revenue to the day's total and to its hour and class buckets.
+ *
+ * The buckets are indexed by the exit's hour and the vehicle's class, so
+ * both are checked here rather than trusted: an amount that has no valid
+ * bucket is not booked at all, and the total never disagrees with the
+ * buckets.
+ *
+ * @param g Pointer to the Garage structure
+ * @param exit Time of the exit the revenue belongs to
+ * @param cls Vehicle class
+ * @param cents Amount in cents (negative to take revenue back)
+ * @return 0 if booked, -1 if the time or class is out of range
+ */
+static int book_revenue(Garage *g, Time exit, uint8_t cls, int64_t cents) {
+    if (!time_valid(exit) || cls >= VEHICLE_CLASS_COUNT) return -1;
+    g->revenue_cents += cents;
+    g->revenue_by_hour[exit.hour] += cents;
+    g->revenue_by_class[cls] += cents;
+    return 0;
+}
+
+/**
+ * @brief Records the exit of the vehicle in a slot and books its fee.
+ *
+ * @param g Pointer to the Garage structure
+ * @param slot Slot of a vehicle that is still inside
+ * @param time Time of exit
+ * @return The calculated fee, or -1 if the time is invalid (nothing is changed)
+ */
+static int exit_slot(Garage *g, int slot, Time time) {
+    if (!time_valid(time)) return -1;
+    Vehicle *v = &g->vehicles[slot];
+    uint64_t hash = plate_hash(v->license_plate);
+
+    if (g->alerts) {
+        alert_wheel_advance(g->alerts, time_to_minutes(time));
+        alert_wheel_disarm(g->alerts, slot);
+    }
+
+    unindex_stay(g, slot);
+    count_stay(g, v, -1);
+    v->exit_time = time;
+    v->has_exited = 1;
+    index_stay(g, slot);
+    count_stay(g, v, 1);
+    if (g->bays && v->bay >= 0) bay_map_free(g->bays, v->bay);
+    g->occupied--;
+    atomic_fetch_sub_explicit(&g->class_inside[v->vehicle_class], 1, memory_order_relaxed);
+    entry_heap_remove(&g->active_by_entry, slot);
+    release_slot(g, slot);
+    bloom_remove(&g->active_plates, hash);
+    if (plate_index_remove(&g->active_index, hash, slot) && g->duplicate_policy == DUPLICATE_ALLOW) {
+        reindex_duplicate(g, v->license_plate, hash);
+    }
+
+    v->fee = calculate_fee(v->entry_time, time);
+    book_revenue(g, time, v->vehicle_class, (int64_t)v->fee * CENTS_PER_EURO);
+    publish_change(g, EVENT_EXIT, slot, time, time, v->fee);
+    return v->fee;
+}
+
+/**
+ * @brief Chooses how entries for plates that are already inside are handled.
+ *
+ * @param g Pointer to the Garage structure
+ * @param policy Reject (default), close the previous record, or allow
+ */
+void set_duplicate_policy(Garage *g, DuplicatePolicy policy) {
+    g->duplicate_policy = policy;
+}
+
+/**
+ * @brief Reads a per-class counter.
+ */
+static int inside_of(const Garage *g, int cls) {
+    return atomic_load_explicit((atomic_int *)&g->class_inside[cls], memory_order_relaxed);
+}
+
+/**
+ * @brief Spots and occupancy of the general pool shared by classes without reserved spots.
+ */
+static void general_pool(const Garage *g, int *capacity, int *inside) {
+    *capacity = GARAGE_CAPACITY;
+    *inside = 0;
+    for (int c = 0; c < VEHICLE_CLASS_COUNT; ++c) {
+        *capacity -= g->class_capacity[c];
+        if (g->class_capacity[c] == 0) *inside += inside_of(g, c);
+    }
+}
+
+/**
+ * @brief Whether two classes draw on the same spots (the same reservation or both the general pool).
+ */
+static int same_pool(const Garage *g, int a, int b) {
+    return a == b || (g->class_capacity[a] == 0 && g->class_capacity[b] == 0);
+}
+
+/**
+ * @brief Free spots available to a class.
+ *
+ * @param g Pointer to the Garage structure
+ * @param cls Vehicle class
+ * @return Its reserved spots left, or the general pool's free spots
+ */
+int class_free_spots(const Garage *g, VehicleClass cls) {
+    if ((unsigned)cls >= VEHICLE_CLASS_COUNT) return 0;
+    if (g->class_capacity[cls] > 0) {
+        int left = g->class_capacity[cls] - inside_of(g, cls);
+        return left > 0 ? left : 0;
+    }
+    int capacity, inside;
+    general_pool(g, &capacity, &inside);
+    return capacity > inside ? capacity - inside : 0;
+}
+
+/**
+ * @brief Number of vehicles of a class inside.
+ *
+ * @param g Pointer to the Garage structure
+ * @param cls Vehicle class
+ * @return Vehicles of the class inside
+ */
+int class_occupancy(const Garage *g, VehicleClass cls) {
+    if ((unsigned)cls >= VEHICLE_CLASS_COUNT) return 0;
+    return inside_of(g, cls);
+}
+
+/**
+ * @brief Reserves spots for a vehicle class.
+ *
+ * @param g Pointer to the Garage structure
+ * @param cls Vehicle class other than CLASS_STANDARD
+ * @param spots Reserved spots, 0 for the general pool
+ * @return 0 on success, -1 if invalid
+ */
+int set_class_quota(Garage *g, VehicleClass cls, int spots) {
+    if (cls == CLASS_STANDARD || (unsigned)cls >= VEHICLE_CLASS_COUNT || spots < 0) return -1;
+
+    int reserved = spots;
+    for (int c = 0; c < VEHICLE_CLASS_COUNT; ++c) {
+        if (c != (int)cls) reserved += g->class_capacity[c];
+    }
+    if (reserved > GARAGE_CAPACITY) return -1;
+    g->class_capacity[cls] = spots;
+    return 0;
+}
+
+/**
+ * @brief Registers a new vehicle entry of a given class and issues a ticket.
+ *
+ * The active-plate index is consulted first, so a plate that is already
+ * inside is detected in constant time and handled according to the
+ * garage's duplicate policy.
+ *
+ * @param g Pointer to the Garage structure
+ * @param plate License plate of the vehicle
+ * @param time Time of entry
+ * @param cls Vehicle class
+ * @param ticket Receives the ticket handle; may be NULL
+ * @return 0 if the vehicle was successfully registered, -1 if the time is invalid or the garage
+ *         or the class's spots are full, -2 if the plate is already inside and duplicates are rejected
+ */
+int register_entry_class(Garage *g, const char *plate, Time time, VehicleClass cls, Ticket *ticket) {
+    if (!time_valid(time)) return -1;
+    uint64_t hash = plate_hash(plate);
+    if (g->alerts) alert_wheel_advance(g->alerts, time_to_minutes(time));
+
+    int previous = find_active(g, plate, hash);
+    if (previous >= 0) {
+        g->counters.duplicate_entries++;
+        if (g->duplicate_policy == DUPLICATE_REJECT) return -2;
+    }
+
+    // the previous record is only closed once the new entry is certain to be
+    // admitted, counting the spot and bay it will free
+    int closing = previous >= 0 && g->duplicate_policy == DUPLICATE_CLOSE_PREVIOUS;
+    const Vehicle *prev = closing ? &g->vehicles[previous] : NULL;
+    if ((unsigned)cls >= VEHICLE_CLASS_COUNT) cls = CLASS_STANDARD;
+    if (g->occupied - closing >= GARAGE_CAPACITY) return -1;
+    if (class_free_spots(g, cls) + (prev && same_pool(g, prev->vehicle_class, cls)) == 0) return -1;
+    int bay = -1;
+    if (g->bays && (bay = bay_map_alloc(g->bays)) < 0 && !(prev && prev->bay >= 0)) return -1;
+
+    int recycled = g->count >= GARAGE_CAPACITY;
+    if (recycled && reserve_history(g) != 0) {
+        if (bay >= 0) bay_map_free(g->bays, bay);
+        return -1;
+    }
+    if (closing) {
+        exit_slot(g, previous, time);
+        if (g->bays && bay < 0) bay = bay_map_alloc(g->bays);
+    }
+
+    int slot = take_slot(g);
+    if (slot < 0) {
+        if (bay >= 0) bay_map_free(g->bays, bay);
+        return -1;
+    }
+
+    Vehicle *v = &g->vehicles[slot];
+    if (recycled) {
+        archive_stay(g, v);
+        bloom_remove(&g->recorded_plates, plate_hash(v->license_plate));
+        unindex_stay(g, slot);
+    }
+
+    bloom_add(&g->recorded_plates, hash);
+    bloom_add(&g->active_plates, hash);
+
+    strcpy(v->license_plate, plate);
+    v->entry_time = time;
+    v->has_exited = 0;
+    v->bay = bay;
+    v->vehicle_class = (uint8_t)cls;
+    v->fee = 0;
+    v->generation = (v->generation + 1) & (UINT32_MAX >> TICKET_SLOT_BITS);
+    if (v->generation == 0) v->generation = 1; // 0 would make TICKET_INVALID reachable
+
+    if (previous < 0 || g->duplicate_policy != DUPLICATE_ALLOW) {
+        plate_index_insert(&g->active_index, hash, slot);
+    }
+    index_stay(g, slot);
+    count_stay(g, v, 1);
+
+    g->occupied++;
+    g->total_served++;
+    atomic_fetch_add_explicit(&g->class_inside[cls], 1, memory_order_relaxed);
+    entry_heap_set(&g->active_by_entry, slot, time_to_minutes(time));
+    if (g->alerts) alert_wheel_arm(g->alerts, slot);
+    if (ticket) *ticket = slot_ticket(g, slot);
+    publish_change(g, EVENT_ENTRY, slot, time, time, 0);
+    return 0;
+}
+
+/**
+ * @brief Registers a new vehicle entry and issues a ticket.
+ *
+ * @param g Pointer to the Garage structure
+ * @param plate License plate of the vehicle
+ * @param time Time of entry
+ * @param ticket Receives the ticket handle; may be NULL
+ * @return 0 if the vehicle was successfully registered, -1 if the garage is full,
+ *         -2 if the plate is already inside and duplicates are rejected
+ */
+int register_entry_ticket(Garage *g, const char *plate, Time time, Ticket *ticket) {
+    return register_entry_class(g, plate, time, CLASS_STANDARD, ticket);
 }
 
 /**
@@ -37,69 +552,197 @@ void init_garage(Garage *g) {
  * @param g Pointer to the Garage structure
  * @param plate License plate of the vehicle
  * @param time Time of entry
- * @return 0 if the vehicle was successfully registered, -1 if the garage is full
+ * @return 0 if the vehicle was successfully registered, -1 if the garage is full,
+ *         -2 if the plate is already inside and duplicates are rejected
  */
 int register_entry(Garage *g, const char *plate, Time time) {
-    if (g->count >= 100) return -1;
+    return register_entry_ticket(g, plate, time, NULL);
+}
 
-    strcpy(g->vehicles[g->count].license_plate, plate);
-    g->vehicles[g->count].entry_time = time;
-    g->vehicles[g->count].has_exited = 0;
-    g->count++;
-    g->total_served++;
-    return 0;
+/**
+ * @brief Counts a plate lookup and checks it against a Bloom filter.
+ *
+ * @param g Pointer to the Garage structure
+ * @param filter Filter to consult
+ * @param hash plate_hash() of the plate being searched for
+ * @return 1 if the plate is definitely absent, 0 if it must be looked up
+ */
+static int plate_rejected(Garage *g, const CountingBloom *filter, uint64_t hash) {
+    g->counters.plate_lookups++;
+    if (bloom_maybe_contains(filter, hash)) return 0;
+    g->counters.bloom_rejects++;
+    return 1;
+}
+
+/**
+ * @brief Resolves a ticket to its record slot.
+ *
+ * @param g Pointer to the Garage structure
+ * @param ticket Ticket handle
+ * @return Slot index, or -1 if the ticket is malformed or its slot was reused
+ */
+static int ticket_slot(const Garage *g, Ticket ticket) {
+    int slot = (int)(ticket & TICKET_SLOT_MASK);
+    if (ticket == TICKET_INVALID || slot >= g->count) return -1;
+    if (g->vehicles[slot].generation != ticket >> TICKET_SLOT_BITS) return -1;
+    return slot;
 }
 
 /**
  * @brief Logs the exit of a vehicle and calculates the parking fee.
  *
- * Searches for the vehicle using its license plate and records the exit time.
- * The fee is calculated as 2 euros per hour (rounded up).
+ * Finds the vehicle through the active-plate index and records the exit time.
+ * The fee is calculated as 2 euros per hour (rounded up). Used for lost
+ * tickets; log_exit_by_ticket() does not need the plate at all.
  *
  * @param g Pointer to the Garage structure
  * @param plate License plate of the vehicle
  * @param time Time of exit
- * @return The calculated fee if successful, -1 if the vehicle is not found or already exited
+ * @return The calculated fee if successful, -1 if the time is invalid or the vehicle is not found or already exited
  */
 int log_exit(Garage *g, const char *plate, Time time) {
-    for (int i = 0; i < g->count; ++i) {
-        if (strcmp(g->vehicles[i].license_plate, plate) == 0 && g->vehicles[i].has_exited == 0) {
-            g->vehicles[i].exit_time = time;
-            g->vehicles[i].has_exited = 1;
-
-            int hours = time.hour - g->vehicles[i].entry_time.hour;
-            if (time.minute > g->vehicles[i].entry_time.minute) hours++;
-            g->total_revenue += hours * 2;
-            return hours * 2;
-        }
+    if (!time_valid(time)) return -1;
+    uint64_t hash = plate_hash(plate);
+    if (plate_rejected(g, &g->active_plates, hash)) return -1;
+
+    int slot = find_active(g, plate, hash);
+    if (slot < 0) {
+        g->counters.bloom_false_positives++;
+        return -1;
     }
-    return -1;
+    return exit_slot(g, slot, time);
+}
+
+/**
+ * @brief Logs the exit of a vehicle using its ticket.
+ *
+ * Goes straight to the ticket's record slot. Tickets whose slot has since
+ * been reused by another vehicle are rejected.
+ *
+ * @param g Pointer to the Garage structure
+ * @param ticket Ticket handle issued by register_entry_ticket()
+ * @param time Time of exit
+ * @return The calculated fee if successful, -1 if the time or the ticket is invalid, or the ticket is stale or already used
+ */
+int log_exit_by_ticket(Garage *g, Ticket ticket, Time time) {
+    int slot = ticket_slot(g, ticket);
+    if (slot < 0 || g->vehicles[slot].has_exited || !time_valid(time)) return -1;
+    return exit_slot(g, slot, time);
+}
+
+/**
+ * @brief Initializes a filter that selects vehicles by state only.
+ *
+ * @param filter Filter to initialize
+ * @param state Vehicles to select (all, active or exited)
+ */
+void vehicle_filter_init(VehicleFilter *filter, VehicleState state) {
+    filter->state = state;
+    filter->entered_before = -1;
+    filter->match = NULL;
+    filter->match_ctx = NULL;
+}
+
+/**
+ * @brief Starts iterating over the vehicles matching a filter.
+ *
+ * @param it Iterator to initialize
+ * @param g Pointer to the Garage structure
+ * @param filter Selection criteria, or NULL to select every vehicle
+ */
+void vehicle_iter_init(VehicleIterator *it, const Garage *g, const VehicleFilter *filter) {
+    it->garage = g;
+    if (filter) it->filter = *filter;
+    else vehicle_filter_init(&it->filter, VEHICLES_ALL);
+    // archived stays have all exited
+    it->next = it->filter.state == VEHICLES_ACTIVE ? g->history_count : 0;
+}
+
+/**
+ * @brief Returns the next vehicle matching the iterator's filter.
+ *
+ * The stays archived from recycled slots come first, then the records in
+ * slot order, as pointers into the garage, so no record is copied.
+ *
+ * @param it Iterator
+ * @return Pointer to the next matching vehicle, or NULL when there are no more
+ */
+const Vehicle *vehicle_iter_next(VehicleIterator *it) {
+    const VehicleFilter *f = &it->filter;
+
+    const Garage *g = it->garage;
+
+    while (it->next < g->history_count + g->count) {
+        int i = it->next++;
+        const Vehicle *v = i < g->history_count ? &g->history[i] : &g->vehicles[i - g->history_count];
+
+        if (f->state == VEHICLES_ACTIVE && v->has_exited) continue;
+        if (f->state == VEHICLES_EXITED && !v->has_exited) continue;
+        if (f->entered_before >= 0 && time_to_minutes(v->entry_time) >= f->entered_before) continue;
+        if (f->match && !f->match(v, f->match_ctx)) continue;
+        return v;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Calls a visitor for every vehicle matching a filter.
+ *
+ * @param g Pointer to the Garage structure
+ * @param filter Selection criteria, or NULL to select every vehicle
+ * @param visit Visitor callback; returning non-zero stops the iteration
+ * @param ctx Context passed to the visitor
+ * @return Number of vehicles visited
+ */
+int garage_for_each(const Garage *g, const VehicleFilter *filter, VehicleVisitor visit, void *ctx) {
+    VehicleIterator it;
+    const Vehicle *v;
+    int visited = 0;
+
+    vehicle_iter_init(&it, g, filter);
+    while ((v = vehicle_iter_next(&it)) != NULL) {
+        visited++;
+        if (visit(v, ctx) != 0) break;
+    }
+    return visited;
+}
+
+static int print_parked_vehicle(const Vehicle *v, void *ctx) {
+    (void)ctx;
+    printf(" - %s (entered at %02d:%02d)\n",
+           v->license_plate, v->entry_time.hour, v->entry_time.minute);
+    return 0;
+}
+
+static int print_plate(const Vehicle *v, void *ctx) {
+    (void)ctx;
+    printf(" - %s\n", v->license_plate);
+    return 0;
 }
 
 /**
  * @brief Prints a list of all vehicles currently in the garage.
  *
- * Iterates through all vehicles and prints the ones that have not exited.
+ * Visits all vehicles that have not exited and prints them.
  * Also shows a summary of the number of cars inside and remaining spots.
  *
  * @param g Pointer to the Garage structure
  */
 void print_occupancy(const Garage *g) {
-    int current_inside = 0;
+    VehicleFilter active;
+    vehicle_filter_init(&active, VEHICLES_ACTIVE);
 
     printf("Current Occupancy:\n");
-    for (int i = 0; i < g->count; ++i) {
-        if (!g->vehicles[i].has_exited) {
-            printf(" - %s (entered at %02d:%02d)\n",
-                   g->vehicles[i].license_plate,
-                   g->vehicles[i].entry_time.hour,
-                   g->vehicles[i].entry_time.minute);
-            current_inside++;
-        }
-    }
+    int current_inside = garage_for_each(g, &active, print_parked_vehicle, NULL);
 
-    int spots_left = 100 - current_inside;
+    int spots_left = GARAGE_CAPACITY - current_inside;
     printf("\n  %d cars currently parked, %d spots left.\n", current_inside, spots_left);
+
+    for (int c = 0; c < VEHICLE_CLASS_COUNT; ++c) {
+        if (g->class_capacity[c] == 0) continue;
+        printf("  %s: %d inside, %d of %d reserved spots left.\n", vehicle_class_name((VehicleClass)c),
+               inside_of(g, c), class_free_spots(g, (VehicleClass)c), g->class_capacity[c]);
+    }
 }
 
 /**
@@ -110,12 +753,187 @@ void print_occupancy(const Garage *g) {
  * @param g Pointer to the Garage structure
  */
 void list_unexited(const Garage *g) {
+    VehicleFilter active;
+    vehicle_filter_init(&active, VEHICLES_ACTIVE);
+
     printf("Vehicles still inside at closing time:\n");
-    for (int i = 0; i < g->count; ++i) {
-        if (!g->vehicles[i].has_exited) {
-            printf(" - %s\n", g->vehicles[i].license_plate);
-        }
+    garage_for_each(g, &active, print_plate, NULL);
+}
+
+/**
+ * @brief Calculates the fee for a stay.
+ *
+ * The fee is 2 euros per started hour of calculate_duration(), so a stay
+ * whose exit is earlier on the clock than its entry ran past midnight and
+ * is never priced negative.
+ *
+ * @param entry Entry time
+ * @param exit Exit time
+ * @return Fee in euros (0 or more)
+ */
+int calculate_fee(Time entry, Time exit) {
+    return calculate_duration(entry, exit) * 2;
+}
+
+/**
+ * @brief Checks whether a correction would put an exit before its entry.
+ *
+ * Stays that were logged past midnight (exit earlier on the clock than the
+ * entry) remain overnight stays; any other stay must keep its exit at or
+ * after its entry.
+ *
+ * @param v Record being corrected
+ * @param entry Entry time after the correction
+ * @param exit Exit time after the correction
+ * @return 1 if the correction must be rejected, 0 otherwise
+ */
+static int correction_reverses_stay(const Vehicle *v, Time entry, Time exit) {
+    if (!v->has_exited) return 0;
+    return !stay_overnight(v) && time_to_minutes(exit) < time_to_minutes(entry);
+}
+
+/**
+ * @brief Re-prices a corrected record and journals the correction.
+ *
+ * Only the corrected stay is priced again: its old fee is taken out of the
+ * revenue buckets it was booked to and the new fee booked to the buckets of
+ * its (possibly corrected) exit, so corrections never need a pass over the
+ * records.
+ *
+ * @param g Pointer to the Garage structure
+ * @param type EVENT_CORRECT_ENTRY or EVENT_CORRECT_EXIT
+ * @param slot Record slot, already holding the corrected time
+ * @param old_time Time before the correction
+ * @param new_time Corrected time
+ * @return Fee change (0 for vehicles still inside)
+ */
+static int reprice_correction(Garage *g, EventType type, int slot, Time old_time, Time new_time) {
+    Vehicle *v = &g->vehicles[slot];
+    int old_fee = v->fee;
+    if (v->has_exited) {
+        Time old_exit = type == EVENT_CORRECT_EXIT ? old_time : v->exit_time;
+        book_revenue(g, old_exit, v->vehicle_class, -(int64_t)old_fee * CENTS_PER_EURO);
+        v->fee = calculate_fee(v->entry_time, v->exit_time);
+        book_revenue(g, v->exit_time, v->vehicle_class, (int64_t)v->fee * CENTS_PER_EURO);
     }
+    int delta = v->fee - old_fee;
+
+    CorrectionJournal *j = &g->corrections;
+    Correction *c;
+    if (j->count < CORRECTION_JOURNAL_CAPACITY) {
+        c = &j->entries[(j->head + j->count++) % CORRECTION_JOURNAL_CAPACITY];
+    } else {
+        c = &j->entries[j->head];
+        j->head = (j->head + 1) % CORRECTION_JOURNAL_CAPACITY;
+    }
+    strcpy(c->license_plate, v->license_plate);
+    c->type = (uint8_t)type;
+    c->slot = (int16_t)slot;
+    c->old_time = old_time;
+    c->new_time = new_time;
+    c->old_fee = old_fee;
+    c->new_fee = v->fee;
+    j->total++;
+    j->fee_delta_cents += (int64_t)delta * CENTS_PER_EURO;
+    return delta;
+}
+
+/**
+ * @brief Copies the correction journal, oldest first.
+ *
+ * @param g Pointer to the Garage structure
+ * @param out Receives up to max corrections
+ * @param max Capacity of out
+ * @return Number of corrections copied
+ */
+int garage_corrections(const Garage *g, Correction *out, int max) {
+    const CorrectionJournal *j = &g->corrections;
+    int n = j->count < max ? j->count : max;
+    for (int i = 0; i < n; ++i) {
+        out[i] = j->entries[(j->head + i) % CORRECTION_JOURNAL_CAPACITY];
+    }
+    return n;
+}
+
+/**
+ * @brief Breaks the day's revenue down into booked fees and correction adjustments.
+ *
+ * @param g Pointer to the Garage structure
+ * @param audit Output breakdown
+ */
+void garage_revenue_audit(const Garage *g, RevenueAudit *audit) {
+    audit->total_cents = g->revenue_cents;
+    audit->adjustment_cents = g->corrections.fee_delta_cents;
+    audit->booked_cents = g->revenue_cents - g->corrections.fee_delta_cents;
+    audit->corrections = g->corrections.total;
+}
+
+/**
+ * @brief Sums the revenue of the exits in a range of hours.
+ *
+ * Reads the hourly buckets only, so it costs at most 24 additions however
+ * many vehicles exited.
+ *
+ * @param g Pointer to the Garage structure
+ * @param from_hour First hour (0-23)
+ * @param to_hour Hour after the last one (1-24)
+ * @return Revenue in cents
+ */
+int64_t garage_revenue_between(const Garage *g, int from_hour, int to_hour) {
+    if (from_hour < 0) from_hour = 0;
+    if (to_hour > HOURS_PER_DAY) to_hour = HOURS_PER_DAY;
+    int64_t cents = 0;
+    for (int h = from_hour; h < to_hour; ++h) cents += g->revenue_by_hour[h];
+    return cents;
+}
+
+/**
+ * @brief Corrects the entry time of a record and updates the indexes.
+ *
+ * Exited vehicles are re-priced; vehicles still inside are re-keyed in the
+ * entry-time heap and get their alert timer re-armed.
+ *
+ * @param g Pointer to the Garage structure
+ * @param slot Record slot
+ * @param new_time Corrected entry time
+ * @return 0 if corrected, -1 if the entry would come after the exit
+ */
+static int set_entry_time(Garage *g, int slot, Time new_time) {
+    Time old_time = g->vehicles[slot].entry_time;
+    if (correction_reverses_stay(&g->vehicles[slot], new_time, g->vehicles[slot].exit_time)) return -1;
+    unindex_stay(g, slot);
+    count_stay(g, &g->vehicles[slot], -1);
+    g->vehicles[slot].entry_time = new_time;
+    index_stay(g, slot);
+    count_stay(g, &g->vehicles[slot], 1);
+    int delta = reprice_correction(g, EVENT_CORRECT_ENTRY, slot, old_time, new_time);
+    publish_change(g, EVENT_CORRECT_ENTRY, slot, old_time, new_time, delta);
+    if (g->vehicles[slot].has_exited) return 0;
+
+    entry_heap_set(&g->active_by_entry, slot, time_to_minutes(new_time));
+    if (g->alerts) alert_wheel_arm(g->alerts, slot);
+    return 0;
+}
+
+/**
+ * @brief Corrects the exit time of an exited record, re-prices it and updates the stay index.
+ *
+ * @param g Pointer to the Garage structure
+ * @param slot Record slot of an exited vehicle
+ * @param new_time Corrected exit time
+ * @return 0 if corrected, -1 if the exit would come before the entry
+ */
+static int set_exit_time(Garage *g, int slot, Time new_time) {
+    Time old_time = g->vehicles[slot].exit_time;
+    if (correction_reverses_stay(&g->vehicles[slot], g->vehicles[slot].entry_time, new_time)) return -1;
+    unindex_stay(g, slot);
+    count_stay(g, &g->vehicles[slot], -1);
+    g->vehicles[slot].exit_time = new_time;
+    index_stay(g, slot);
+    count_stay(g, &g->vehicles[slot], 1);
+    int delta = reprice_correction(g, EVENT_CORRECT_EXIT, slot, old_time, new_time);
+    publish_change(g, EVENT_CORRECT_EXIT, slot, old_time, new_time, delta);
+    return 0;
 }
 
 /**
@@ -126,15 +944,19 @@ void list_unexited(const Garage *g) {
  * @param g Pointer to the Garage structure
  * @param plate License plate of the vehicle
  * @param new_time Corrected entry time
- * @return 0 if successful, -1 if vehicle was not found
+ * @return 0 if successful, -1 if the time is invalid, the vehicle was not found or the entry
+ *         would come after the exit
  */
 int update_entry_time(Garage *g, const char *plate, Time new_time) {
+    if (!time_valid(new_time)) return -1;
+    if (plate_rejected(g, &g->recorded_plates, plate_hash(plate))) return -1;
+
     for (int i = 0; i < g->count; ++i) {
         if (strcmp(g->vehicles[i].license_plate, plate) == 0) {
-            g->vehicles[i].entry_time = new_time;
-            return 0;
+            return set_entry_time(g, i, new_time);
         }
     }
+    g->counters.bloom_false_positives++;
     return -1;
 }
 
@@ -146,14 +968,346 @@ int update_entry_time(Garage *g, const char *plate, Time new_time) {
  * @param g Pointer to the Garage structure
  * @param plate License plate of the vehicle
  * @param new_time Corrected exit time
- * @return 0 if successful, -1 if vehicle is not found or has not exited yet
+ * @return 0 if successful, -1 if the time is invalid, the vehicle is not found or has not exited yet,
+ *         or the exit would come before the entry
  */
 int update_exit_time(Garage *g, const char *plate, Time new_time) {
+    if (!time_valid(new_time)) return -1;
+    if (plate_rejected(g, &g->recorded_plates, plate_hash(plate))) return -1;
+
+    int seen = 0;
     for (int i = 0; i < g->count; ++i) {
-        if (strcmp(g->vehicles[i].license_plate, plate) == 0 && g->vehicles[i].has_exited) {
-            g->vehicles[i].exit_time = new_time;
-            return 0;
+        if (strcmp(g->vehicles[i].license_plate, plate) == 0) {
+            seen = 1;
+            if (!g->vehicles[i].has_exited) continue;
+            return set_exit_time(g, i, new_time);
         }
     }
+    if (!seen) g->counters.bloom_false_positives++;
     return -1;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Updates the entry time of the vehicle holding a ticket.
+ *
+ * @param g Pointer to the Garage structure
+ * @param ticket Ticket handle
+ * @param new_time Corrected entry time
+ * @return 0 if successful, -1 if the time or the ticket is invalid, or the ticket is stale
+ */
+int update_entry_time_by_ticket(Garage *g, Ticket ticket, Time new_time) {
+    int slot = ticket_slot(g, ticket);
+    if (slot < 0 || !time_valid(new_time)) return -1;
+    return set_entry_time(g, slot, new_time);
+}
+
+/**
+ * @brief Updates the exit time of the vehicle holding a ticket.
+ *
+ * @param g Pointer to the Garage structure
+ * @param ticket Ticket handle
+ * @param new_time Corrected exit time
+ * @return 0 if successful, -1 if the time or the ticket is invalid, the ticket is stale or the vehicle has not exited yet
+ */
+int update_exit_time_by_ticket(Garage *g, Ticket ticket, Time new_time) {
+    int slot = ticket_slot(g, ticket);
+    if (slot < 0 || !g->vehicles[slot].has_exited || !time_valid(new_time)) return -1;
+    return set_exit_time(g, slot, new_time);
+}
+
+/**
+ * @brief Looks up the vehicle holding a ticket.
+ *
+ * @param g Pointer to the Garage structure
+ * @param ticket Ticket handle
+ * @return Vehicle record, or NULL if the ticket is invalid or stale
+ */
+const Vehicle *find_vehicle_by_ticket(const Garage *g, Ticket ticket) {
+    int slot = ticket_slot(g, ticket);
+    return slot < 0 ? NULL : &g->vehicles[slot];
+}
+
+/**
+ * @brief Formats a ticket as a fixed-width ticket number.
+ *
+ * @param ticket Ticket handle
+ * @param buf Output buffer
+ * @param size Size of buf (11 bytes hold the full number)
+ */
+void format_ticket(Ticket ticket, char *buf, size_t size) {
+    snprintf(buf, size, "%010u", (unsigned)ticket);
+}
+
+/**
+ * @brief Parses a ticket number printed by format_ticket().
+ *
+ * @param str Ticket number
+ * @return Ticket handle, or TICKET_INVALID if the string is not a ticket number
+ */
+Ticket parse_ticket(const char *str) {
+    unsigned long value = 0;
+    int digits = 0;
+    for (; *str >= '0' && *str <= '9'; ++str, ++digits) {
+        value = value * 10 + (unsigned long)(*str - '0');
+        if (value > UINT32_MAX) return TICKET_INVALID;
+    }
+    if (digits == 0 || *str != '\0') return TICKET_INVALID;
+    return (Ticket)value;
+}
+
+/**
+ * @brief Reports lookup statistics.
+ *
+ * The false-positive rate is measured, not estimated: it is the share of
+ * lookups for absent plates that the Bloom filter failed to reject.
+ *
+ * @param g Pointer to the Garage structure
+ * @param stats Output statistics
+ */
+void get_garage_stats(const Garage *g, GarageStats *stats) {
+    stats->plate_lookups = g->counters.plate_lookups;
+    stats->bloom_rejects = g->counters.bloom_rejects;
+    stats->bloom_false_positives = g->counters.bloom_false_positives;
+
+    long absent = g->counters.bloom_rejects + g->counters.bloom_false_positives;
+    stats->bloom_false_positive_rate = absent > 0 ? (double)g->counters.bloom_false_positives / absent : 0.0;
+    stats->duplicate_entries = g->counters.duplicate_entries;
+}
+
+/**
+ * @brief Returns the number of vehicles currently inside the garage.
+ *
+ * Maintained by entries and exits, so no scan is needed.
+ *
+ * @param g Pointer to the Garage structure
+ * @return Number of vehicles that have not exited yet
+ */
+int current_occupancy(const Garage *g) {
+    return g->occupied;
+}
+
+/**
+ * @brief Lists the vehicles that have been inside the longest.
+ *
+ * @param g Pointer to the Garage structure
+ * @param k Number of vehicles wanted
+ * @param out Receives up to k vehicles, earliest entry first
+ * @return Number of vehicles written
+ */
+int garage_longest_parked(const Garage *g, int k, const Vehicle **out) {
+    int slots[GARAGE_CAPACITY];
+    if (k > GARAGE_CAPACITY) k = GARAGE_CAPACITY;
+    int n = entry_heap_oldest(&g->active_by_entry, k, slots);
+    for (int i = 0; i < n; ++i) out[i] = &g->vehicles[slots[i]];
+    return n;
+}
+
+/**
+ * @brief Lists the vehicles still inside that entered before a time.
+ *
+ * @param g Pointer to the Garage structure
+ * @param t Exclusive upper bound on the entry time
+ * @param out Receives the vehicles
+ * @param max Capacity of out
+ * @return Number of vehicles written
+ */
+int garage_active_entered_before(const Garage *g, Time t, const Vehicle **out, int max) {
+    int slots[GARAGE_CAPACITY];
+    if (max > GARAGE_CAPACITY) max = GARAGE_CAPACITY;
+    int n = entry_heap_before(&g->active_by_entry, time_to_minutes(t), slots, max);
+    for (int i = 0; i < n; ++i) out[i] = &g->vehicles[slots[i]];
+    return n;
+}
+
+/**
+ * @brief Checks whether a record's stay overlaps [from, to] (minutes).
+ *
+ * An overnight stay is [entry, 24:00) plus [00:00, exit).
+ */
+static int stay_overlaps(const Vehicle *v, int from, int to) {
+    int entry = time_to_minutes(v->entry_time);
+    if (stay_overnight(v)) return entry <= to || time_to_minutes(v->exit_time) > from;
+    if (entry > to) return 0;
+    return !v->has_exited || time_to_minutes(v->exit_time) > from;
+}
+
+/**
+ * @brief Lists the recorded vehicles whose stay overlaps [from, to] (minutes).
+ *
+ * Archived stays are taken from the hourly lists of the range. A stay
+ * listed in several of those hours is checked in the earliest one only.
+ */
+static int collect_stays(const Garage *g, int from, int to, const Vehicle **out, int max) {
+    const StayArchiveIndex *archive = &g->history_stays;
+    int n = 0;
+    for (int h = from / 60; h <= to / 60; ++h) {
+        for (int k = 0; k < archive->count[h] && n < max; ++k) {
+            const Vehicle *v = &g->history[archive->stays[h][k]];
+            if (h > from / 60 && stay_listed_between(v, from / 60, h - 1)) continue; // already checked
+            if (stay_overlaps(v, from, to)) out[n++] = v;
+        }
+    }
+
+    StaySet candidates;
+    stay_index_candidates(&g->stays, from / 60, to / 60, &candidates);
+
+    int slot;
+    while (n < max && (slot = stay_set_pop(&candidates)) >= 0) {
+        if (stay_overlaps(&g->vehicles[slot], from, to)) out[n++] = &g->vehicles[slot];
+    }
+    return n;
+}
+
+/**
+ * @brief Lists the recorded vehicles that were inside at a time.
+ *
+ * @param g Pointer to the Garage structure
+ * @param t Time
+ * @param out Receives the vehicles
+ * @param max Capacity of out
+ * @return Number of vehicles written
+ */
+int garage_inside_at(const Garage *g, Time t, const Vehicle **out, int max) {
+    int m = time_to_minutes(t);
+    return collect_stays(g, m, m, out, max);
+}
+
+/**
+ * @brief Lists the recorded vehicles that were inside at any time in a range.
+ *
+ * @param g Pointer to the Garage structure
+ * @param from Start of the range
+ * @param to End of the range (inclusive)
+ * @param out Receives the vehicles
+ * @param max Capacity of out
+ * @return Number of vehicles written
+ */
+int garage_inside_between(const Garage *g, Time from, Time to, const Vehicle **out, int max) {
+    return collect_stays(g, time_to_minutes(from), time_to_minutes(to), out, max);
+}
+
+/**
+ * @brief Computes the per-minute occupancy of the day.
+ *
+ * The difference array holds +1 at every entry minute and -1 at every exit
+ * minute, plus +1 at minute 0 for every overnight stay, so its prefix sum is
+ * the number of vehicles inside during each minute. It is kept up to date by entries, exits and corrections and also
+ * covers records that have since been recycled.
+ *
+ * @param g Pointer to the Garage structure
+ * @param curve Receives MINUTES_PER_DAY values
+ * @param peak Receives the peak (may be NULL)
+ */
+void garage_occupancy_curve(const Garage *g, int *curve, OccupancyPeak *peak) {
+    int inside = 0;
+    for (int m = 0; m < MINUTES_PER_DAY; ++m) {
+        inside += g->occupancy_delta[m];
+        curve[m] = inside;
+    }
+    if (!peak) return;
+
+    int best = 0;
+    for (int m = 1; m < MINUTES_PER_DAY; ++m) {
+        if (curve[m] > curve[best]) best = m;
+    }
+    peak->occupied = curve[best];
+    peak->time.hour = best / 60;
+    peak->time.minute = best % 60;
+}
+
+/**
+ * @brief Attaches an alert wheel and arms the vehicles already inside.
+ *
+ * @param g Pointer to the Garage structure
+ * @param w Alert wheel, or NULL to detach
+ */
+void garage_set_alerts(Garage *g, AlertWheel *w) {
+    g->alerts = w;
+    if (!w) return;
+    w->garage = g;
+    for (int i = 0; i < g->count; ++i) {
+        if (!g->vehicles[i].has_exited) alert_wheel_arm(w, i);
+    }
+}
+
+/**
+ * @brief Attaches a bay map and assigns bays to the vehicles already inside.
+ *
+ * The bays those vehicles held in the previous map are freed first, so a
+ * map that is detached or replaced can be attached again later.
+ *
+ * @param g Pointer to the Garage structure
+ * @param m Bay map, or NULL to detach
+ */
+void garage_set_bays(Garage *g, BayMap *m) {
+    for (int i = 0; i < g->count; ++i) {
+        Vehicle *v = &g->vehicles[i];
+        if (v->has_exited) continue;
+        if (g->bays && v->bay >= 0) bay_map_free(g->bays, v->bay);
+        v->bay = -1;
+    }
+    g->bays = m;
+    if (!m) return;
+    for (int i = 0; i < g->count; ++i) {
+        Vehicle *v = &g->vehicles[i];
+        if (!v->has_exited) v->bay = bay_map_alloc(m);
+    }
+}
+
+/**
+ * @brief Attaches a replicator for log shipping to a standby.
+ *
+ * Vehicles already inside are not shipped; attach the replicator before
+ * the first event of the day.
+ *
+ * @param g Pointer to the Garage structure
+ * @param r Replicator, or NULL to detach
+ */
+void garage_set_replicator(Garage *g, Replicator *r) {
+    g->replica = r;
+}
+
+/**
+ * @brief Attaches a change-data-capture ring.
+ *
+ * @param g Pointer to the Garage structure
+ * @param r Ring, or NULL to detach
+ */
+void garage_set_changes(Garage *g, CdcRing *r) {
+    g->changes = r;
+}
+
+/**
+ * @brief Advances the alert clock without a gate event.
+ *
+ * @param g Pointer to the Garage structure
+ * @param now Current time
+ */
+void garage_advance_clock(Garage *g, Time now) {
+    if (g->alerts && time_valid(now)) alert_wheel_advance(g->alerts, time_to_minutes(now));
+}
+
+/**
+ * @brief Applies a single gate event to the garage.
+ *
+ * Dispatches the event to register_entry(), log_exit(), update_entry_time()
+ * or update_exit_time() depending on its type. Used by front-ends that
+ * receive events from gate controllers instead of the attendant menu.
+ *
+ * @param g Pointer to the Garage structure
+ * @param ev Event to apply
+ * @return The return value of the dispatched function, -1 for unknown event types
+ */
+int apply_gate_event(Garage *g, const GateEvent *ev) {
+    switch (ev->type) {
+        case EVENT_ENTRY:
+            return register_entry_class(g, ev->license_plate, ev->time, (VehicleClass)ev->vehicle_class, NULL);
+        case EVENT_EXIT:
+            return log_exit(g, ev->license_plate, ev->time);
+        case EVENT_CORRECT_ENTRY:
+            return update_entry_time(g, ev->license_plate, ev->time);
+        case EVENT_CORRECT_EXIT:
+            return update_exit_time(g, ev->license_plate, ev->time);
+    }
+    return -1;
+}
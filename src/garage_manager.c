@@ -0,0 +1,339 @@
+/**
+ * @file garage_manager.c
+ * @brief Implements the sharded multi-garage manager.
+ *
+ * Workers own disjoint sets of garages (garage % workers) and are the only
+ * threads that call into them. Producers never share a ring: there is one
+ * SpscRing per (worker, producer) pair, drained round-robin by the worker in
+ * batches just like the gate pipeline's core thread. After applying an
+ * event the worker stores the garage's counters into a cache-line-sized
+ * cell, which is all garage_manager_totals() reads.
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "garage_manager.h"
+#include "garage.h"
+#include "spsc_ring.h"
+
+#define MANAGER_BATCH 64
+#define MANAGER_IDLE_SPINS 128
+
+/// @brief Ring element: the event plus the garage it is routed to
+typedef struct {
+    int garage;
+    GateEvent ev;
+} ManagerEvent;
+
+/// @brief One producer's ring to one worker
+typedef struct {
+    SpscRing ring;
+    _Alignas(CACHE_LINE_SIZE) atomic_uint_fast64_t ring_full; ///< Written by the producer
+} ManagerRing;
+
+/// @brief A garage and the counters its worker republishes for other threads
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_int inside;
+    atomic_int served;
+    _Atomic int64_t revenue_cents;
+    Garage *g;
+} GarageCell;
+
+/// @brief Worker thread state, padded so workers never share a cache line
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_uint_fast64_t applied;
+    pthread_t thread;
+    struct GarageManager *m;
+    int index;
+} Worker;
+
+struct GarageManager {
+    int garages;
+    int workers;
+    int producers;
+    GarageCell *cells;
+    Worker *threads;
+    ManagerRing *rings; ///< workers * producers rings, worker-major
+    ManagerResultHandler handler;
+    void *handler_ctx;
+    int running;
+    atomic_int stop;
+};
+
+static ManagerRing *ring_of(GarageManager *m, int worker, int producer) {
+    return &m->rings[worker * m->producers + producer];
+}
+
+static void publish_counters(GarageCell *cell) {
+    atomic_store_explicit(&cell->inside, cell->g->occupied, memory_order_relaxed);
+    atomic_store_explicit(&cell->served, cell->g->total_served, memory_order_relaxed);
+    atomic_store_explicit(&cell->revenue_cents, cell->g->revenue_cents, memory_order_relaxed);
+}
+
+/**
+ * @brief Drains every producer's ring to one worker once.
+ *
+ * @return Number of events applied
+ */
+static size_t drain_round(GarageManager *m, Worker *w) {
+    ManagerEvent batch[MANAGER_BATCH];
+    size_t total = 0;
+
+    for (int producer = 0; producer < m->producers; ++producer) {
+        size_t n = spsc_ring_pop_batch(&ring_of(m, w->index, producer)->ring, batch, MANAGER_BATCH);
+        for (size_t i = 0; i < n; ++i) {
+            GarageCell *cell = &m->cells[batch[i].garage];
+            int result = apply_gate_event(cell->g, &batch[i].ev);
+            publish_counters(cell);
+            if (m->handler) m->handler(m->handler_ctx, batch[i].garage, &batch[i].ev, result);
+        }
+        total += n;
+    }
+
+    if (total > 0) atomic_fetch_add_explicit(&w->applied, total, memory_order_relaxed);
+    return total;
+}
+
+static void *worker_thread(void *arg) {
+    Worker *w = arg;
+    GarageManager *m = w->m;
+    int idle = 0;
+
+    while (!atomic_load_explicit(&m->stop, memory_order_acquire)) {
+        if (drain_round(m, w) > 0) {
+            idle = 0;
+        } else if (++idle > MANAGER_IDLE_SPINS) {
+            sched_yield();
+        }
+    }
+
+    // Producers have stopped submitting; apply whatever is still queued
+    while (drain_round(m, w) > 0) {}
+    return NULL;
+}
+
+/**
+ * @brief Pins a worker to one CPU; failures leave the thread unpinned.
+ */
+static void pin_worker(Worker *w) {
+#ifdef __linux__
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus <= 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(w->index % (int)cpus, &set);
+    pthread_setaffinity_np(w->thread, sizeof(set), &set);
+#else
+    (void)w;
+#endif
+}
+
+/**
+ * @brief Creates the garages and one ring per producer and worker.
+ *
+ * @param garages Number of garages
+ * @param workers Number of worker threads
+ * @param producers Number of producer threads
+ * @param ring_capacity Events per ring
+ * @return Manager handle, or NULL on failure
+ */
+GarageManager *garage_manager_create(int garages, int workers, int producers, size_t ring_capacity) {
+    if (garages <= 0 || workers <= 0 || producers <= 0) return NULL;
+    if (workers > garages) workers = garages;
+
+    GarageManager *m = calloc(1, sizeof(GarageManager));
+    if (!m) return NULL;
+    m->garages = garages;
+    m->workers = workers;
+    m->producers = producers;
+
+    size_t rings = (size_t)workers * (size_t)producers;
+    m->cells = aligned_alloc(CACHE_LINE_SIZE, sizeof(GarageCell) * (size_t)garages);
+    m->threads = aligned_alloc(CACHE_LINE_SIZE, sizeof(Worker) * (size_t)workers);
+    m->rings = aligned_alloc(CACHE_LINE_SIZE, sizeof(ManagerRing) * rings);
+    if (!m->cells || !m->threads || !m->rings) {
+        free(m->cells);
+        free(m->threads);
+        free(m->rings);
+        free(m);
+        return NULL;
+    }
+    memset(m->cells, 0, sizeof(GarageCell) * (size_t)garages);
+    memset(m->threads, 0, sizeof(Worker) * (size_t)workers);
+    memset(m->rings, 0, sizeof(ManagerRing) * rings);
+
+    int failed = 0;
+    for (int i = 0; i < garages; ++i) {
+        m->cells[i].g = malloc(sizeof(Garage));
+        if (!m->cells[i].g) failed = 1;
+        else init_garage(m->cells[i].g);
+    }
+    for (size_t i = 0; i < rings; ++i) {
+        if (spsc_ring_init(&m->rings[i].ring, ring_capacity, sizeof(ManagerEvent)) != 0) failed = 1;
+    }
+    for (int i = 0; i < workers; ++i) {
+        m->threads[i].m = m;
+        m->threads[i].index = i;
+    }
+
+    if (failed) {
+        garage_manager_destroy(m);
+        return NULL;
+    }
+    return m;
+}
+
+/**
+ * @brief Returns a garage for setup or inspection.
+ *
+ * Counters changed through the returned pointer are republished when the
+ * garage's next event is applied, or at once by garage_manager_start().
+ *
+ * @param m Manager
+ * @param id Garage id
+ * @return Garage, or NULL if the id is invalid
+ */
+Garage *garage_manager_garage(GarageManager *m, int id) {
+    if (id < 0 || id >= m->garages) return NULL;
+    return m->cells[id].g;
+}
+
+/**
+ * @brief Returns the worker that owns a garage.
+ *
+ * @param m Manager
+ * @param id Garage id
+ * @return Worker index, or -1 if the id is invalid
+ */
+int garage_manager_worker_of(const GarageManager *m, int id) {
+    if (id < 0 || id >= m->garages) return -1;
+    return id % m->workers;
+}
+
+/**
+ * @brief Installs a handler receiving the result of every applied event.
+ *
+ * @param m Manager
+ * @param handler Result handler, or NULL
+ * @param ctx Context passed to the handler
+ */
+void garage_manager_set_result_handler(GarageManager *m, ManagerResultHandler handler, void *ctx) {
+    m->handler = handler;
+    m->handler_ctx = ctx;
+}
+
+/**
+ * @brief Starts and pins the worker threads.
+ *
+ * @param m Manager
+ * @return 0 on success, -1 on failure
+ */
+int garage_manager_start(GarageManager *m) {
+    if (m->running) return -1;
+    for (int i = 0; i < m->garages; ++i) publish_counters(&m->cells[i]);
+    atomic_store(&m->stop, 0);
+
+    for (int i = 0; i < m->workers; ++i) {
+        if (pthread_create(&m->threads[i].thread, NULL, worker_thread, &m->threads[i]) != 0) {
+            atomic_store_explicit(&m->stop, 1, memory_order_release);
+            for (int j = 0; j < i; ++j) pthread_join(m->threads[j].thread, NULL);
+            return -1;
+        }
+        pin_worker(&m->threads[i]);
+    }
+    m->running = 1;
+    return 0;
+}
+
+/**
+ * @brief Routes an event to the worker owning a garage.
+ *
+ * @param m Manager
+ * @param producer Producer index owned by the calling thread
+ * @param garage Garage id
+ * @param ev Event to apply
+ * @return 0 on success, -1 if an index is invalid or the ring is full
+ */
+int garage_manager_submit(GarageManager *m, int producer, int garage, const GateEvent *ev) {
+    if (producer < 0 || producer >= m->producers || garage < 0 || garage >= m->garages) return -1;
+    ManagerRing *r = ring_of(m, garage % m->workers, producer);
+
+    ManagerEvent me;
+    me.garage = garage;
+    me.ev = *ev;
+    if (spsc_ring_push(&r->ring, &me) != 0) {
+        atomic_fetch_add_explicit(&r->ring_full, 1, memory_order_relaxed);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Vehicles inside one garage.
+ *
+ * @param m Manager
+ * @param id Garage id
+ * @return Vehicles inside, or -1 if the id is invalid
+ */
+int garage_manager_occupancy(const GarageManager *m, int id) {
+    if (id < 0 || id >= m->garages) return -1;
+    return atomic_load_explicit(&m->cells[id].inside, memory_order_relaxed);
+}
+
+/**
+ * @brief Sums the counters of all garages without locking any shard.
+ *
+ * @param m Manager
+ * @param totals Output totals
+ */
+void garage_manager_totals(const GarageManager *m, ManagerTotals *totals) {
+    memset(totals, 0, sizeof(*totals));
+    totals->garages = m->garages;
+    for (int i = 0; i < m->garages; ++i) {
+        totals->inside += atomic_load_explicit(&m->cells[i].inside, memory_order_relaxed);
+        totals->served += atomic_load_explicit(&m->cells[i].served, memory_order_relaxed);
+        totals->revenue_cents += atomic_load_explicit(&m->cells[i].revenue_cents, memory_order_relaxed);
+    }
+    for (int i = 0; i < m->workers; ++i) {
+        totals->applied += atomic_load_explicit(&m->threads[i].applied, memory_order_relaxed);
+    }
+    for (int i = 0; i < m->workers * m->producers; ++i) {
+        totals->ring_full += atomic_load_explicit(&m->rings[i].ring_full, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Stops the workers after draining all rings.
+ *
+ * @param m Manager
+ */
+void garage_manager_stop(GarageManager *m) {
+    if (!m->running) return;
+    atomic_store_explicit(&m->stop, 1, memory_order_release);
+    for (int i = 0; i < m->workers; ++i) pthread_join(m->threads[i].thread, NULL);
+    m->running = 0;
+}
+
+/**
+ * @brief Frees the manager and its garages.
+ *
+ * @param m Manager (may be NULL)
+ */
+void garage_manager_destroy(GarageManager *m) {
+    if (!m) return;
+    garage_manager_stop(m);
+    for (int i = 0; i < m->workers * m->producers; ++i) spsc_ring_free(&m->rings[i].ring);
+    for (int i = 0; i < m->garages; ++i) {
+        if (m->cells[i].g) free_garage(m->cells[i].g);
+        free(m->cells[i].g);
+    }
+    free(m->cells);
+    free(m->threads);
+    free(m->rings);
+    free(m);
+}
@@ -0,0 +1,227 @@
+/**
+ * @file gate_log.c
+ * @brief Implements gate log parsing and the loser-tree k-way merge.
+ *
+ * The loser tree keeps, for every internal node, the source that lost the
+ * match played there; the overall winner sits in node 0. After the winner's
+ * source advances to its next event only the matches on its path to the
+ * root are replayed, i.e. log2(N) comparisons per event. An exhausted
+ * source gets an infinite key and loses every match.
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gate_log.h"
+#include "functions.h"
+#include "garage.h"
+
+#define KEY_EXHAUSTED INT_MAX
+
+/// @brief One open gate log and its current event
+typedef struct {
+    FILE *f;
+    char *buffer;
+    GateEvent ev;
+    int key;      ///< Minutes of ev, or KEY_EXHAUSTED
+    int last_key; ///< Key of the previous event of this log
+} MergeSource;
+
+static const char *const EVENT_NAMES[] = {"ENTRY", "EXIT", "CORRECT_ENTRY", "CORRECT_EXIT"};
+
+/**
+ * @brief Parses a strict "HH:MM" time string.
+ *
+ * @param str Input string
+ * @param t Output time
+ * @return 0 if valid, -1 otherwise
+ */
+static int parse_event_time(const char *str, Time *t) {
+    int h, m;
+    char extra;
+    if (sscanf(str, "%d:%d%c", &h, &m, &extra) != 2) return -1;
+    if (h < 0 || h > 23 || m < 0 || m > 59) return -1;
+    t->hour = h;
+    t->minute = m;
+    return 0;
+}
+
+/**
+ * @brief Parses one event line.
+ *
+ * An optional fourth field names the vehicle class (e.g. "ENTRY B-X1 08:00 EV").
+ *
+ * @param line Input line
+ * @param ev Output event
+ * @return 0 on success, -1 if the line is malformed
+ */
+int gate_event_parse(const char *line, GateEvent *ev) {
+    char cmd[16], plate[20], time_str[8], cls[16];
+    int fields = sscanf(line, "%15s %19s %7s %15s", cmd, plate, time_str, cls);
+    if (fields < 3) return -1;
+    if (parse_event_time(time_str, &ev->time) != 0) return -1;
+
+    ev->vehicle_class = CLASS_STANDARD;
+    if (fields == 4) {
+        int c = parse_vehicle_class(cls);
+        if (c < 0) return -1;
+        ev->vehicle_class = (uint8_t)c;
+    }
+
+    int type = -1;
+    for (int i = 0; i < (int)(sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0])); ++i) {
+        if (strcmp(cmd, EVENT_NAMES[i]) == 0) type = i;
+    }
+    if (type < 0) return -1;
+    ev->type = (EventType)type;
+    strcpy(ev->license_plate, plate);
+    return 0;
+}
+
+/**
+ * @brief Formats an event as a log line.
+ *
+ * @param ev Event
+ * @param out Output buffer
+ * @param size Size of the output buffer
+ * @return Length written
+ */
+int gate_event_format(const GateEvent *ev, char *out, size_t size) {
+    if (ev->type == EVENT_ENTRY && ev->vehicle_class != CLASS_STANDARD) {
+        return snprintf(out, size, "%s %s %02d:%02d %s\n", EVENT_NAMES[ev->type], ev->license_plate,
+                        ev->time.hour, ev->time.minute, vehicle_class_name((VehicleClass)ev->vehicle_class));
+    }
+    return snprintf(out, size, "%s %s %02d:%02d\n", EVENT_NAMES[ev->type],
+                    ev->license_plate, ev->time.hour, ev->time.minute);
+}
+
+/**
+ * @brief Reads the next valid event of a source, or marks it exhausted.
+ */
+static void source_advance(MergeSource *s, GateLogStats *stats) {
+    char line[128];
+    while (fgets(line, sizeof(line), s->f)) {
+        if (gate_event_parse(line, &s->ev) != 0) {
+            stats->malformed++;
+            continue;
+        }
+        s->key = time_to_minutes(s->ev.time);
+        if (s->key < s->last_key) stats->unsorted++;
+        s->last_key = s->key;
+        return;
+    }
+    s->key = KEY_EXHAUSTED;
+}
+
+/// @brief Match result: does source a win against source b?
+static int source_wins(const MergeSource *src, int a, int b) {
+    if (src[a].key != src[b].key) return src[a].key < src[b].key;
+    return a < b;
+}
+
+/**
+ * @brief Plays the matches below a node and records the losers.
+ *
+ * @return Winning source of the subtree
+ */
+static int build_tree(int *tree, const MergeSource *src, int n, int node) {
+    if (node >= n) return node - n;
+    int left = build_tree(tree, src, n, 2 * node);
+    int right = build_tree(tree, src, n, 2 * node + 1);
+    if (source_wins(src, left, right)) {
+        tree[node] = right;
+        return left;
+    }
+    tree[node] = left;
+    return right;
+}
+
+/**
+ * @brief Merges time-ordered gate logs into one time-ordered stream.
+ *
+ * @param paths Log file paths
+ * @param n Number of logs
+ * @param sink Called once per event
+ * @param ctx Context passed to the sink
+ * @param stats Output counters (may be NULL)
+ * @return 0 on success, -1 if a log could not be opened
+ */
+int gate_log_merge(const char *const *paths, int n, GateEventSink sink, void *ctx, GateLogStats *stats) {
+    GateLogStats local;
+    if (!stats) stats = &local;
+    memset(stats, 0, sizeof(*stats));
+    if (n <= 0) return 0;
+
+    MergeSource *src = calloc((size_t)n, sizeof(MergeSource));
+    int *tree = malloc(sizeof(int) * (size_t)n);
+    int result = src && tree ? 0 : -1;
+
+    for (int i = 0; i < n && result == 0; ++i) {
+        src[i].f = fopen(paths[i], "r");
+        src[i].buffer = malloc(GATE_LOG_READ_BUFFER);
+        if (!src[i].f || !src[i].buffer) {
+            result = -1;
+            break;
+        }
+        setvbuf(src[i].f, src[i].buffer, _IOFBF, GATE_LOG_READ_BUFFER);
+        source_advance(&src[i], stats);
+    }
+
+    if (result == 0) {
+        tree[0] = build_tree(tree, src, n, 1);
+        while (src[tree[0]].key != KEY_EXHAUSTED) {
+            int winner = tree[0];
+            sink(ctx, winner, &src[winner].ev);
+            stats->events++;
+            source_advance(&src[winner], stats);
+
+            // Replay the matches on the path from the winner's leaf to the root
+            for (int node = (winner + n) / 2; node > 0; node /= 2) {
+                if (source_wins(src, tree[node], winner)) {
+                    int loser = winner;
+                    winner = tree[node];
+                    tree[node] = loser;
+                }
+            }
+            tree[0] = winner;
+        }
+    }
+
+    for (int i = 0; src && i < n; ++i) {
+        if (src[i].f) fclose(src[i].f);
+        free(src[i].buffer);
+    }
+    free(src);
+    free(tree);
+    return result;
+}
+
+/// @brief Context of the replay sink
+typedef struct {
+    Garage *g;
+    GateLogStats *stats;
+} ReplayContext;
+
+static void replay_sink(void *ctx, int source, const GateEvent *ev) {
+    (void)source;
+    ReplayContext *rc = ctx;
+    if (apply_gate_event(rc->g, ev) < 0) rc->stats->rejected++;
+}
+
+/**
+ * @brief Merges gate logs and applies the stream to the garage.
+ *
+ * @param g Pointer to the Garage structure
+ * @param paths Log file paths
+ * @param n Number of logs
+ * @param stats Output counters (may be NULL)
+ * @return 0 on success, -1 if a log could not be opened
+ */
+int gate_log_replay(Garage *g, const char *const *paths, int n, GateLogStats *stats) {
+    GateLogStats local;
+    if (!stats) stats = &local;
+    // gate_log_merge() resets the counters before the first event reaches the sink
+    ReplayContext rc = {g, stats};
+    return gate_log_merge(paths, n, replay_sink, &rc, stats);
+}
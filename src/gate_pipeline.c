@@ -0,0 +1,304 @@
+/**
+ * @file gate_pipeline.c
+ * @brief Implements the per-gate SPSC ring pipeline feeding a single-writer garage core.
+ *
+ * Gates stamp each event with a monotonic timestamp and push it into their
+ * own ring. The core thread visits the rings round-robin, takes up to
+ * PIPELINE_BATCH events from each and applies them with apply_gate_event(),
+ * so the Garage is only ever touched from one thread and stays cache-hot.
+ * With debouncing enabled each gate filters its own repeated reads before
+ * pushing, which costs no synchronization and saves ring and core capacity.
+ * With reordering enabled the core hands events to a reorder buffer instead
+ * of applying them directly, and the result handler runs as they leave it.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "gate_pipeline.h"
+#include "spsc_ring.h"
+#include "garage.h"
+#include "debounce.h"
+#include "reorder.h"
+
+#define PIPELINE_BATCH 64
+#define PIPELINE_IDLE_SPINS 128
+
+/// @brief Ring element: the event plus its submit timestamp
+typedef struct {
+    GateEvent ev;
+    uint64_t submitted_ns;
+} PipelineEvent;
+
+/// @brief Per-gate state, padded so gates never share a cache line
+typedef struct {
+    SpscRing ring;
+    _Alignas(CACHE_LINE_SIZE) atomic_uint_fast64_t submitted;
+    atomic_uint_fast64_t ring_full;
+    atomic_uint_fast64_t debounced;
+    Debouncer debounce; ///< Owned by the gate thread
+} GateSlot;
+
+struct GatePipeline {
+    Garage *g;
+    int gates;
+    GateSlot *slots;
+    pthread_t core;
+    int running;
+    atomic_int stop;
+    GateResultHandler handler;
+    void *handler_ctx;
+    ReorderBuffer *reorder; ///< Owned by the core thread, NULL if disabled
+
+    // Written by the core thread only, read after it stopped or for monitoring
+    atomic_uint_fast64_t applied;
+    atomic_uint_fast64_t batches;
+    atomic_uint_fast64_t total_latency_ns;
+    atomic_uint_fast64_t max_latency_ns;
+    atomic_uint_fast64_t late;
+    atomic_uint_fast64_t dropped;
+};
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void publish_reorder_stats(GatePipeline *p) {
+    atomic_store_explicit(&p->late, p->reorder->stats.late, memory_order_relaxed);
+    atomic_store_explicit(&p->dropped, p->reorder->stats.dropped, memory_order_relaxed);
+}
+
+/**
+ * @brief Drains every ring once.
+ *
+ * @return Number of events applied
+ */
+static size_t drain_round(GatePipeline *p) {
+    PipelineEvent batch[PIPELINE_BATCH];
+    size_t total = 0;
+    uint64_t latency_sum = 0;
+    uint64_t latency_max = atomic_load_explicit(&p->max_latency_ns, memory_order_relaxed);
+
+    for (int gate = 0; gate < p->gates; ++gate) {
+        size_t n = spsc_ring_pop_batch(&p->slots[gate].ring, batch, PIPELINE_BATCH);
+        if (n == 0) continue;
+
+        for (size_t i = 0; i < n; ++i) {
+            if (p->reorder) {
+                reorder_push(p->reorder, gate, &batch[i].ev);
+                continue;
+            }
+            int result = apply_gate_event(p->g, &batch[i].ev);
+            if (p->handler) p->handler(p->handler_ctx, gate, &batch[i].ev, result);
+        }
+
+        uint64_t now = monotonic_ns();
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t latency = now - batch[i].submitted_ns;
+            latency_sum += latency;
+            if (latency > latency_max) latency_max = latency;
+        }
+        total += n;
+    }
+
+    if (total > 0) {
+        atomic_fetch_add_explicit(&p->applied, total, memory_order_relaxed);
+        atomic_fetch_add_explicit(&p->batches, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&p->total_latency_ns, latency_sum, memory_order_relaxed);
+        atomic_store_explicit(&p->max_latency_ns, latency_max, memory_order_relaxed);
+        if (p->reorder) publish_reorder_stats(p);
+    }
+    return total;
+}
+
+static void *core_thread(void *arg) {
+    GatePipeline *p = arg;
+    int idle = 0;
+
+    while (!atomic_load_explicit(&p->stop, memory_order_acquire)) {
+        if (drain_round(p) > 0) {
+            idle = 0;
+        } else if (++idle > PIPELINE_IDLE_SPINS) {
+            sched_yield();
+        }
+    }
+
+    // Gates have stopped submitting; apply whatever is still queued
+    while (drain_round(p) > 0) {}
+    if (p->reorder) {
+        reorder_flush(p->reorder);
+        publish_reorder_stats(p);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Creates a pipeline with one ring per gate.
+ *
+ * @param g Pointer to the Garage structure
+ * @param gates Number of gates
+ * @param ring_capacity Events per ring
+ * @return Pipeline handle, or NULL on failure
+ */
+GatePipeline *gate_pipeline_create(Garage *g, int gates, size_t ring_capacity) {
+    if (gates <= 0) return NULL;
+
+    GatePipeline *p = calloc(1, sizeof(GatePipeline));
+    if (!p) return NULL;
+    p->g = g;
+    p->gates = gates;
+    p->slots = aligned_alloc(CACHE_LINE_SIZE, sizeof(GateSlot) * (size_t)gates);
+    if (!p->slots) {
+        free(p);
+        return NULL;
+    }
+    memset(p->slots, 0, sizeof(GateSlot) * (size_t)gates);
+
+    for (int i = 0; i < gates; ++i) {
+        if (spsc_ring_init(&p->slots[i].ring, ring_capacity, sizeof(PipelineEvent)) != 0) {
+            p->gates = i;
+            gate_pipeline_destroy(p);
+            return NULL;
+        }
+    }
+    return p;
+}
+
+/**
+ * @brief Installs a handler receiving the result of every applied event.
+ *
+ * @param p Pipeline
+ * @param handler Result handler, or NULL
+ * @param ctx Context passed to the handler
+ */
+void gate_pipeline_set_result_handler(GatePipeline *p, GateResultHandler handler, void *ctx) {
+    p->handler = handler;
+    p->handler_ctx = ctx;
+}
+
+/**
+ * @brief Enables debouncing of repeated reads on every gate.
+ *
+ * @param p Pipeline
+ * @param window_ms Coalescing window in milliseconds (0 disables debouncing)
+ */
+void gate_pipeline_set_debounce(GatePipeline *p, uint32_t window_ms) {
+    for (int i = 0; i < p->gates; ++i) debouncer_init(&p->slots[i].debounce, window_ms);
+}
+
+/**
+ * @brief Applies events in event-time order through a reorder buffer.
+ *
+ * @param p Pipeline
+ * @param lateness_minutes Allowed lateness; negative disables reordering
+ * @return 0 on success, -1 on allocation failure
+ */
+int gate_pipeline_set_reorder(GatePipeline *p, int lateness_minutes) {
+    if (lateness_minutes < 0) {
+        free(p->reorder);
+        p->reorder = NULL;
+        return 0;
+    }
+    if (!p->reorder) {
+        p->reorder = malloc(sizeof(ReorderBuffer));
+        if (!p->reorder) return -1;
+    }
+    reorder_init(p->reorder, p->g, lateness_minutes);
+    return 0;
+}
+
+/**
+ * @brief Starts the core thread.
+ *
+ * @param p Pipeline
+ * @return 0 on success, -1 on failure
+ */
+int gate_pipeline_start(GatePipeline *p) {
+    if (p->running) return -1;
+    if (p->reorder) reorder_set_handler(p->reorder, p->handler, p->handler_ctx);
+    atomic_store(&p->stop, 0);
+    if (pthread_create(&p->core, NULL, core_thread, p) != 0) return -1;
+    p->running = 1;
+    return 0;
+}
+
+/**
+ * @brief Publishes an event from a gate thread.
+ *
+ * @param p Pipeline
+ * @param gate Gate index owned by the calling thread
+ * @param ev Event to publish
+ * @return 0 on success, 1 if dropped as a repeated read,
+ *         -1 if the ring is full or the gate index is invalid
+ */
+int gate_pipeline_submit(GatePipeline *p, int gate, const GateEvent *ev) {
+    if (gate < 0 || gate >= p->gates) return -1;
+    GateSlot *slot = &p->slots[gate];
+
+    PipelineEvent pe;
+    pe.ev = *ev;
+    pe.submitted_ns = monotonic_ns();
+
+    if (!debouncer_accept(&slot->debounce, ev, pe.submitted_ns / 1000000u)) {
+        atomic_fetch_add_explicit(&slot->debounced, 1, memory_order_relaxed);
+        return 1;
+    }
+    if (spsc_ring_push(&slot->ring, &pe) != 0) {
+        atomic_fetch_add_explicit(&slot->ring_full, 1, memory_order_relaxed);
+        return -1;
+    }
+    atomic_fetch_add_explicit(&slot->submitted, 1, memory_order_relaxed);
+    return 0;
+}
+
+/**
+ * @brief Stops the core thread after draining all rings.
+ *
+ * @param p Pipeline
+ */
+void gate_pipeline_stop(GatePipeline *p) {
+    if (!p->running) return;
+    atomic_store_explicit(&p->stop, 1, memory_order_release);
+    pthread_join(p->core, NULL);
+    p->running = 0;
+}
+
+/**
+ * @brief Copies the pipeline counters.
+ *
+ * @param p Pipeline
+ * @param stats Output counters
+ */
+void gate_pipeline_get_stats(GatePipeline *p, GatePipelineStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    for (int i = 0; i < p->gates; ++i) {
+        stats->submitted += atomic_load_explicit(&p->slots[i].submitted, memory_order_relaxed);
+        stats->ring_full += atomic_load_explicit(&p->slots[i].ring_full, memory_order_relaxed);
+        stats->debounced += atomic_load_explicit(&p->slots[i].debounced, memory_order_relaxed);
+    }
+    stats->applied = atomic_load_explicit(&p->applied, memory_order_relaxed);
+    stats->batches = atomic_load_explicit(&p->batches, memory_order_relaxed);
+    stats->total_latency_ns = atomic_load_explicit(&p->total_latency_ns, memory_order_relaxed);
+    stats->max_latency_ns = atomic_load_explicit(&p->max_latency_ns, memory_order_relaxed);
+    stats->late = atomic_load_explicit(&p->late, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&p->dropped, memory_order_relaxed);
+}
+
+/**
+ * @brief Frees the pipeline.
+ *
+ * @param p Pipeline (may be NULL)
+ */
+void gate_pipeline_destroy(GatePipeline *p) {
+    if (!p) return;
+    gate_pipeline_stop(p);
+    for (int i = 0; i < p->gates; ++i) spsc_ring_free(&p->slots[i].ring);
+    free(p->slots);
+    free(p->reorder);
+    free(p);
+}
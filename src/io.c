@@ -4,7 +4,8 @@
  *
  * This file contains functions responsible for writing the end-of-day
  * report that includes all served cars, vehicles still inside,
- * total revenue, and total number of cars served.
+ * total revenue, total number of cars served and the peak occupancy, and
+ * the per-minute occupancy curve used for capacity planning.
  *
  * @author
  * Mohamad Sakkal
@@ -12,53 +13,209 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "structs.h"
+#include "garage.h"
+#include "functions.h"
 #include "io.h"
 
+/// Reports are buffered in full and written with as few write() calls as possible
+#define REPORT_IO_BUFFER (64 * 1024)
+
+static int write_served_vehicle(const Vehicle *v, void *ctx) {
+    fprintf((FILE *)ctx, " - %s entered at %02d:%02d, exited at %02d:%02d, fee €%d\n",
+            v->license_plate, v->entry_time.hour, v->entry_time.minute,
+            v->exit_time.hour, v->exit_time.minute, v->fee);
+    return 0;
+}
+
+static int write_parked_vehicle(const Vehicle *v, void *ctx) {
+    fprintf((FILE *)ctx, " - %s (entered at %02d:%02d)\n",
+            v->license_plate, v->entry_time.hour, v->entry_time.minute);
+    return 0;
+}
+
 /**
  * @brief Writes the end-of-day parking garage report to a file.
  *
  * This report includes:
  * - A list of all cars that entered and exited with timestamps
  * - The total number of cars served during the day
- * - The total revenue collected
+ * - The total revenue collected, and how much of it corrections changed
+ * - The revenue by hour of the exit and by vehicle class
+ * - The peak occupancy and when it was reached
  * - A list of cars still inside the garage at closing time
  *
+ * The report is safe to write from several threads at once for different
+ * garages; each call uses its own stack buffer for the file.
+ *
  * @param g Pointer to the Garage structure
  * @param filename Name of the file to write the report to
+ * @return 0 on success, -1 if the file could not be written
  */
-void write_report(const Garage *g, const char *filename) {
+int write_report(const Garage *g, const char *filename) {
     FILE *file = fopen(filename, "w");
     if (!file) {
         perror("Could not open output file");
-        return;
+        return -1;
     }
+    char buffer[REPORT_IO_BUFFER];
+    setvbuf(file, buffer, _IOFBF, sizeof(buffer));
 
     fprintf(file, "Daily Parking Garage Report\n");
     fprintf(file, "===========================\n\n");
 
+    VehicleFilter filter;
+
     fprintf(file, "Served Cars:\n");
-    for (int i = 0; i < g->count; ++i) {
-        Vehicle v = g->vehicles[i];
-        if (v.has_exited) {
-            fprintf(file, " - %s entered at %02d:%02d, exited at %02d:%02d\n",
-                    v.license_plate, v.entry_time.hour, v.entry_time.minute,
-                    v.exit_time.hour, v.exit_time.minute);
-        }
-    }
+    vehicle_filter_init(&filter, VEHICLES_EXITED);
+    garage_for_each(g, &filter, write_served_vehicle, file);
 
     fprintf(file, "\nTotal Cars Served: %d\n", g->total_served);
-    fprintf(file, "Total Revenue: €%.2f\n", g->total_revenue);
+    char amount[32];
+    format_cents(g->revenue_cents, amount, sizeof(amount));
+    fprintf(file, "Total Revenue: €%s\n", amount);
+    if (g->corrections.total > 0) {
+        RevenueAudit audit;
+        garage_revenue_audit(g, &audit);
+        format_cents(audit.booked_cents, amount, sizeof(amount));
+        fprintf(file, "  Booked at Exits: €%s\n", amount);
+        format_cents(audit.adjustment_cents, amount, sizeof(amount));
+        fprintf(file, "  Corrections: %ld (net €%s)\n", audit.corrections, amount);
+    }
+
+    fprintf(file, "\nRevenue by Hour:\n");
+    for (int h = 0; h < HOURS_PER_DAY; ++h) {
+        if (g->revenue_by_hour[h] == 0) continue;
+        format_cents(g->revenue_by_hour[h], amount, sizeof(amount));
+        fprintf(file, " - %02d:00-%02d:59: €%s\n", h, h, amount);
+    }
+    fprintf(file, "Revenue by Class:\n");
+    for (int c = 0; c < VEHICLE_CLASS_COUNT; ++c) {
+        if (g->revenue_by_class[c] == 0) continue;
+        format_cents(g->revenue_by_class[c], amount, sizeof(amount));
+        fprintf(file, " - %s: €%s\n", vehicle_class_name((VehicleClass)c), amount);
+    }
+
+    int curve[MINUTES_PER_DAY];
+    OccupancyPeak peak;
+    garage_occupancy_curve(g, curve, &peak);
+    fprintf(file, "Peak Occupancy: %d at %02d:%02d\n", peak.occupied, peak.time.hour, peak.time.minute);
 
     fprintf(file, "\nVehicles Still Inside:\n");
-    for (int i = 0; i < g->count; ++i) {
-        if (!g->vehicles[i].has_exited) {
-            fprintf(file, " - %s (entered at %02d:%02d)\n",
-                    g->vehicles[i].license_plate,
-                    g->vehicles[i].entry_time.hour,
-                    g->vehicles[i].entry_time.minute);
-        }
+    vehicle_filter_init(&filter, VEHICLES_ACTIVE);
+    garage_for_each(g, &filter, write_parked_vehicle, file);
+
+    int failed = ferror(file);
+    if (fclose(file) != 0 || failed) return -1;
+    return 0;
+}
+
+/**
+ * @brief Writes the per-minute occupancy curve of the day as CSV.
+ *
+ * One row per minute with the time and the number of vehicles inside.
+ *
+ * @param g Pointer to the Garage structure
+ * @param filename Name of the file to write the curve to
+ * @return 0 on success, -1 if the file could not be written
+ */
+int write_occupancy_csv(const Garage *g, const char *filename) {
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        perror("Could not open output file");
+        return -1;
+    }
+
+    int curve[MINUTES_PER_DAY];
+    garage_occupancy_curve(g, curve, NULL);
+
+    fprintf(file, "time,occupied\n");
+    for (int m = 0; m < MINUTES_PER_DAY; ++m) {
+        fprintf(file, "%02d:%02d,%d\n", m / 60, m % 60, curve[m]);
+    }
+    int failed = ferror(file);
+    if (fclose(file) != 0 || failed) return -1;
+    return 0;
+}
+
+static uint64_t stays_align(uint64_t offset) {
+    return (offset + STAYS_ALIGNMENT - 1) & ~(uint64_t)(STAYS_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Exports the day's vehicles as a columnar binary file.
+ *
+ * The file is a StaysHeader followed by one column per field (plate,
+ * entry, exit, fee, class), each aligned to STAYS_ALIGNMENT. The whole
+ * file is laid out in memory first and written with a single unbuffered
+ * fwrite(), so the export costs one write() however many rows it has, and
+ * readers load a column as one contiguous typed array instead of parsing
+ * the text report.
+ *
+ * @param g Pointer to the Garage structure
+ * @param filename Name of the file to write the export to
+ * @return 0 on success, -1 if the file could not be written
+ */
+int write_stays_columnar(const Garage *g, const char *filename) {
+    VehicleIterator it;
+    const Vehicle *v;
+    uint32_t rows = 0, plate_bytes = 0;
+
+    vehicle_iter_init(&it, g, NULL);
+    while ((v = vehicle_iter_next(&it))) {
+        rows++;
+        plate_bytes += (uint32_t)strlen(v->license_plate);
+    }
+
+    StaysHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, STAYS_MAGIC, sizeof(h.magic));
+    h.rows = rows;
+    h.plate_bytes = plate_bytes;
+    h.plate_offsets = stays_align(sizeof(h));
+    h.plate_data = stays_align(h.plate_offsets + (rows + 1) * sizeof(uint32_t));
+    h.entry_minute = stays_align(h.plate_data + plate_bytes);
+    h.exit_minute = stays_align(h.entry_minute + rows * sizeof(int16_t));
+    h.fee_cents = stays_align(h.exit_minute + rows * sizeof(int16_t));
+    h.vehicle_class = stays_align(h.fee_cents + rows * sizeof(int32_t));
+    size_t size = (size_t)stays_align(h.vehicle_class + rows);
+
+    unsigned char *buf = calloc(1, size);
+    if (!buf) return -1;
+    memcpy(buf, &h, sizeof(h));
+    uint32_t *offsets = (uint32_t *)(buf + h.plate_offsets);
+    char *plates = (char *)(buf + h.plate_data);
+    int16_t *entries = (int16_t *)(buf + h.entry_minute);
+    int16_t *exits = (int16_t *)(buf + h.exit_minute);
+    int32_t *fees = (int32_t *)(buf + h.fee_cents);
+    uint8_t *classes = buf + h.vehicle_class;
+
+    uint32_t row = 0, pos = 0;
+    vehicle_iter_init(&it, g, NULL);
+    while ((v = vehicle_iter_next(&it))) {
+        size_t len = strlen(v->license_plate);
+        offsets[row] = pos;
+        memcpy(plates + pos, v->license_plate, len);
+        pos += (uint32_t)len;
+        entries[row] = (int16_t)time_to_minutes(v->entry_time);
+        exits[row] = (int16_t)(v->has_exited ? time_to_minutes(v->exit_time) : -1);
+        fees[row] = v->fee * CENTS_PER_EURO;
+        classes[row] = v->vehicle_class;
+        row++;
     }
+    offsets[rows] = pos;
 
-    fclose(file);
-}
\ No newline at end of file
+    FILE *file = fopen(filename, "wb");
+    if (!file) {
+        perror("Could not open output file");
+        free(buf);
+        return -1;
+    }
+    setvbuf(file, NULL, _IONBF, 0); // buf is already complete; hand it to write() as is
+    size_t written = fwrite(buf, 1, size, file);
+    free(buf);
+    if (fclose(file) != 0 || written != size) return -1;
+    return 0;
+}
@@ -4,31 +4,278 @@
  *
  * This file provides a terminal-based interface for attendants to manage
  * vehicle entry, exit, occupancy display, correction of times, and
- * end-of-day report generation.
+ * end-of-day report generation. Started with `--server <socket>` it instead
+ * serves gate controllers over a Unix domain socket. With `--feed <name>`
+ * the live occupancy is also published to a shared-memory segment.
+ * Each `--replay <log>` names a gate log; all of them are merged in time
+ * order and applied before the menu or server starts. Vehicles still inside
+ * at 22:00, or longer than `--max-stay <minutes>`, are reported as soon as
+ * an event passes their deadline. `--bays <levels>x<bays per level>`
+ * assigns every entering car the nearest free bay. `--quota <class>=<spots>`
+ * (repeatable) reserves spots for a vehicle class such as EV or DISABLED.
+ * `--replicate <socket>` ships every change to a warm standby, and
+ * `--standby <socket>` runs as that standby until SIGUSR1, SIGINT or
+ * SIGTERM promotes it; it then continues in menu or server mode.
  *
  * @author
  * Mohamad Sakkal
  * @date 14.08.25
  */
 
+#include <signal.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "garage.h"
 #include "functions.h"
 #include "io.h"
+#include "server.h"
+#include "occupancy_feed.h"
+#include "gate_log.h"
+#include "alert_wheel.h"
+#include "bay_map.h"
+#include "replication.h"
+
+#define MAX_REPLAY_LOGS 256
+#define LONGEST_PARKED_SHOWN 5
+#define REPLICATION_LOG_SIZE 65536
+#define REPLICATION_SYNC_MS 2000
+
+/// @brief Server instance stopped by the signal handler in server mode
+static Server *active_server = NULL;
+
+/// @brief Standby promoted by the signal handler in standby mode
+static Standby *active_standby = NULL;
+
+static void handle_stop_signal(int sig) {
+    (void)sig;
+    if (active_standby) standby_stop(active_standby);
+    else if (active_server) server_stop(active_server);
+}
+
+/**
+ * @brief Follows a primary until promoted by SIGUSR1, SIGINT or SIGTERM.
+ *
+ * @param g Pointer to the Garage structure kept in sync
+ * @param socket_path Path of the socket the primary ships to
+ * @return 0 once promoted, 1 on error
+ */
+static int run_standby_mode(Garage *g, const char *socket_path) {
+    active_standby = standby_create(g, socket_path);
+    if (!active_standby) return 1;
+
+    signal(SIGUSR1, handle_stop_signal);
+    signal(SIGINT, handle_stop_signal);
+    signal(SIGTERM, handle_stop_signal);
+
+    printf("Standing by for the primary on '%s'.\n", socket_path);
+    int result = standby_run(active_standby);
+
+    StandbyStats stats;
+    standby_get_stats(active_standby, &stats);
+    standby_destroy(active_standby);
+    active_standby = NULL;
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    if (stats.diverged) {
+        fprintf(stderr, "Standby missed events of the primary and must be rebuilt; not promoting.\n");
+        return 1;
+    }
+    if (result != 0) return 1;
+
+    printf("Promoted to primary after %llu events (%llu rejected), %d vehicles inside.\n",
+           (unsigned long long)stats.applied_seq, (unsigned long long)stats.rejected, current_occupancy(g));
+    return 0;
+}
+
+/**
+ * @brief Waits briefly for the standby and prints the replication counters.
+ *
+ * @param r Replicator, or NULL if replication is disabled
+ */
+static void close_replication(Replicator *r) {
+    if (!r) return;
+    ReplicationStats stats;
+    int synced = replicator_sync(r, REPLICATION_SYNC_MS) == 0;
+    replicator_get_stats(r, &stats);
+    printf("Replication: %llu events, %llu acknowledged%s, %llu dropped, max ack latency %.2f ms.\n",
+           (unsigned long long)stats.appended, (unsigned long long)stats.acked,
+           synced ? "" : stats.broken ? " (stream broken, standby must be rebuilt)" : " (standby behind)",
+           (unsigned long long)stats.dropped,
+           stats.max_ack_latency_ns / 1e6);
+    replicator_destroy(r);
+}
+
+/**
+ * @brief Prints overstay and closing-time alerts.
+ */
+static void print_alert(void *ctx, const Vehicle *v, AlertReason reason, Time deadline) {
+    (void)ctx;
+    printf("Alert: %s %s (%02d:%02d).\n", v->license_plate,
+           reason == ALERT_OVERSTAY ? "exceeded the maximum stay" : "is still inside at closing time",
+           deadline.hour, deadline.minute);
+}
+
+/**
+ * @brief Writes the end-of-day report, the occupancy curve and the stays export.
+ *
+ * @param g Pointer to the Garage structure
+ * @return 0 if every file was written, -1 otherwise
+ */
+static int write_day_files(const Garage *g) {
+    int failed = 0;
+    if (write_report(g, "daily_report.txt") != 0) {
+        fprintf(stderr, "Could not write 'daily_report.txt'.\n");
+        failed = 1;
+    }
+    if (write_occupancy_csv(g, "daily_occupancy.csv") != 0) {
+        fprintf(stderr, "Could not write 'daily_occupancy.csv'.\n");
+        failed = 1;
+    }
+    if (write_stays_columnar(g, "daily_stays.bin") != 0) {
+        fprintf(stderr, "Could not write 'daily_stays.bin'.\n");
+        failed = 1;
+    }
+    if (failed) return -1;
+    printf("Report written to 'daily_report.txt', 'daily_occupancy.csv' and 'daily_stays.bin'.\n");
+    return 0;
+}
+
+/**
+ * @brief Serves gate controllers on a Unix domain socket until SIGINT/SIGTERM.
+ *
+ * On shutdown the end-of-day report is written just like menu option 4.
+ *
+ * @param g Pointer to the Garage structure
+ * @param socket_path Path of the socket to listen on
+ * @param feed Occupancy feed to publish to, or NULL
+ * @return 0 on clean shutdown, 1 on error or if the report could not be written
+ */
+static int run_server_mode(Garage *g, const char *socket_path, OccupancyFeed *feed) {
+    active_server = server_create(g, socket_path);
+    if (!active_server) return 1;
+    server_set_feed(active_server, feed);
+
+    signal(SIGINT, handle_stop_signal);
+    signal(SIGTERM, handle_stop_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Listening for gate controllers on '%s'.\n", socket_path);
+    int result = server_run(active_server);
+
+    server_destroy(active_server);
+    active_server = NULL;
+
+    if (write_day_files(g) != 0) result = -1;
+    return result == 0 ? 0 : 1;
+}
 
 /**
  * @brief Main menu-driven loop for user interaction.
  *
  * Provides options to register vehicle entries and exits, view occupancy,
  * generate reports, and correct log entries. Handles all user input/output.
+ * When called as `ParkingGarageSystem --server <socket>` the menu is skipped
+ * and gate controllers are served instead. `--feed <name>` publishes the
+ * occupancy to shared memory after every change in either mode.
+ * `--replay <log>` (repeatable) first rebuilds the day from gate logs.
+ * `--max-stay <minutes>` adds overstay alerts to the closing-time alerts.
+ * `--standby <socket>` first follows a primary started with
+ * `--replicate <socket>` until promoted.
  *
+ * @param argc Argument count
+ * @param argv Argument vector
  * @return 0 on successful program termination
  */
-int main() {
+int main(int argc, char *argv[]) {
     Garage g;
     init_garage(&g);
 
+    const char *socket_path = NULL;
+    const char *feed_name = NULL;
+    const char *replicate_path = NULL;
+    const char *standby_path = NULL;
+    const char *replay_logs[MAX_REPLAY_LOGS];
+    int replay_count = 0;
+    int max_stay = 0;
+    int levels = 0, bays_per_level = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--server") == 0) socket_path = argv[i + 1];
+        else if (strcmp(argv[i], "--feed") == 0) feed_name = argv[i + 1];
+        else if (strcmp(argv[i], "--replicate") == 0) replicate_path = argv[i + 1];
+        else if (strcmp(argv[i], "--standby") == 0) standby_path = argv[i + 1];
+        else if (strcmp(argv[i], "--max-stay") == 0) max_stay = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--quota") == 0) {
+            char name[16];
+            int spots, cls = -1;
+            if (sscanf(argv[i + 1], "%15[^=]=%d", name, &spots) == 2) cls = parse_vehicle_class(name);
+            if (cls < 0 || set_class_quota(&g, (VehicleClass)cls, spots) != 0) {
+                fprintf(stderr, "Invalid quota '%s'.\n", argv[i + 1]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--bays") == 0) sscanf(argv[i + 1], "%dx%d", &levels, &bays_per_level);
+        else if (strcmp(argv[i], "--replay") == 0 && replay_count < MAX_REPLAY_LOGS) {
+            replay_logs[replay_count++] = argv[i + 1];
+        }
+    }
+
+    static AlertWheel alerts;
+    Time closing = {22, 0};
+    alert_wheel_init(&alerts, max_stay, &closing, print_alert, NULL);
+    garage_set_alerts(&g, &alerts);
+
+    BayMap *bays = NULL;
+    if (levels > 0) {
+        bays = bay_map_create(levels, bays_per_level);
+        if (!bays) {
+            fprintf(stderr, "Invalid bay layout '%dx%d'.\n", levels, bays_per_level);
+            return 1;
+        }
+        garage_set_bays(&g, bays);
+    }
+
+    if (standby_path && run_standby_mode(&g, standby_path) != 0) return 1;
+
+    Replicator *replica = NULL;
+    if (replicate_path) {
+        replica = replicator_create(replicate_path, REPLICATION_LOG_SIZE);
+        if (!replica) {
+            fprintf(stderr, "Invalid standby socket '%s'.\n", replicate_path);
+            return 1;
+        }
+        garage_set_replicator(&g, replica);
+    }
+
+    if (replay_count > 0) {
+        GateLogStats stats;
+        if (gate_log_replay(&g, replay_logs, replay_count, &stats) != 0) {
+            perror("Could not read gate logs");
+            return 1;
+        }
+        printf("Replayed %llu events from %d gate logs (%llu rejected, %llu malformed lines).\n",
+               (unsigned long long)stats.events, replay_count,
+               (unsigned long long)stats.rejected, (unsigned long long)stats.malformed);
+    }
+
+    OccupancyFeed *feed = NULL;
+    if (feed_name) {
+        feed = occupancy_feed_create(feed_name);
+        if (!feed) {
+            perror("Could not create occupancy feed");
+            return 1;
+        }
+    }
+
+    if (socket_path) {
+        int result = run_server_mode(&g, socket_path, feed);
+        close_replication(replica);
+        occupancy_feed_close(feed);
+        bay_map_destroy(bays);
+        return result;
+    }
+    if (feed) occupancy_feed_publish(feed, &g);
+
     int running = 1;
     while (running) {
         printf("\n=== Parking Garage System ===\n");
@@ -38,14 +285,22 @@ int main() {
         printf("4. End Day & Generate Report\n");
         printf("5. Exit\n");
         printf("6. Correct Entry/Exit Time\n");
+        printf("7. Log Exit by Ticket\n");
+        printf("8. Longest-Parked Vehicles\n");
+        printf("9. Vehicles Inside at a Time\n");
         printf("Choose option: ");
 
         int choice;
         scanf("%d", &choice);
         getchar(); // remove newline
 
-        char plate[20], time_str[6];
+        char plate[20], time_str[8], ticket_str[16], class_str[16]; // time_str also holds the newline
+        int cls;
         Time t;
+        Ticket ticket;
+        int fee, n;
+        const Vehicle *longest[LONGEST_PARKED_SHOWN];
+        const Vehicle *inside[GARAGE_CAPACITY];
 
         switch (choice) {
             case 1:
@@ -56,11 +311,37 @@ int main() {
                 printf("Entry Time (HH:MM): ");
                 fgets(time_str, sizeof(time_str), stdin);
                 t = parse_time(time_str);
+                if (!time_valid(t)) {
+                    printf("Invalid time, expected HH:MM.\n");
+                    break;
+                }
 
-                if (register_entry(&g, plate, t) == 0)
-                    printf("Entry registered.\n");
-                else
-                    printf("Garage is full!\n");
+                printf("Vehicle Class (Enter for standard, EV, DISABLED, MOTORCYCLE, PERMIT): ");
+                fgets(class_str, sizeof(class_str), stdin);
+                class_str[strcspn(class_str, "\n")] = '\0';
+                cls = class_str[0] ? parse_vehicle_class(class_str) : CLASS_STANDARD;
+                if (cls < 0) {
+                    printf("Unknown vehicle class.\n");
+                    break;
+                }
+
+                switch (register_entry_class(&g, plate, t, (VehicleClass)cls, &ticket)) {
+                    case 0:
+                        format_ticket(ticket, ticket_str, sizeof(ticket_str));
+                        printf("Entry registered. Ticket: %s\n", ticket_str);
+                        if (bays) {
+                            int level, number;
+                            bay_map_locate(bays, find_vehicle_by_ticket(&g, ticket)->bay, &level, &number);
+                            printf("Please park on level %d, bay %d.\n", level, number + 1);
+                        }
+                        break;
+                    case -2:
+                        printf("Vehicle is already inside!\n");
+                        break;
+                    default:
+                        if (cls == CLASS_STANDARD) printf("Garage is full!\n");
+                        else printf("No %s spots left!\n", vehicle_class_name((VehicleClass)cls));
+                }
                 break;
 
             case 2:
@@ -71,8 +352,12 @@ int main() {
                 printf("Exit Time (HH:MM): ");
                 fgets(time_str, sizeof(time_str), stdin);
                 t = parse_time(time_str);
+                if (!time_valid(t)) {
+                    printf("Invalid time, expected HH:MM.\n");
+                    break;
+                }
 
-                int fee = log_exit(&g, plate, t);
+                fee = log_exit(&g, plate, t);
                 if (fee >= 0)
                     printf("Exit logged. Fee: €%d\n", fee);
                 else
@@ -84,8 +369,7 @@ int main() {
                 break;
 
             case 4:
-                write_report(&g, "daily_report.txt");
-                printf("Report written to 'daily_report.txt'.\n");
+                write_day_files(&g);
                 break;
 
             case 5:
@@ -105,6 +389,10 @@ int main() {
                 printf("New Time (HH:MM): ");
                 fgets(time_str, sizeof(time_str), stdin);
                 t = parse_time(time_str);
+                if (!time_valid(t)) {
+                    printf("Invalid time, expected HH:MM.\n");
+                    break;
+                }
 
                 if (subchoice == 1) {
                     if (update_entry_time(&g, plate, t) == 0)
@@ -121,10 +409,60 @@ int main() {
                 }
                 break;
 
+            case 7:
+                printf("Ticket Number: ");
+                fgets(ticket_str, sizeof(ticket_str), stdin);
+                ticket_str[strcspn(ticket_str, "\n")] = '\0';
+                ticket = parse_ticket(ticket_str);
+
+                printf("Exit Time (HH:MM): ");
+                fgets(time_str, sizeof(time_str), stdin);
+                t = parse_time(time_str);
+                if (!time_valid(t)) {
+                    printf("Invalid time, expected HH:MM.\n");
+                    break;
+                }
+
+                fee = log_exit_by_ticket(&g, ticket, t);
+                if (fee >= 0)
+                    printf("Exit logged. Fee: €%d\n", fee);
+                else
+                    printf("Invalid, used or expired ticket.\n");
+                break;
+
+            case 8:
+                n = garage_longest_parked(&g, LONGEST_PARKED_SHOWN, longest);
+                if (n == 0) printf("No vehicles inside.\n");
+                for (int i = 0; i < n; ++i) {
+                    printf("%d. %s since %02d:%02d\n", i + 1, longest[i]->license_plate,
+                           longest[i]->entry_time.hour, longest[i]->entry_time.minute);
+                }
+                break;
+
+            case 9:
+                printf("Time (HH:MM): ");
+                fgets(time_str, sizeof(time_str), stdin);
+                t = parse_time(time_str);
+                if (!time_valid(t)) {
+                    printf("Invalid time, expected HH:MM.\n");
+                    break;
+                }
+
+                n = garage_inside_at(&g, t, inside, GARAGE_CAPACITY);
+                printf("%d vehicle(s) inside at %02d:%02d:\n", n, t.hour, t.minute);
+                for (int i = 0; i < n; ++i) printf("- %s\n", inside[i]->license_plate);
+                break;
+
             default:
                 printf("Invalid choice.\n");
         }
+
+        if (feed) occupancy_feed_publish(feed, &g);
     }
 
+    close_replication(replica);
+    occupancy_feed_close(feed);
+    bay_map_destroy(bays);
+    free_garage(&g);
     return 0;
 }
\ No newline at end of file
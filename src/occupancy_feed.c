@@ -0,0 +1,169 @@
+/**
+ * @file occupancy_feed.c
+ * @brief Implements the shared-memory occupancy feed.
+ *
+ * The segment holds a header with a magic number and a sequence counter
+ * followed by the snapshot. The writer makes the counter odd, copies the new
+ * snapshot in and makes it even again. A reader copies the snapshot between
+ * two loads of the counter and retries if the counter was odd or changed,
+ * so readers never block the writer and never see a torn update.
+ *
+ * The magic number changes whenever the snapshot layout does, and readers
+ * also check the segment size, so a reader built for another layout refuses
+ * the segment instead of misreading it.
+ */
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "occupancy_feed.h"
+#include "garage.h"
+#include "bay_map.h"
+
+#define FEED_MAGIC 0x47415232u // "GAR2": layout 2 added class_free
+
+/// @brief Layout of the shared memory segment
+typedef struct {
+    uint32_t magic;
+    atomic_uint seq;
+    OccupancySnapshot data;
+} FeedSegment;
+
+struct OccupancyFeed {
+    FeedSegment *seg;
+    int writer;
+    char name[64];
+};
+
+/**
+ * @brief Creates (or replaces) a feed segment for writing.
+ *
+ * @param name Shared memory object name
+ * @return Feed handle, or NULL on failure
+ */
+OccupancyFeed *occupancy_feed_create(const char *name) {
+    if (strlen(name) >= sizeof(((OccupancyFeed *)0)->name)) return NULL;
+
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) return NULL;
+    if (ftruncate(fd, sizeof(FeedSegment)) != 0) {
+        close(fd);
+        return NULL;
+    }
+    FeedSegment *seg = mmap(NULL, sizeof(FeedSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED) return NULL;
+
+    OccupancyFeed *f = calloc(1, sizeof(OccupancyFeed));
+    if (!f) {
+        munmap(seg, sizeof(FeedSegment));
+        return NULL;
+    }
+    f->seg = seg;
+    f->writer = 1;
+    strcpy(f->name, name);
+
+    memset(&seg->data, 0, sizeof(seg->data));
+    atomic_store_explicit(&seg->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    seg->magic = FEED_MAGIC;
+    return f;
+}
+
+/**
+ * @brief Publishes the current garage state.
+ *
+ * @param f Feed handle
+ * @param g Pointer to the Garage structure
+ */
+void occupancy_feed_publish(OccupancyFeed *f, const Garage *g) {
+    OccupancySnapshot snap;
+    memset(&snap, 0, sizeof(snap));
+    snap.capacity = GARAGE_CAPACITY;
+    snap.occupied = current_occupancy(g);
+    snap.free_spots = snap.capacity - snap.occupied;
+    snap.total_served = g->total_served;
+    snap.revenue_cents = g->revenue_cents;
+    if (g->bays) {
+        // One zone per parking level
+        snap.zone_count = bay_map_levels(g->bays) < FEED_MAX_ZONES ? bay_map_levels(g->bays) : FEED_MAX_ZONES;
+        for (int z = 0; z < snap.zone_count; ++z) snap.zone_free[z] = bay_map_level_free(g->bays, z);
+    } else {
+        snap.zone_count = 1;
+        snap.zone_free[0] = snap.free_spots;
+    }
+    for (int c = 0; c < VEHICLE_CLASS_COUNT; ++c) snap.class_free[c] = class_free_spots(g, (VehicleClass)c);
+    snap.updates = f->seg->data.updates + 1;
+
+    FeedSegment *seg = f->seg;
+    unsigned seq = atomic_load_explicit(&seg->seq, memory_order_relaxed);
+    atomic_store_explicit(&seg->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&seg->data, &snap, sizeof(snap));
+    atomic_store_explicit(&seg->seq, seq + 2, memory_order_release);
+}
+
+/**
+ * @brief Opens an existing feed segment for reading.
+ *
+ * @param name Shared memory object name
+ * @return Feed handle, or NULL if missing, of another size or of another layout
+ */
+OccupancyFeed *occupancy_feed_open(const char *name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size != (off_t)sizeof(FeedSegment)) {
+        close(fd);
+        return NULL;
+    }
+    FeedSegment *seg = mmap(NULL, sizeof(FeedSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED) return NULL;
+
+    if (seg->magic != FEED_MAGIC) {
+        munmap(seg, sizeof(FeedSegment));
+        return NULL;
+    }
+
+    OccupancyFeed *f = calloc(1, sizeof(OccupancyFeed));
+    if (!f) {
+        munmap(seg, sizeof(FeedSegment));
+        return NULL;
+    }
+    f->seg = seg;
+    return f;
+}
+
+/**
+ * @brief Copies a consistent snapshot from the feed.
+ *
+ * @param f Feed handle
+ * @param out Output snapshot
+ */
+void occupancy_feed_read(const OccupancyFeed *f, OccupancySnapshot *out) {
+    FeedSegment *seg = f->seg;
+    unsigned before, after;
+    do {
+        before = atomic_load_explicit(&seg->seq, memory_order_acquire);
+        memcpy(out, &seg->data, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&seg->seq, memory_order_relaxed);
+    } while ((before & 1u) || before != after);
+}
+
+/**
+ * @brief Unmaps the feed; the writer also removes the segment name.
+ *
+ * @param f Feed handle (may be NULL)
+ */
+void occupancy_feed_close(OccupancyFeed *f) {
+    if (!f) return;
+    munmap(f->seg, sizeof(FeedSegment));
+    if (f->writer) shm_unlink(f->name);
+    free(f);
+}
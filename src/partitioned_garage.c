@@ -0,0 +1,342 @@
+/**
+ * @file partitioned_garage.c
+ * @brief Implements the plate-partitioned garage on a consistent-hash ring.
+ *
+ * The ring holds PARTITION_VNODES pseudo-random points per shard, sorted by
+ * position. A plate belongs to the first point at or after its own (mixed)
+ * hash, so adding or removing a shard only moves the plates between its
+ * points and their predecessors. Admission reserves a place in the global
+ * atomic counter with a compare-and-swap before locking the owning shard,
+ * and gives it back if the shard rejects the entry.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "partitioned_garage.h"
+#include "functions.h"
+#include "garage.h"
+#include "spsc_ring.h"
+
+/// @brief One point of the hash ring
+typedef struct {
+    uint64_t pos;
+    int shard;
+} RingPoint;
+
+/// @brief A shard, padded so shard locks never share a cache line
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) pthread_mutex_t lock;
+    Garage *g;
+} Shard;
+
+struct PartitionedGarage {
+    int shards;
+    int capacity;  ///< Admission limit: the requested capacity, capped by the shards' records
+    int requested; ///< Capacity asked for at creation
+    Shard *shard;
+    RingPoint *ring; ///< shards * PARTITION_VNODES points, sorted by pos
+    int carried_served;     ///< Served count the moved records did not reproduce in the new shards
+    int64_t carried_revenue_cents; ///< Revenue the moved records did not reproduce, in cents
+    _Alignas(CACHE_LINE_SIZE) atomic_int inside;
+};
+
+/**
+ * @brief Spreads the bits of a hash over the ring (splitmix64 finalizer).
+ */
+static uint64_t ring_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+static int compare_points(const void *a, const void *b) {
+    const RingPoint *pa = a, *pb = b;
+    if (pa->pos != pb->pos) return pa->pos < pb->pos ? -1 : 1;
+    return pa->shard - pb->shard;
+}
+
+static RingPoint *build_ring(int shards) {
+    RingPoint *ring = malloc(sizeof(RingPoint) * (size_t)shards * PARTITION_VNODES);
+    if (!ring) return NULL;
+    for (int s = 0; s < shards; ++s) {
+        for (int v = 0; v < PARTITION_VNODES; ++v) {
+            ring[s * PARTITION_VNODES + v].pos = ring_mix(((uint64_t)s << 32) | (uint64_t)v);
+            ring[s * PARTITION_VNODES + v].shard = s;
+        }
+    }
+    qsort(ring, (size_t)shards * PARTITION_VNODES, sizeof(RingPoint), compare_points);
+    return ring;
+}
+
+static int ring_owner(const RingPoint *ring, int shards, const char *plate) {
+    uint64_t pos = ring_mix(plate_hash(plate));
+    int lo = 0, hi = shards * PARTITION_VNODES;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (ring[mid].pos < pos) lo = mid + 1;
+        else hi = mid;
+    }
+    return ring[lo == shards * PARTITION_VNODES ? 0 : lo].shard;
+}
+
+static Shard *alloc_shards(int shards) {
+    Shard *shard = aligned_alloc(CACHE_LINE_SIZE, sizeof(Shard) * (size_t)shards);
+    if (!shard) return NULL;
+    memset(shard, 0, sizeof(Shard) * (size_t)shards);
+    for (int s = 0; s < shards; ++s) {
+        shard[s].g = malloc(sizeof(Garage));
+        if (!shard[s].g) {
+            for (int i = 0; i < s; ++i) free(shard[i].g);
+            free(shard);
+            return NULL;
+        }
+        init_garage(shard[s].g);
+        pthread_mutex_init(&shard[s].lock, NULL);
+    }
+    return shard;
+}
+
+static void free_shards(Shard *shard, int shards) {
+    if (!shard) return;
+    for (int s = 0; s < shards; ++s) {
+        pthread_mutex_destroy(&shard[s].lock);
+        free_garage(shard[s].g);
+        free(shard[s].g);
+    }
+    free(shard);
+}
+
+/**
+ * @brief Creates a partitioned garage.
+ *
+ * @param shards Number of shards
+ * @param capacity Vehicles admitted at once
+ * @return Handle, or NULL on failure
+ */
+PartitionedGarage *partitioned_garage_create(int shards, int capacity) {
+    if (shards <= 0 || capacity <= 0) return NULL;
+    PartitionedGarage *pg = aligned_alloc(CACHE_LINE_SIZE, sizeof(PartitionedGarage));
+    if (!pg) return NULL;
+    memset(pg, 0, sizeof(*pg));
+
+    pg->shards = shards;
+    pg->requested = capacity;
+    pg->capacity = capacity < shards * GARAGE_CAPACITY ? capacity : shards * GARAGE_CAPACITY;
+    pg->shard = alloc_shards(shards);
+    pg->ring = build_ring(shards);
+    if (!pg->shard || !pg->ring) {
+        partitioned_garage_destroy(pg);
+        return NULL;
+    }
+    return pg;
+}
+
+/**
+ * @brief Frees a partitioned garage.
+ *
+ * @param pg Handle (may be NULL)
+ */
+void partitioned_garage_destroy(PartitionedGarage *pg) {
+    if (!pg) return;
+    free_shards(pg->shard, pg->shards);
+    free(pg->ring);
+    free(pg);
+}
+
+/**
+ * @brief Returns the shard owning a plate.
+ *
+ * @param pg Handle
+ * @param plate License plate
+ * @return Shard index
+ */
+int partitioned_garage_shard_of(const PartitionedGarage *pg, const char *plate) {
+    return ring_owner(pg->ring, pg->shards, plate);
+}
+
+/**
+ * @brief Registers a vehicle entering the site.
+ *
+ * @param pg Handle
+ * @param plate License plate
+ * @param time Entry time
+ * @param cls Vehicle class
+ * @return 0 if success, -1 if full, -2 if the plate is already inside
+ */
+int partitioned_garage_entry(PartitionedGarage *pg, const char *plate, Time time, VehicleClass cls) {
+    int inside = atomic_load_explicit(&pg->inside, memory_order_relaxed);
+    do {
+        if (inside >= pg->capacity) return -1;
+    } while (!atomic_compare_exchange_weak_explicit(&pg->inside, &inside, inside + 1,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    Shard *s = &pg->shard[ring_owner(pg->ring, pg->shards, plate)];
+    pthread_mutex_lock(&s->lock);
+    int result = register_entry_class(s->g, plate, time, cls, NULL);
+    pthread_mutex_unlock(&s->lock);
+
+    if (result != 0) atomic_fetch_sub_explicit(&pg->inside, 1, memory_order_relaxed);
+    return result;
+}
+
+/**
+ * @brief Logs the exit of a vehicle.
+ *
+ * @param pg Handle
+ * @param plate License plate
+ * @param time Exit time
+ * @return Fee if success, -1 if the vehicle is not inside
+ */
+int partitioned_garage_exit(PartitionedGarage *pg, const char *plate, Time time) {
+    Shard *s = &pg->shard[ring_owner(pg->ring, pg->shards, plate)];
+    pthread_mutex_lock(&s->lock);
+    int fee = log_exit(s->g, plate, time);
+    pthread_mutex_unlock(&s->lock);
+
+    // -1 is log_exit()'s only failure; every other value means the shard recorded the exit
+    if (fee != -1) atomic_fetch_sub_explicit(&pg->inside, 1, memory_order_relaxed);
+    return fee;
+}
+
+static int match_plate(const Vehicle *v, void *ctx) {
+    return strcmp(v->license_plate, ctx) == 0;
+}
+
+static int copy_vehicle(const Vehicle *v, void *ctx) {
+    *(Vehicle *)ctx = *v;
+    return 1;
+}
+
+/**
+ * @brief Copies the record of a vehicle that is inside.
+ *
+ * @param pg Handle
+ * @param plate License plate
+ * @param out Receives the record
+ * @return 0 if found, -1 if the plate is not inside
+ */
+int partitioned_garage_find(PartitionedGarage *pg, const char *plate, Vehicle *out) {
+    VehicleFilter filter;
+    vehicle_filter_init(&filter, VEHICLES_ACTIVE);
+    filter.match = match_plate;
+    filter.match_ctx = (void *)plate;
+
+    Shard *s = &pg->shard[ring_owner(pg->ring, pg->shards, plate)];
+    pthread_mutex_lock(&s->lock);
+    int found = garage_for_each(s->g, &filter, copy_vehicle, out);
+    pthread_mutex_unlock(&s->lock);
+    return found > 0 ? 0 : -1;
+}
+
+/**
+ * @brief Vehicles currently inside.
+ *
+ * @param pg Handle
+ * @return Vehicles inside
+ */
+int partitioned_garage_occupancy(const PartitionedGarage *pg) {
+    return atomic_load_explicit(&pg->inside, memory_order_relaxed);
+}
+
+/**
+ * @brief Sums the counters of all shards.
+ *
+ * @param pg Handle
+ * @param stats Output totals
+ */
+void partitioned_garage_stats(PartitionedGarage *pg, PartitionStats *stats) {
+    stats->shards = pg->shards;
+    stats->capacity = pg->capacity;
+    stats->inside = partitioned_garage_occupancy(pg);
+    stats->served = pg->carried_served;
+    stats->revenue_cents = pg->carried_revenue_cents;
+    for (int i = 0; i < pg->shards; ++i) {
+        pthread_mutex_lock(&pg->shard[i].lock);
+        stats->served += pg->shard[i].g->total_served;
+        stats->revenue_cents += pg->shard[i].g->revenue_cents;
+        pthread_mutex_unlock(&pg->shard[i].lock);
+    }
+}
+
+/**
+ * @brief Re-registers a record in its shard on a new ring.
+ *
+ * @return 0 on success, -1 if the new shard rejected it
+ */
+static int move_record(Shard *shard, const RingPoint *ring, int shards, const Vehicle *v) {
+    Garage *g = shard[ring_owner(ring, shards, v->license_plate)].g;
+    Ticket ticket;
+    if (register_entry_class(g, v->license_plate, v->entry_time, (VehicleClass)v->vehicle_class, &ticket) != 0) {
+        return -1;
+    }
+    if (v->has_exited && log_exit_by_ticket(g, ticket, v->exit_time) < 0) return -1;
+    return 0;
+}
+
+/**
+ * @brief Changes the number of shards, moving the records to their new owners.
+ *
+ * Exited records, archived stays included, are moved before the vehicles
+ * still inside, so a plate that came back later is never rejected as a
+ * duplicate of itself.
+ *
+ * @param pg Handle
+ * @param shards New number of shards
+ * @param moved Receives the number of records that changed shard (may be NULL)
+ * @return 0 on success, -1 if the shards cannot hold the records
+ */
+int partitioned_garage_rebalance(PartitionedGarage *pg, int shards, int *moved) {
+    if (shards <= 0 || partitioned_garage_occupancy(pg) > shards * GARAGE_CAPACITY) return -1;
+    Shard *shard = alloc_shards(shards);
+    RingPoint *ring = build_ring(shards);
+    if (!shard || !ring) {
+        free_shards(shard, shards);
+        free(ring);
+        return -1;
+    }
+
+    int changed = 0;
+    int served = 0;
+    int64_t revenue_cents = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int s = 0; s < pg->shards; ++s) {
+            VehicleIterator it;
+            VehicleFilter filter;
+            const Vehicle *v;
+            vehicle_filter_init(&filter, pass == 0 ? VEHICLES_EXITED : VEHICLES_ACTIVE);
+            vehicle_iter_init(&it, pg->shard[s].g, &filter);
+            while ((v = vehicle_iter_next(&it)) != NULL) {
+                if (move_record(shard, ring, shards, v) != 0) {
+                    free_shards(shard, shards);
+                    free(ring);
+                    return -1;
+                }
+                if (ring_owner(ring, shards, v->license_plate) != s) changed++;
+            }
+        }
+    }
+    for (int s = 0; s < pg->shards; ++s) {
+        served += pg->shard[s].g->total_served;
+        revenue_cents += pg->shard[s].g->revenue_cents;
+    }
+    for (int s = 0; s < shards; ++s) {
+        served -= shard[s].g->total_served;
+        revenue_cents -= shard[s].g->revenue_cents;
+    }
+
+    free_shards(pg->shard, pg->shards);
+    free(pg->ring);
+    pg->shard = shard;
+    pg->ring = ring;
+    pg->capacity = pg->requested < shards * GARAGE_CAPACITY ? pg->requested : shards * GARAGE_CAPACITY;
+    pg->shards = shards;
+    pg->carried_served += served;
+    pg->carried_revenue_cents += revenue_cents;
+    if (moved) *moved = changed;
+    return 0;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file plate_index.c
+ * @brief Implements the plate-to-slot hash index.
+ *
+ * Linear probing over a power-of-two table. The stored hash lets probes skip
+ * non-matching buckets without comparing plates, and deletion shifts later
+ * entries of the same probe run back instead of leaving tombstones, so the
+ * table never degrades over a long day of entries and exits.
+ */
+
+#include <string.h>
+#include "plate_index.h"
+
+#define PLATE_INDEX_MASK (PLATE_INDEX_SIZE - 1)
+
+/**
+ * @brief Finds the slot indexed for a plate.
+ *
+ * @param idx Index
+ * @param plates Start of the first record's plate
+ * @param plate_stride Bytes between the plates of consecutive records
+ * @param plate Plate to look up
+ * @param hash Hash of plate
+ * @return Record slot, or -1 if not indexed
+ */
+int plate_index_find(const PlateIndex *idx, const char *plates, size_t plate_stride,
+                     const char *plate, uint64_t hash) {
+    uint32_t h = (uint32_t)hash;
+    for (uint32_t i = h & PLATE_INDEX_MASK;; i = (i + 1) & PLATE_INDEX_MASK) {
+        const PlateIndexEntry *e = &idx->entries[i];
+        if (e->slot_plus_one == 0) return -1;
+        if (e->hash != h) continue;
+
+        int slot = e->slot_plus_one - 1;
+        if (strcmp(plates + (size_t)slot * plate_stride, plate) == 0) return slot;
+    }
+}
+
+/**
+ * @brief Adds a plate's slot to the index.
+ *
+ * @param idx Index
+ * @param hash Hash of the plate stored in slot
+ * @param slot Record slot
+ */
+void plate_index_insert(PlateIndex *idx, uint64_t hash, int slot) {
+    uint32_t h = (uint32_t)hash;
+    uint32_t i = h & PLATE_INDEX_MASK;
+    while (idx->entries[i].slot_plus_one != 0) i = (i + 1) & PLATE_INDEX_MASK;
+    idx->entries[i].hash = h;
+    idx->entries[i].slot_plus_one = slot + 1;
+}
+
+/**
+ * @brief Removes a slot from the index.
+ *
+ * @param idx Index
+ * @param hash Hash of the plate stored in slot
+ * @param slot Record slot
+ * @return 1 if removed, 0 if the slot was not indexed
+ */
+int plate_index_remove(PlateIndex *idx, uint64_t hash, int slot) {
+    uint32_t h = (uint32_t)hash;
+    uint32_t i = h & PLATE_INDEX_MASK;
+    for (;; i = (i + 1) & PLATE_INDEX_MASK) {
+        if (idx->entries[i].slot_plus_one == 0) return 0;
+        if (idx->entries[i].slot_plus_one == slot + 1) break;
+    }
+
+    // Backward-shift: move later entries of the run into the hole if their
+    // home bucket does not lie between the hole and their current bucket
+    uint32_t hole = i;
+    for (uint32_t j = (i + 1) & PLATE_INDEX_MASK; idx->entries[j].slot_plus_one != 0;
+         j = (j + 1) & PLATE_INDEX_MASK) {
+        uint32_t home = idx->entries[j].hash & PLATE_INDEX_MASK;
+        if (((j - home) & PLATE_INDEX_MASK) >= ((j - hole) & PLATE_INDEX_MASK)) {
+            idx->entries[hole] = idx->entries[j];
+            hole = j;
+        }
+    }
+    idx->entries[hole].slot_plus_one = 0;
+    idx->entries[hole].hash = 0;
+    return 1;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file reorder.c
+ * @brief Implements the event-time reorder buffer.
+ *
+ * Events wait in a binary min-heap until their time is at or below the
+ * watermark, i.e. the latest time seen minus the allowed lateness. An event
+ * older than one already applied can no longer be put in order; it is
+ * counted as late and applied at once rather than lost.
+ */
+
+#include <string.h>
+#include "reorder.h"
+#include "functions.h"
+#include "garage.h"
+
+/**
+ * @brief Initializes a reorder buffer.
+ *
+ * @param rb Reorder buffer
+ * @param g Garage to apply events to
+ * @param lateness_minutes Allowed lateness in minutes
+ */
+void reorder_init(ReorderBuffer *rb, Garage *g, int lateness_minutes) {
+    memset(rb, 0, sizeof(*rb));
+    rb->g = g;
+    rb->lateness = lateness_minutes < 0 ? 0 : lateness_minutes;
+    rb->max_seen = -1;
+    rb->applied_upto = -1;
+}
+
+/**
+ * @brief Installs a handler receiving the result of every applied event.
+ *
+ * @param rb Reorder buffer
+ * @param handler Result handler, or NULL
+ * @param ctx Context passed to the handler
+ */
+void reorder_set_handler(ReorderBuffer *rb, ReorderHandler handler, void *ctx) {
+    rb->handler = handler;
+    rb->handler_ctx = ctx;
+}
+
+/**
+ * @brief Heap order: earlier time first, then entries before other events
+ *        at the same minute, then arrival order.
+ */
+static int item_before(const ReorderItem *a, const ReorderItem *b) {
+    int ta = time_to_minutes(a->ev.time);
+    int tb = time_to_minutes(b->ev.time);
+    if (ta != tb) return ta < tb;
+    int ea = a->ev.type == EVENT_ENTRY;
+    int eb = b->ev.type == EVENT_ENTRY;
+    if (ea != eb) return ea;
+    return (int32_t)(a->seq - b->seq) < 0;
+}
+
+static void heap_push(ReorderBuffer *rb, const ReorderItem *item) {
+    int i = rb->size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!item_before(item, &rb->heap[parent])) break;
+        rb->heap[i] = rb->heap[parent];
+        i = parent;
+    }
+    rb->heap[i] = *item;
+}
+
+static void heap_pop(ReorderBuffer *rb, ReorderItem *out) {
+    *out = rb->heap[0];
+    ReorderItem last = rb->heap[--rb->size];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= rb->size) break;
+        if (child + 1 < rb->size && item_before(&rb->heap[child + 1], &rb->heap[child])) child++;
+        if (!item_before(&rb->heap[child], &last)) break;
+        rb->heap[i] = rb->heap[child];
+        i = child;
+    }
+    rb->heap[i] = last;
+}
+
+static void apply_item(ReorderBuffer *rb, const ReorderItem *item) {
+    int result = apply_gate_event(rb->g, &item->ev);
+    rb->stats.applied++;
+    if (result < 0) rb->stats.dropped++;
+    if (rb->handler) rb->handler(rb->handler_ctx, item->source, &item->ev, result);
+}
+
+/**
+ * @brief Applies the earliest buffered event.
+ */
+static void release_one(ReorderBuffer *rb) {
+    ReorderItem item;
+    heap_pop(rb, &item);
+    int t = time_to_minutes(item.ev.time);
+    if (t > rb->applied_upto) rb->applied_upto = t;
+    apply_item(rb, &item);
+}
+
+/**
+ * @brief Adds an event and applies every event the watermark has passed.
+ *
+ * @param rb Reorder buffer
+ * @param source Caller-defined origin passed to the handler
+ * @param ev Event
+ * @return Number of events applied by this call
+ */
+int reorder_push(ReorderBuffer *rb, int source, const GateEvent *ev) {
+    ReorderItem item;
+    item.ev = *ev;
+    item.source = source;
+    item.seq = rb->next_seq++;
+    rb->stats.pushed++;
+
+    int t = time_to_minutes(ev->time);
+    if (t < rb->applied_upto) {
+        rb->stats.late++;
+        apply_item(rb, &item);
+        return 1;
+    }
+
+    int applied = 0;
+    if (rb->size == REORDER_CAPACITY) {
+        rb->stats.forced++;
+        release_one(rb);
+        applied++;
+    }
+    heap_push(rb, &item);
+    if (rb->size > rb->stats.max_depth) rb->stats.max_depth = rb->size;
+    if (t > rb->max_seen) rb->max_seen = t;
+
+    int watermark = rb->max_seen - rb->lateness;
+    while (rb->size > 0 && time_to_minutes(rb->heap[0].ev.time) <= watermark) {
+        release_one(rb);
+        applied++;
+    }
+    return applied;
+}
+
+/**
+ * @brief Applies all buffered events in time order.
+ *
+ * @param rb Reorder buffer
+ * @return Number of events applied
+ */
+int reorder_flush(ReorderBuffer *rb) {
+    int applied = 0;
+    while (rb->size > 0) {
+        release_one(rb);
+        applied++;
+    }
+    return applied;
+}
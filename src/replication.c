@@ -0,0 +1,584 @@
+/**
+ * @file replication.c
+ * @brief Implements log shipping between a primary garage and a warm standby.
+ *
+ * The primary keeps the unacknowledged events in a circular log guarded by
+ * a mutex; the garage thread only copies an event in and signals the
+ * sender. The sender is stop-and-wait: it ships everything logged since
+ * the last acknowledgement (up to REPL_BATCH events) as one frame, then
+ * waits for the acknowledgement. Events logged meanwhile simply make the
+ * next batch larger, so a busy primary sends fewer, larger writes.
+ *
+ * A frame is a ReplFrame header followed by its ReplEvents, and an
+ * acknowledgement is a ReplAck. Fields use host byte order, since both
+ * sides run on the same machine.
+ *
+ * Every Replicator ships under its own epoch, so a standby can tell a
+ * restarted primary (whose sequence numbers start again at 1) from a
+ * resend. Once the primary's log overflows, the stream is broken: nothing
+ * more is logged, and the frame that ships the last logged event says so.
+ * A standby that learns it cannot be current any more (a broken stream, a
+ * gap, a different primary after it applied events, or an event its garage
+ * refuses) marks itself diverged, applies nothing more, and refuses
+ * promotion.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "replication.h"
+#include "garage.h"
+
+#define REPL_MAGIC 0x5245504cu // "REPL"
+#define REPL_RETRY_MS 100
+#define REPL_ACK_TIMEOUT_MS 2000
+
+/// Frame flag: the primary lost events after this frame's last one
+#define REPL_FRAME_BROKEN 1u
+
+/// Acknowledgement status: the standby can no longer follow this primary
+#define REPL_ACK_DIVERGED 1u
+
+/// @brief Header of a batch of events
+typedef struct {
+    uint32_t magic;
+    uint32_t count;     ///< Events following the header
+    uint32_t flags;     ///< REPL_FRAME_* bits
+    uint32_t reserved;
+    uint64_t epoch;     ///< Identifies the primary's log; sequence numbers restart with every epoch
+    uint64_t first_seq; ///< Sequence number of the first event
+} ReplFrame;
+
+/// @brief Acknowledgement of the standby
+typedef struct {
+    uint32_t magic;
+    uint32_t status;    ///< 0, or REPL_ACK_DIVERGED
+    uint64_t acked_seq; ///< Newest sequence number applied
+} ReplAck;
+
+struct Replicator {
+    char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    ReplEvent *log;     ///< Event with sequence number n is at (n - 1) % capacity
+    uint64_t *stamp_ns; ///< Append time of each logged event
+    size_t capacity;
+    pthread_mutex_t lock;
+    pthread_cond_t changed; ///< Signalled on append, acknowledgement and stop
+    pthread_t sender;
+    int stop;
+    int fd;
+    uint64_t epoch;
+    int broken_sent; ///< The broken flag reached the standby on the current connection
+    ReplicationStats stats; ///< Guarded by lock (lag fields are computed on read)
+    ReplEvent batch[REPL_BATCH]; ///< Batch being shipped, used by the sender thread only
+};
+
+struct Standby {
+    Garage *g;
+    int listen_fd;
+    int stop_fd;
+    int conn_fd;
+    char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    ReplEvent batch[REPL_BATCH];
+    uint64_t epoch; ///< Epoch of the primary followed, 0 before the first frame
+    atomic_int diverged;
+    atomic_uint_fast64_t applied_seq;
+    atomic_uint_fast64_t batches;
+    atomic_uint_fast64_t rejected;
+    atomic_int connected;
+};
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void deadline_after_ms(struct timespec *ts, int ms) {
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * @brief Writes all of an iovec array, without raising SIGPIPE.
+ *
+ * @return 0 on success, -1 if the connection failed
+ */
+static int send_all(int fd, struct iovec *iov, int iovcnt) {
+    while (iovcnt > 0) {
+        struct msghdr msg = {0};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t)iovcnt;
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        while (iovcnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Reads exactly len bytes, waiting at most timeout_ms for each chunk.
+ *
+ * @return 0 on success, -1 on timeout, error or disconnect
+ */
+static int recv_all(int fd, void *buf, size_t len, int timeout_ms) {
+    char *p = buf;
+    while (len > 0) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, timeout_ms);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready <= 0) return -1;
+
+        ssize_t n = recv(fd, p, len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int connect_standby(const char *path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Ships one batch and waits for its acknowledgement.
+ *
+ * Called with the lock held; the lock is released during network I/O. On a
+ * broken stream, the batch that reaches the end of the log carries the
+ * broken flag (with no events left, it is an empty frame).
+ *
+ * @return 0 on success, -1 if the connection failed
+ */
+static int ship_batch(Replicator *r) {
+    ReplEvent *batch = r->batch;
+    ReplicationStats *st = &r->stats;
+
+    uint64_t first = st->acked + 1;
+    uint64_t pending = st->appended - st->acked;
+    uint32_t count = pending < REPL_BATCH ? (uint32_t)pending : REPL_BATCH;
+    for (uint32_t i = 0; i < count; ++i) batch[i] = r->log[(first - 1 + i) % r->capacity];
+    uint32_t flags = st->broken && count == pending ? REPL_FRAME_BROKEN : 0;
+    int fd = r->fd;
+    pthread_mutex_unlock(&r->lock);
+
+    ReplFrame frame = {REPL_MAGIC, count, flags, 0, r->epoch, first};
+    struct iovec iov[2] = {{&frame, sizeof(frame)}, {batch, sizeof(ReplEvent) * count}};
+    uint64_t start = monotonic_ns();
+    ReplAck ack;
+    int ok = send_all(fd, iov, 2) == 0 && recv_all(fd, &ack, sizeof(ack), REPL_ACK_TIMEOUT_MS) == 0 &&
+             ack.magic == REPL_MAGIC && ((ack.status & REPL_ACK_DIVERGED) ||
+                                         (ack.acked_seq >= first - 1 && ack.acked_seq < first + count));
+    uint64_t latency = monotonic_ns() - start;
+
+    pthread_mutex_lock(&r->lock);
+    if (!ok) return -1;
+    if (ack.status & REPL_ACK_DIVERGED) {
+        // The standby will not apply anything more from us: stop shipping
+        st->broken = 1;
+        st->standby_diverged = 1;
+        r->broken_sent = 1;
+        st->acked = st->appended;
+    } else if (ack.acked_seq > st->acked) {
+        st->acked = ack.acked_seq;
+    }
+    if (flags & REPL_FRAME_BROKEN) r->broken_sent = 1;
+    st->batches++;
+    st->last_ack_latency_ns = latency;
+    if (latency > st->max_ack_latency_ns) st->max_ack_latency_ns = latency;
+    pthread_cond_broadcast(&r->changed);
+    return 0;
+}
+
+static void *sender_thread(void *arg) {
+    Replicator *r = arg;
+    struct timespec deadline;
+
+    pthread_mutex_lock(&r->lock);
+    while (!r->stop) {
+        if (r->fd < 0) {
+            pthread_mutex_unlock(&r->lock);
+            int fd = connect_standby(r->path);
+            pthread_mutex_lock(&r->lock);
+            if (fd < 0) {
+                deadline_after_ms(&deadline, REPL_RETRY_MS);
+                pthread_cond_timedwait(&r->changed, &r->lock, &deadline);
+                continue;
+            }
+            r->fd = fd;
+            r->broken_sent = 0;
+            r->stats.connected = 1;
+            r->stats.reconnects++;
+        }
+        if (r->stats.acked == r->stats.appended && !(r->stats.broken && !r->broken_sent)) {
+            deadline_after_ms(&deadline, REPL_RETRY_MS);
+            pthread_cond_timedwait(&r->changed, &r->lock, &deadline);
+            continue;
+        }
+        if (ship_batch(r) != 0) {
+            close(r->fd);
+            r->fd = -1;
+            r->stats.connected = 0;
+            deadline_after_ms(&deadline, REPL_RETRY_MS);
+            pthread_cond_timedwait(&r->changed, &r->lock, &deadline);
+        }
+    }
+    pthread_mutex_unlock(&r->lock);
+    return NULL;
+}
+
+/**
+ * @brief Starts shipping to a standby.
+ *
+ * @param standby_path Socket path the standby listens on
+ * @param log_capacity Unacknowledged events kept before new ones are dropped
+ * @return Replicator handle, or NULL on failure
+ */
+Replicator *replicator_create(const char *standby_path, size_t log_capacity) {
+    if (log_capacity == 0 || strlen(standby_path) >= sizeof(((struct sockaddr_un *)0)->sun_path)) return NULL;
+
+    Replicator *r = calloc(1, sizeof(Replicator));
+    if (!r) return NULL;
+    strcpy(r->path, standby_path);
+    r->capacity = log_capacity;
+    r->fd = -1;
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    r->epoch = ((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec) | 1u; // never 0
+    r->log = malloc(sizeof(ReplEvent) * log_capacity);
+    r->stamp_ns = malloc(sizeof(uint64_t) * log_capacity);
+    if (!r->log || !r->stamp_ns) goto fail;
+
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->changed, NULL);
+    if (pthread_create(&r->sender, NULL, sender_thread, r) != 0) {
+        pthread_cond_destroy(&r->changed);
+        pthread_mutex_destroy(&r->lock);
+        goto fail;
+    }
+    return r;
+
+fail:
+    free(r->log);
+    free(r->stamp_ns);
+    free(r);
+    return NULL;
+}
+
+/**
+ * @brief Appends an event to the log.
+ *
+ * An event that does not fit breaks the stream: the standby can no longer
+ * be made current from the log, so this and every later event is dropped
+ * and the standby is told once it has received what was logged.
+ *
+ * @param r Replicator
+ * @param ev Applied event and the ticket of the record it changed
+ * @return 0 on success, -1 if the log is full or the stream is broken
+ */
+int replicator_append(Replicator *r, const ReplEvent *ev) {
+    pthread_mutex_lock(&r->lock);
+    if (r->stats.broken || r->stats.appended - r->stats.acked >= r->capacity) {
+        r->stats.broken = 1;
+        r->stats.dropped++;
+        pthread_cond_broadcast(&r->changed);
+        pthread_mutex_unlock(&r->lock);
+        return -1;
+    }
+    size_t at = r->stats.appended % r->capacity;
+    r->log[at] = *ev;
+    r->stamp_ns[at] = monotonic_ns();
+    r->stats.appended++;
+    pthread_cond_broadcast(&r->changed);
+    pthread_mutex_unlock(&r->lock);
+    return 0;
+}
+
+/**
+ * @brief Waits until the standby acknowledged every event appended so far.
+ *
+ * @param r Replicator
+ * @param timeout_ms Maximum wait in milliseconds
+ * @return 0 if caught up, -1 on timeout or if the stream is broken
+ */
+int replicator_sync(Replicator *r, int timeout_ms) {
+    struct timespec deadline;
+    deadline_after_ms(&deadline, timeout_ms);
+
+    pthread_mutex_lock(&r->lock);
+    uint64_t target = r->stats.appended;
+    int result = 0;
+    while (r->stats.acked < target) {
+        if (pthread_cond_timedwait(&r->changed, &r->lock, &deadline) == ETIMEDOUT) {
+            result = r->stats.acked < target ? -1 : 0;
+            break;
+        }
+    }
+    if (r->stats.broken) result = -1;
+    pthread_mutex_unlock(&r->lock);
+    return result;
+}
+
+/**
+ * @brief Copies the primary's replication counters.
+ *
+ * @param r Replicator
+ * @param stats Output counters
+ */
+void replicator_get_stats(Replicator *r, ReplicationStats *stats) {
+    pthread_mutex_lock(&r->lock);
+    *stats = r->stats;
+    stats->lag_events = r->stats.appended - r->stats.acked;
+    stats->lag_ns = 0;
+    if (stats->lag_events > 0) stats->lag_ns = monotonic_ns() - r->stamp_ns[r->stats.acked % r->capacity];
+    pthread_mutex_unlock(&r->lock);
+}
+
+/**
+ * @brief Stops the sender thread and frees the replicator.
+ *
+ * @param r Replicator (may be NULL)
+ */
+void replicator_destroy(Replicator *r) {
+    if (!r) return;
+    pthread_mutex_lock(&r->lock);
+    r->stop = 1;
+    pthread_cond_broadcast(&r->changed);
+    pthread_mutex_unlock(&r->lock);
+    pthread_join(r->sender, NULL);
+
+    if (r->fd >= 0) close(r->fd);
+    pthread_cond_destroy(&r->changed);
+    pthread_mutex_destroy(&r->lock);
+    free(r->log);
+    free(r->stamp_ns);
+    free(r);
+}
+
+/**
+ * @brief Creates a standby listening for a primary.
+ *
+ * @param g Garage kept in sync with the primary
+ * @param socket_path Filesystem path of the socket
+ * @return Standby handle, or NULL on failure
+ */
+Standby *standby_create(Garage *g, const char *socket_path) {
+    struct sockaddr_un addr = {0};
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) return NULL;
+
+    Standby *s = calloc(1, sizeof(Standby));
+    if (!s) return NULL;
+    s->g = g;
+    s->conn_fd = -1;
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+    strcpy(s->path, socket_path);
+
+    s->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    s->stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (s->listen_fd < 0 || s->stop_fd < 0) goto fail;
+
+    unlink(socket_path);
+    if (bind(s->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) goto fail;
+    if (listen(s->listen_fd, 1) != 0) goto fail;
+    return s;
+
+fail:
+    perror("Could not start standby");
+    if (s->listen_fd >= 0) close(s->listen_fd);
+    if (s->stop_fd >= 0) close(s->stop_fd);
+    free(s);
+    return NULL;
+}
+
+static void standby_disconnect(Standby *s) {
+    close(s->conn_fd);
+    s->conn_fd = -1;
+    atomic_store(&s->connected, 0);
+}
+
+/**
+ * @brief Applies one replicated event to the standby's garage.
+ *
+ * Exits and corrections go to the record holding the primary's ticket, and
+ * an entry must be issued the same ticket as on the primary.
+ *
+ * @return 0 if applied as on the primary, -1 otherwise
+ */
+static int apply_replicated(Garage *g, const ReplEvent *re) {
+    const GateEvent *ev = &re->ev;
+    Ticket ticket;
+    switch (ev->type) {
+        case EVENT_ENTRY:
+            if (register_entry_class(g, ev->license_plate, ev->time, (VehicleClass)ev->vehicle_class, &ticket) != 0) {
+                return -1;
+            }
+            return ticket == re->ticket ? 0 : -1;
+        case EVENT_EXIT:
+            return log_exit_by_ticket(g, re->ticket, ev->time) < 0 ? -1 : 0;
+        case EVENT_CORRECT_ENTRY:
+            return update_entry_time_by_ticket(g, re->ticket, ev->time);
+        case EVENT_CORRECT_EXIT:
+            return update_exit_time_by_ticket(g, re->ticket, ev->time);
+    }
+    return -1;
+}
+
+/**
+ * @brief Receives one frame, applies the events not seen yet and acknowledges.
+ *
+ * A frame from a different primary after events were applied, a gap in
+ * the sequence numbers, an event the garage refuses, or the primary's
+ * broken flag makes the standby diverged: it applies nothing more and
+ * reports so in every acknowledgement.
+ *
+ * @return 0 on success, -1 if the connection must be closed
+ */
+static int standby_receive(Standby *s) {
+    ReplFrame frame;
+    if (recv_all(s->conn_fd, &frame, sizeof(frame), REPL_ACK_TIMEOUT_MS) != 0) return -1;
+    if (frame.magic != REPL_MAGIC || frame.count > REPL_BATCH) return -1;
+    if (recv_all(s->conn_fd, s->batch, sizeof(ReplEvent) * frame.count, REPL_ACK_TIMEOUT_MS) != 0) return -1;
+
+    uint64_t applied = atomic_load(&s->applied_seq);
+    if (frame.epoch != s->epoch) {
+        if (applied > 0) atomic_store(&s->diverged, 1); // a restarted primary: its log does not continue ours
+        else s->epoch = frame.epoch;
+    }
+    if (frame.first_seq > applied + 1) atomic_store(&s->diverged, 1); // a gap
+    if (atomic_load(&s->diverged)) {
+        ReplAck ack = {REPL_MAGIC, REPL_ACK_DIVERGED, applied};
+        struct iovec iov = {&ack, sizeof(ack)};
+        return send_all(s->conn_fd, &iov, 1);
+    }
+
+    for (uint32_t i = 0; i < frame.count; ++i) {
+        uint64_t seq = frame.first_seq + i;
+        if (seq <= applied) continue; // resent after a reconnect
+        applied = seq;
+        if (apply_replicated(s->g, &s->batch[i]) != 0) {
+            // the garages no longer hold the same records: later events could change the wrong ones
+            atomic_fetch_add_explicit(&s->rejected, 1, memory_order_relaxed);
+            atomic_store(&s->diverged, 1);
+            break;
+        }
+    }
+    atomic_store(&s->applied_seq, applied);
+    atomic_fetch_add_explicit(&s->batches, 1, memory_order_relaxed);
+    if (frame.flags & REPL_FRAME_BROKEN) atomic_store(&s->diverged, 1);
+
+    ReplAck ack = {REPL_MAGIC, atomic_load(&s->diverged) ? REPL_ACK_DIVERGED : 0, applied};
+    struct iovec iov = {&ack, sizeof(ack)};
+    return send_all(s->conn_fd, &iov, 1);
+}
+
+/**
+ * @brief Applies the primary's log until standby_stop() is called.
+ *
+ * Serves one primary at a time; a new connection replaces the old one.
+ *
+ * @param s Standby
+ * @return 0 when stopped, -1 on error or if the standby diverged and must not be promoted
+ */
+int standby_run(Standby *s) {
+    for (;;) {
+        struct pollfd fds[3] = {{s->stop_fd, POLLIN, 0}, {s->listen_fd, POLLIN, 0}, {s->conn_fd, POLLIN, 0}};
+        int n = poll(fds, s->conn_fd >= 0 ? 3 : 2, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            return -1;
+        }
+
+        if (fds[0].revents) {
+            uint64_t value;
+            if (read(s->stop_fd, &value, sizeof(value)) < 0) { /* already drained */ }
+            return atomic_load(&s->diverged) ? -1 : 0;
+        }
+        if (fds[1].revents & POLLIN) {
+            int fd = accept4(s->listen_fd, NULL, NULL, SOCK_CLOEXEC);
+            if (fd >= 0) {
+                if (s->conn_fd >= 0) standby_disconnect(s);
+                s->conn_fd = fd;
+                atomic_store(&s->connected, 1);
+            }
+            continue;
+        }
+        if (s->conn_fd >= 0 && fds[2].revents && standby_receive(s) != 0) standby_disconnect(s);
+    }
+}
+
+/**
+ * @brief Asks a running standby to stop.
+ *
+ * Only writes to an eventfd, so it is safe from signal handlers and other threads.
+ *
+ * @param s Standby
+ */
+void standby_stop(Standby *s) {
+    uint64_t one = 1;
+    if (write(s->stop_fd, &one, sizeof(one)) < 0) { /* counter saturated: already stopping */ }
+}
+
+/**
+ * @brief Copies the standby's counters.
+ *
+ * @param s Standby
+ * @param stats Output counters
+ */
+void standby_get_stats(Standby *s, StandbyStats *stats) {
+    stats->applied_seq = atomic_load(&s->applied_seq);
+    stats->batches = atomic_load_explicit(&s->batches, memory_order_relaxed);
+    stats->rejected = atomic_load_explicit(&s->rejected, memory_order_relaxed);
+    stats->connected = atomic_load(&s->connected);
+    stats->diverged = atomic_load(&s->diverged);
+}
+
+/**
+ * @brief Closes the connection, removes the socket file and frees the standby.
+ *
+ * @param s Standby (may be NULL)
+ */
+void standby_destroy(Standby *s) {
+    if (!s) return;
+    if (s->conn_fd >= 0) close(s->conn_fd);
+    close(s->listen_fd);
+    unlink(s->path);
+    close(s->stop_fd);
+    free(s);
+}
@@ -0,0 +1,196 @@
+/**
+ * @file report_pool.c
+ * @brief Implements the work-stealing pool for batch end-of-day reports.
+ *
+ * All jobs are known up front, so each thread's deque is a range of garage
+ * indices guarded by its own mutex. The owner takes jobs from the front of
+ * its range; a thread that runs out steals the back half of the first
+ * non-empty range it finds and continues with that. The batch is over when
+ * a thread's own range is empty and a full round of stealing finds nothing.
+ * Each thread sums its garages into a private summary, merged after join.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "report_pool.h"
+#include "garage.h"
+#include "functions.h"
+#include "io.h"
+#include "spsc_ring.h"
+
+/// @brief One thread's range of jobs, padded so deques never share a cache line
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) pthread_mutex_t lock;
+    int front; ///< Next job of the owner
+    int back;  ///< One past the last job
+} ReportDeque;
+
+typedef struct {
+    const Garage *const *garages;
+    const char *const *paths;
+    ReportDeque *deques;
+    int threads;
+} ReportBatch;
+
+typedef struct {
+    ReportBatch *batch;
+    int index;
+    ReportSummary summary;
+    pthread_t thread;
+} ReportWorker;
+
+static int take_own(ReportDeque *d) {
+    int job = -1;
+    pthread_mutex_lock(&d->lock);
+    if (d->front < d->back) job = d->front++;
+    pthread_mutex_unlock(&d->lock);
+    return job;
+}
+
+/**
+ * @brief Moves the back half of another thread's jobs into an empty deque.
+ *
+ * @return 1 if jobs were stolen, 0 if every other deque is empty
+ */
+static int steal(ReportBatch *b, int thief) {
+    for (int i = 1; i < b->threads; ++i) {
+        ReportDeque *victim = &b->deques[(thief + i) % b->threads];
+        pthread_mutex_lock(&victim->lock);
+        int left = victim->back - victim->front;
+        if (left <= 0) {
+            pthread_mutex_unlock(&victim->lock);
+            continue;
+        }
+        int end = victim->back;
+        victim->back -= (left + 1) / 2;
+        int start = victim->back;
+        pthread_mutex_unlock(&victim->lock);
+
+        ReportDeque *own = &b->deques[thief];
+        pthread_mutex_lock(&own->lock);
+        own->front = start;
+        own->back = end;
+        pthread_mutex_unlock(&own->lock);
+        return 1;
+    }
+    return 0;
+}
+
+static void run_job(ReportBatch *b, int job, ReportSummary *s) {
+    const Garage *g = b->garages[job];
+    if (write_report(g, b->paths[job]) == 0) s->reports++;
+    else s->failed++;
+    s->served += g->total_served;
+    s->revenue_cents += g->revenue_cents;
+    s->still_inside += current_occupancy(g);
+}
+
+static void *report_thread(void *arg) {
+    ReportWorker *w = arg;
+    ReportBatch *b = w->batch;
+    ReportDeque *own = &b->deques[w->index];
+    int stolen = 0;
+
+    for (;;) {
+        int job = take_own(own);
+        if (job < 0) {
+            if (!steal(b, w->index)) break;
+            stolen = 1;
+            continue;
+        }
+        run_job(b, job, &w->summary);
+        if (stolen) w->summary.stolen++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Writes one report per garage in parallel.
+ *
+ * @param garages Garages
+ * @param paths Report file for each garage
+ * @param n Number of garages
+ * @param threads Number of threads, or 0 for one per online CPU
+ * @param summary Receives the merged totals
+ * @return 0 if every report was written, -1 otherwise
+ */
+int report_pool_run(const Garage *const *garages, const char *const *paths, int n, int threads,
+                    ReportSummary *summary) {
+    memset(summary, 0, sizeof(*summary));
+    if (n <= 0) return 0;
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+    if (threads > n) threads = n;
+
+    ReportBatch batch = {garages, paths, NULL, threads};
+    batch.deques = aligned_alloc(CACHE_LINE_SIZE, sizeof(ReportDeque) * (size_t)threads);
+    ReportWorker *workers = calloc((size_t)threads, sizeof(ReportWorker));
+    if (!batch.deques || !workers) {
+        free(batch.deques);
+        free(workers);
+        return -1;
+    }
+
+    for (int i = 0; i < threads; ++i) {
+        pthread_mutex_init(&batch.deques[i].lock, NULL);
+        batch.deques[i].front = (int)((long)n * i / threads);
+        batch.deques[i].back = (int)((long)n * (i + 1) / threads);
+        workers[i].batch = &batch;
+        workers[i].index = i;
+    }
+
+    // Thread 0 is the calling thread; if a thread cannot be started its jobs get stolen
+    for (int i = 1; i < threads; ++i) {
+        if (pthread_create(&workers[i].thread, NULL, report_thread, &workers[i]) != 0) workers[i].index = -1;
+    }
+    report_thread(&workers[0]);
+
+    for (int i = 0; i < threads; ++i) {
+        if (i > 0 && workers[i].index >= 0) pthread_join(workers[i].thread, NULL);
+        summary->reports += workers[i].summary.reports;
+        summary->failed += workers[i].summary.failed;
+        summary->served += workers[i].summary.served;
+        summary->revenue_cents += workers[i].summary.revenue_cents;
+        summary->still_inside += workers[i].summary.still_inside;
+        summary->stolen += workers[i].summary.stolen;
+        pthread_mutex_destroy(&batch.deques[i].lock);
+    }
+
+    free(batch.deques);
+    free(workers);
+    return summary->failed == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Writes the merged totals of a batch.
+ *
+ * @param summary Totals from report_pool_run()
+ * @param filename Name of the output file
+ * @return 0 on success, -1 if the file could not be written
+ */
+int write_report_summary(const ReportSummary *summary, const char *filename) {
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        perror("Could not open output file");
+        return -1;
+    }
+
+    fprintf(file, "Daily Summary of All Garages\n");
+    fprintf(file, "============================\n\n");
+    fprintf(file, "Reports Written: %d\n", summary->reports);
+    fprintf(file, "Reports Failed: %d\n", summary->failed);
+    fprintf(file, "Total Cars Served: %d\n", summary->served);
+    char amount[32];
+    format_cents(summary->revenue_cents, amount, sizeof(amount));
+    fprintf(file, "Total Revenue: €%s\n", amount);
+    fprintf(file, "Vehicles Still Inside: %d\n", summary->still_inside);
+
+    int failed = ferror(file);
+    if (fclose(file) != 0 || failed) return -1;
+    return 0;
+}
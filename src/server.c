@@ -0,0 +1,471 @@
+/**
+ * @file server.c
+ * @brief Implements the Unix domain socket server for gate controllers.
+ *
+ * A single epoll event loop accepts any number of gate controller
+ * connections. Each connection sends newline-terminated text commands which
+ * are applied to the shared Garage one at a time, so the garage logic itself
+ * stays single-threaded. Commands can be pipelined: every complete request in
+ * a read is handled and the responses are queued in fixed-size output blocks
+ * that are written back together with a single writev(). A connection whose
+ * client stops reading its responses is not read from once OUT_HIGH_WATER
+ * bytes are queued, until its output drains below OUT_LOW_WATER, so a
+ * pipelining client cannot grow the server's memory without bound.
+ *
+ * The first byte of a connection selects its protocol: BINPROTO_MAGIC
+ * switches to the fixed-layout binary protocol from binproto.h, anything
+ * else is treated as the line-based text protocol.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include "server.h"
+#include "binproto.h"
+#include "garage.h"
+#include "gate_log.h"
+
+#define SERVER_MAX_EVENTS 64
+#define CONN_IN_SIZE 4096
+#define OUT_BLOCK_SIZE 4096
+#define OUT_MAX_IOV 64
+#define OUT_HIGH_WATER (64 * OUT_BLOCK_SIZE)
+#define OUT_LOW_WATER (16 * OUT_BLOCK_SIZE)
+
+/// @brief Protocol spoken on a connection, decided by its first byte
+typedef enum {
+    PROTO_UNKNOWN,
+    PROTO_TEXT,
+    PROTO_BINARY
+} Protocol;
+
+/// @brief Fixed-size block of queued response bytes
+typedef struct OutBlock {
+    struct OutBlock *next;
+    size_t len;                 ///< Bytes filled
+    size_t off;                 ///< Bytes already written to the socket
+    char data[OUT_BLOCK_SIZE];
+} OutBlock;
+
+/// @brief Per-connection buffers
+typedef struct Conn {
+    int fd;
+    Protocol proto;
+    char in[CONN_IN_SIZE];  ///< Bytes received but not yet forming a full request
+    size_t in_len;
+    OutBlock *out_head;     ///< Responses not yet written to the socket
+    OutBlock *out_tail;
+    size_t out_pending;     ///< Queued response bytes not yet written
+    uint32_t events;        ///< Events currently registered with epoll
+    int paused;             ///< 1 while requests are not read until the output drains
+    struct Conn *next;
+} Conn;
+
+struct Server {
+    Garage *g;
+    int epoll_fd;
+    int listen_fd;
+    int stop_fd;
+    char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    Conn *conns;
+    OccupancyFeed *feed;
+};
+
+/**
+ * @brief Handles a single text command against the garage.
+ *
+ * @param g Pointer to the Garage structure
+ * @param line Command line without the trailing newline
+ * @param out Buffer for the response line
+ * @param out_size Size of the response buffer
+ * @return Length of the response written to out
+ */
+int server_handle_line(Garage *g, const char *line, char *out, size_t out_size) {
+    char cmd[16], plate[20], time_str[8];
+    int fields = sscanf(line, "%15s %19s %7s", cmd, plate, time_str);
+
+    if (fields == 1 && strcmp(cmd, "OCC") == 0) {
+        int inside = current_occupancy(g);
+        return snprintf(out, out_size, "OCC %d %d\n", inside, GARAGE_CAPACITY - inside);
+    }
+
+    GateEvent ev;
+    if (fields < 3 || gate_event_parse(line, &ev) != 0) {
+        return snprintf(out, out_size, "ERR\n");
+    }
+
+    int result = apply_gate_event(g, &ev);
+
+    switch (ev.type) {
+        case EVENT_ENTRY:
+            if (result == -2) return snprintf(out, out_size, "DUPLICATE\n");
+            return snprintf(out, out_size, result == 0 ? "OK\n" : "FULL\n");
+        case EVENT_EXIT:
+            if (result >= 0) return snprintf(out, out_size, "FEE %d\n", result);
+            return snprintf(out, out_size, "NOTFOUND\n");
+        default:
+            return snprintf(out, out_size, result == 0 ? "OK\n" : "NOTFOUND\n");
+    }
+}
+
+static void conn_close(Server *s, Conn *c) {
+    epoll_ctl(s->epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+
+    Conn **pp = &s->conns;
+    while (*pp && *pp != c) pp = &(*pp)->next;
+    if (*pp) *pp = c->next;
+
+    while (c->out_head) {
+        OutBlock *next = c->out_head->next;
+        free(c->out_head);
+        c->out_head = next;
+    }
+    free(c);
+}
+
+/**
+ * @brief Queues response bytes, adding output blocks as needed.
+ *
+ * @return 0 on success, -1 if out of memory
+ */
+static int conn_append(Conn *c, const void *data, size_t len) {
+    const char *src = data;
+    while (len > 0) {
+        OutBlock *b = c->out_tail;
+        if (!b || b->len == OUT_BLOCK_SIZE) {
+            b = malloc(sizeof(OutBlock));
+            if (!b) return -1;
+            b->next = NULL;
+            b->len = 0;
+            b->off = 0;
+            if (c->out_tail) c->out_tail->next = b;
+            else c->out_head = b;
+            c->out_tail = b;
+        }
+        size_t chunk = OUT_BLOCK_SIZE - b->len;
+        if (chunk > len) chunk = len;
+        memcpy(b->data + b->len, src, chunk);
+        b->len += chunk;
+        c->out_pending += chunk;
+        src += chunk;
+        len -= chunk;
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes as much pending output as the socket accepts.
+ *
+ * All queued blocks go out in one writev() per round instead of one write()
+ * per response. Reading resumes once a paused connection's output has
+ * drained below OUT_LOW_WATER.
+ *
+ * @return 0 if the connection is still usable, -1 if it must be closed
+ */
+static int conn_flush(Server *s, Conn *c) {
+    while (c->out_head) {
+        struct iovec iov[OUT_MAX_IOV];
+        int n_iov = 0;
+        for (OutBlock *b = c->out_head; b && n_iov < OUT_MAX_IOV; b = b->next) {
+            iov[n_iov].iov_base = b->data + b->off;
+            iov[n_iov].iov_len = b->len - b->off;
+            n_iov++;
+        }
+
+        ssize_t n = writev(c->fd, iov, n_iov);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return -1;
+        }
+
+        size_t written = (size_t)n;
+        c->out_pending -= written;
+        while (c->out_head && written >= c->out_head->len - c->out_head->off) {
+            written -= c->out_head->len - c->out_head->off;
+            OutBlock *next = c->out_head->next;
+            free(c->out_head);
+            c->out_head = next;
+        }
+        if (!c->out_head) c->out_tail = NULL;
+        else c->out_head->off += written;
+    }
+
+    if (c->paused && c->out_pending < OUT_LOW_WATER) c->paused = 0;
+    uint32_t events = (c->paused ? 0 : EPOLLIN) | (c->out_head ? EPOLLOUT : 0);
+    if (events != c->events) {
+        struct epoll_event ev = {0};
+        ev.events = events;
+        ev.data.ptr = c;
+        if (epoll_ctl(s->epoll_fd, EPOLL_CTL_MOD, c->fd, &ev) != 0) return -1;
+        c->events = events;
+    }
+    return 0;
+}
+
+/**
+ * @brief Handles every complete binary request in the input buffer.
+ *
+ * @return 0 on success, -1 if the connection must be closed
+ */
+static int conn_process_binary(Server *s, Conn *c) {
+    size_t start = 0;
+    BinRequest req;
+    BinResponse resp;
+
+    while (c->in_len - start >= sizeof(BinRequest)) {
+        memcpy(&req, c->in + start, sizeof(req));
+        if (req.magic != BINPROTO_MAGIC) return -1; // lost framing, cannot resync
+        binproto_handle(s->g, &req, &resp);
+        if (conn_append(c, &resp, sizeof(resp)) != 0) return -1;
+        start += sizeof(BinRequest);
+    }
+
+    memmove(c->in, c->in + start, c->in_len - start);
+    c->in_len -= start;
+    return 0;
+}
+
+/**
+ * @brief Handles every complete request in the input buffer.
+ *
+ * @return 0 on success, -1 if the connection must be closed
+ */
+static int conn_process(Server *s, Conn *c) {
+    char response[64];
+    size_t start = 0;
+
+    if (c->proto == PROTO_UNKNOWN && c->in_len > 0) {
+        c->proto = (unsigned char)c->in[0] == BINPROTO_MAGIC ? PROTO_BINARY : PROTO_TEXT;
+    }
+    if (c->proto == PROTO_BINARY) return conn_process_binary(s, c);
+
+    for (size_t i = 0; i < c->in_len; ++i) {
+        if (c->in[i] != '\n') continue;
+
+        c->in[i] = '\0';
+        if (i > start && c->in[i - 1] == '\r') c->in[i - 1] = '\0';
+
+        int len = server_handle_line(s->g, c->in + start, response, sizeof(response));
+        if (conn_append(c, response, (size_t)len) != 0) return -1;
+        start = i + 1;
+    }
+
+    memmove(c->in, c->in + start, c->in_len - start);
+    c->in_len -= start;
+
+    // A full buffer without a newline can never become a valid command
+    if (c->in_len == sizeof(c->in)) {
+        c->in_len = 0;
+        if (conn_append(c, "ERR\n", 4) != 0) return -1;
+    }
+    return 0;
+}
+
+static void conn_readable(Server *s, Conn *c) {
+    for (;;) {
+        if (c->out_pending >= OUT_HIGH_WATER) {
+            // The client is not reading its responses; stop taking requests
+            if (conn_flush(s, c) != 0) {
+                conn_close(s, c);
+                return;
+            }
+            if (c->out_pending >= OUT_HIGH_WATER) {
+                c->paused = 1;
+                break;
+            }
+        }
+
+        ssize_t n = read(c->fd, c->in + c->in_len, sizeof(c->in) - c->in_len);
+        if (n == 0) {
+            conn_close(s, c);
+            return;
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            conn_close(s, c);
+            return;
+        }
+        c->in_len += (size_t)n;
+        if (conn_process(s, c) != 0) {
+            conn_close(s, c);
+            return;
+        }
+    }
+
+    if (s->feed) occupancy_feed_publish(s->feed, s->g);
+
+    if (conn_flush(s, c) != 0) conn_close(s, c);
+}
+
+static void accept_connections(Server *s) {
+    for (;;) {
+        int fd = accept4(s->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            return; // EAGAIN or a transient error; wait for the next event
+        }
+
+        Conn *c = calloc(1, sizeof(Conn));
+        if (!c) {
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        c->events = EPOLLIN;
+
+        struct epoll_event ev = {0};
+        ev.events = EPOLLIN;
+        ev.data.ptr = c;
+        if (epoll_ctl(s->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            free(c);
+            continue;
+        }
+        c->next = s->conns;
+        s->conns = c;
+    }
+}
+
+/**
+ * @brief Creates a server listening on a Unix domain socket.
+ *
+ * @param g Pointer to the Garage structure shared by all connections
+ * @param socket_path Filesystem path of the socket
+ * @return Server handle, or NULL on failure
+ */
+Server *server_create(Garage *g, const char *socket_path) {
+    struct sockaddr_un addr = {0};
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) return NULL;
+
+    Server *s = calloc(1, sizeof(Server));
+    if (!s) return NULL;
+    s->g = g;
+    s->listen_fd = -1;
+    s->stop_fd = -1;
+    s->epoll_fd = -1;
+
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+    strcpy(s->path, socket_path);
+
+    s->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    s->stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    s->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (s->listen_fd < 0 || s->stop_fd < 0 || s->epoll_fd < 0) goto fail;
+
+    unlink(socket_path);
+    if (bind(s->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) goto fail;
+    if (listen(s->listen_fd, SOMAXCONN) != 0) goto fail;
+
+    struct epoll_event ev = {0};
+    ev.events = EPOLLIN;
+    ev.data.ptr = &s->listen_fd;
+    if (epoll_ctl(s->epoll_fd, EPOLL_CTL_ADD, s->listen_fd, &ev) != 0) goto fail;
+    ev.data.ptr = &s->stop_fd;
+    if (epoll_ctl(s->epoll_fd, EPOLL_CTL_ADD, s->stop_fd, &ev) != 0) goto fail;
+
+    return s;
+
+fail:
+    perror("Could not start server");
+    server_destroy(s);
+    return NULL;
+}
+
+/**
+ * @brief Publishes garage state to an occupancy feed after every handled batch.
+ *
+ * @param s Server handle
+ * @param feed Feed handle, or NULL to disable publishing
+ */
+void server_set_feed(Server *s, OccupancyFeed *feed) {
+    s->feed = feed;
+    if (feed) occupancy_feed_publish(feed, s->g);
+}
+
+/**
+ * @brief Runs the event loop until server_stop() is called.
+ *
+ * @param s Server handle
+ * @return 0 on clean shutdown, -1 on error
+ */
+int server_run(Server *s) {
+    struct epoll_event events[SERVER_MAX_EVENTS];
+
+    for (;;) {
+        int n = epoll_wait(s->epoll_fd, events, SERVER_MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            return -1;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            void *ptr = events[i].data.ptr;
+            if (ptr == &s->stop_fd) {
+                uint64_t value;
+                if (read(s->stop_fd, &value, sizeof(value)) < 0) { /* already drained */ }
+                return 0;
+            }
+            if (ptr == &s->listen_fd) {
+                accept_connections(s);
+                continue;
+            }
+
+            Conn *c = ptr;
+            if (events[i].events & (EPOLLERR | EPOLLHUP) && !(events[i].events & EPOLLIN)) {
+                conn_close(s, c);
+                continue;
+            }
+            if (events[i].events & EPOLLIN) {
+                conn_readable(s, c); // may close and free c
+                continue;
+            }
+            if ((events[i].events & EPOLLOUT) && conn_flush(s, c) != 0) {
+                conn_close(s, c);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Asks a running server to stop.
+ *
+ * Only writes to an eventfd, so it is safe from signal handlers and other threads.
+ *
+ * @param s Server handle
+ */
+void server_stop(Server *s) {
+    uint64_t one = 1;
+    if (write(s->stop_fd, &one, sizeof(one)) < 0) { /* counter saturated: already stopping */ }
+}
+
+/**
+ * @brief Closes all connections, removes the socket file and frees the server.
+ *
+ * @param s Server handle (may be NULL)
+ */
+void server_destroy(Server *s) {
+    if (!s) return;
+    while (s->conns) conn_close(s, s->conns);
+    if (s->listen_fd >= 0) {
+        close(s->listen_fd);
+        unlink(s->path);
+    }
+    if (s->stop_fd >= 0) close(s->stop_fd);
+    if (s->epoll_fd >= 0) close(s->epoll_fd);
+    free(s);
+}
@@ -0,0 +1,91 @@
+/**
+ * @file spsc_ring.c
+ * @brief Implements the lock-free single-producer/single-consumer ring buffer.
+ *
+ * Indices grow monotonically and are masked on access. The producer publishes
+ * new elements with a release store of tail, the consumer frees slots with a
+ * release store of head; each side acquires the other's index only when its
+ * cached copy says there is no room left (or fewer elements than requested).
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "spsc_ring.h"
+
+/**
+ * @brief Allocates the ring storage.
+ *
+ * @param r Ring to initialize
+ * @param capacity Requested number of elements (rounded up to a power of two)
+ * @param elem_size Size of one element in bytes
+ * @return 0 on success, -1 if out of memory
+ */
+int spsc_ring_init(SpscRing *r, size_t capacity, size_t elem_size) {
+    size_t size = 2;
+    while (size < capacity) size *= 2;
+
+    r->slots = malloc(size * elem_size);
+    if (!r->slots) return -1;
+    r->mask = size - 1;
+    r->elem_size = elem_size;
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    r->cached_head = 0;
+    r->cached_tail = 0;
+    return 0;
+}
+
+/**
+ * @brief Frees the ring storage.
+ *
+ * @param r Ring
+ */
+void spsc_ring_free(SpscRing *r) {
+    free(r->slots);
+    r->slots = NULL;
+}
+
+/**
+ * @brief Appends one element. Must only be called by the producer thread.
+ *
+ * @param r Ring
+ * @param elem Element to copy in
+ * @return 0 on success, -1 if the ring is full
+ */
+int spsc_ring_push(SpscRing *r, const void *elem) {
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (tail - r->cached_head > r->mask) {
+        r->cached_head = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (tail - r->cached_head > r->mask) return -1;
+    }
+
+    memcpy(r->slots + (tail & r->mask) * r->elem_size, elem, r->elem_size);
+    atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+    return 0;
+}
+
+/**
+ * @brief Removes up to max elements. Must only be called by the consumer thread.
+ *
+ * @param r Ring
+ * @param out Output array with room for max elements
+ * @param max Maximum number of elements to take
+ * @return Number of elements copied to out
+ */
+size_t spsc_ring_pop_batch(SpscRing *r, void *out, size_t max) {
+    size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    if (r->cached_tail - head < max) {
+        r->cached_tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+        if (r->cached_tail == head) return 0;
+    }
+
+    size_t n = r->cached_tail - head;
+    if (n > max) n = max;
+
+    unsigned char *dst = out;
+    for (size_t i = 0; i < n; ++i) {
+        memcpy(dst + i * r->elem_size, r->slots + ((head + i) & r->mask) * r->elem_size, r->elem_size);
+    }
+    atomic_store_explicit(&r->head, head + n, memory_order_release);
+    return n;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file stay_index.c
+ * @brief Implements the hourly stay bitmaps used for "who was inside" queries.
+ *
+ * A stay sets its slot's bit in every hour it overlaps, so the vehicles
+ * inside at a time are a subset of one bucket and the vehicles inside
+ * during a range are a subset of the OR of its buckets. Candidates are
+ * enumerated with count-trailing-zeros, so a query costs a few word
+ * operations per hour plus one exact check per candidate.
+ *
+ * Archived stays no longer have a slot and can be far more numerous, so
+ * each hour keeps a growable list of their archive positions instead. The
+ * lists only ever grow: archived stays are not corrected.
+ */
+
+#include <stdlib.h>
+#include "stay_index.h"
+
+static void clamp_hours(int *first_hour, int *last_hour) {
+    if (*first_hour < 0) *first_hour = 0;
+    if (*last_hour >= STAY_INDEX_HOURS) *last_hour = STAY_INDEX_HOURS - 1;
+}
+
+/**
+ * @brief Marks a slot in a range of hours.
+ *
+ * @param idx Index
+ * @param slot Record slot
+ * @param first_hour First hour of the stay
+ * @param last_hour Last hour of the stay
+ */
+void stay_index_add(StayIndex *idx, int slot, int first_hour, int last_hour) {
+    clamp_hours(&first_hour, &last_hour);
+    uint64_t bit = 1ull << (slot % 64);
+    for (int h = first_hour; h <= last_hour; ++h) idx->hours[h].words[slot / 64] |= bit;
+}
+
+/**
+ * @brief Clears a slot from a range of hours.
+ *
+ * @param idx Index
+ * @param slot Record slot
+ * @param first_hour First hour of the stay
+ * @param last_hour Last hour of the stay
+ */
+void stay_index_remove(StayIndex *idx, int slot, int first_hour, int last_hour) {
+    clamp_hours(&first_hour, &last_hour);
+    uint64_t bit = 1ull << (slot % 64);
+    for (int h = first_hour; h <= last_hour; ++h) idx->hours[h].words[slot / 64] &= ~bit;
+}
+
+/**
+ * @brief Collects the slots marked in a range of hours.
+ *
+ * @param idx Index
+ * @param first_hour First hour
+ * @param last_hour Last hour
+ * @param out Union of the hourly bitmaps
+ */
+void stay_index_candidates(const StayIndex *idx, int first_hour, int last_hour, StaySet *out) {
+    clamp_hours(&first_hour, &last_hour);
+    for (int w = 0; w < STAY_INDEX_WORDS; ++w) out->words[w] = 0;
+    for (int h = first_hour; h <= last_hour; ++h) {
+        for (int w = 0; w < STAY_INDEX_WORDS; ++w) out->words[w] |= idx->hours[h].words[w];
+    }
+}
+
+/**
+ * @brief Removes and returns the lowest slot of a set.
+ *
+ * @param set Slot bitmap
+ * @return Lowest slot, or -1 if empty
+ */
+int stay_set_pop(StaySet *set) {
+    for (int w = 0; w < STAY_INDEX_WORDS; ++w) {
+        if (set->words[w] == 0) continue;
+        int bit = __builtin_ctzll(set->words[w]);
+        set->words[w] &= set->words[w] - 1;
+        return w * 64 + bit;
+    }
+    return -1;
+}
+
+/**
+ * @brief Makes room for one more stay in every hour.
+ *
+ * @param idx Archive index
+ * @return 0 on success, -1 if out of memory
+ */
+int stay_archive_reserve(StayArchiveIndex *idx) {
+    for (int h = 0; h < STAY_INDEX_HOURS; ++h) {
+        if (idx->count[h] < idx->capacity[h]) continue;
+        int capacity = idx->capacity[h] ? idx->capacity[h] * 2 : 16;
+        int *stays = realloc(idx->stays[h], sizeof(int) * (size_t)capacity);
+        if (!stays) return -1;
+        idx->stays[h] = stays;
+        idx->capacity[h] = capacity;
+    }
+    return 0;
+}
+
+/**
+ * @brief Lists an archived stay in a range of hours.
+ *
+ * @param idx Archive index with room reserved
+ * @param stay Position of the stay in the archive
+ * @param first_hour First hour of the stay
+ * @param last_hour Last hour of the stay
+ */
+void stay_archive_add(StayArchiveIndex *idx, int stay, int first_hour, int last_hour) {
+    clamp_hours(&first_hour, &last_hour);
+    for (int h = first_hour; h <= last_hour; ++h) idx->stays[h][idx->count[h]++] = stay;
+}
+
+/**
+ * @brief Frees the hourly lists.
+ *
+ * @param idx Archive index
+ */
+void stay_archive_free(StayArchiveIndex *idx) {
+    for (int h = 0; h < STAY_INDEX_HOURS; ++h) {
+        free(idx->stays[h]);
+        idx->stays[h] = NULL;
+        idx->count[h] = 0;
+        idx->capacity[h] = 0;
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ * @file test_alert_wheel.c
+ * @brief Unit tests for the overstay/closing timing wheel in alert_wheel.c
+ */
+
+#include "unity.h"
+#include "alert_wheel.h"
+#include "garage.h"
+#include <stdio.h>
+#include <string.h>
+
+/// @brief Records the alerts fired during a test
+typedef struct {
+    char plates[8][20];
+    AlertReason reasons[8];
+    int minutes[8];
+    int count;
+} AlertLog;
+
+static void record_alert(void *ctx, const Vehicle *v, AlertReason reason, Time deadline) {
+    AlertLog *log = ctx;
+    if (log->count < 8) {
+        strcpy(log->plates[log->count], v->license_plate);
+        log->reasons[log->count] = reason;
+        log->minutes[log->count] = deadline.hour * 60 + deadline.minute;
+    }
+    log->count++;
+}
+
+/**
+ * @brief Test that an overstay fires at its deadline, then the closing alert, and exits disarm.
+ */
+void test_alert_wheel_overstay_then_closing(void) {
+    Garage g = {0};
+    static AlertWheel w;
+    AlertLog log = {0};
+    Time closing = {22, 0};
+    alert_wheel_init(&w, 180, &closing, record_alert, &log);
+    garage_set_alerts(&g, &w);
+
+    Time in = {8, 0}, other_in = {8, 30}, early_out = {10, 0};
+    register_entry(&g, "ALR1", in);
+    register_entry(&g, "ALR2", other_in);
+    log_exit(&g, "ALR2", early_out);
+
+    garage_advance_clock(&g, (Time){10, 59});
+    TEST_ASSERT_EQUAL_INT(0, log.count);
+    garage_advance_clock(&g, (Time){11, 0});
+    TEST_ASSERT_EQUAL_INT(1, log.count);
+    TEST_ASSERT_EQUAL_STRING("ALR1", log.plates[0]);
+    TEST_ASSERT_EQUAL_INT(ALERT_OVERSTAY, log.reasons[0]);
+
+    garage_advance_clock(&g, (Time){23, 0});
+    TEST_ASSERT_EQUAL_INT(2, log.count);
+    TEST_ASSERT_EQUAL_INT(ALERT_CLOSING, log.reasons[1]);
+    TEST_ASSERT_EQUAL_INT(22 * 60, log.minutes[1]);
+    TEST_ASSERT_EQUAL_INT(1, (int)w.stats.overstay);
+    TEST_ASSERT_EQUAL_INT(1, (int)w.stats.closing);
+}
+
+/**
+ * @brief Test that gate events drive the clock and corrections move the deadline.
+ */
+void test_alert_wheel_events_and_corrections(void) {
+    Garage g = {0};
+    static AlertWheel w;
+    AlertLog log = {0};
+    alert_wheel_init(&w, 60, NULL, record_alert, &log);
+    garage_set_alerts(&g, &w);
+
+    Time in = {9, 0}, fixed = {9, 45}, later = {10, 30};
+    register_entry(&g, "ALR3", in);
+    update_entry_time(&g, "ALR3", fixed);
+    register_entry(&g, "ALR4", later); // advances the clock to 10:30
+    TEST_ASSERT_EQUAL_INT(0, log.count);
+
+    register_entry(&g, "ALR5", (Time){10, 50});
+    TEST_ASSERT_EQUAL_INT(1, log.count);
+    TEST_ASSERT_EQUAL_STRING("ALR3", log.plates[0]);
+    TEST_ASSERT_EQUAL_INT(10 * 60 + 45, log.minutes[0]);
+
+    // Exit at 11:40 fires ALR4's 11:30 deadline first, nothing for ALR4 afterwards
+    log_exit(&g, "ALR4", (Time){11, 40});
+    TEST_ASSERT_EQUAL_INT(2, log.count);
+    TEST_ASSERT_EQUAL_STRING("ALR4", log.plates[1]);
+}
+
+/**
+ * @brief Test closing alerts for vehicles entering after closing and timers beyond the first level.
+ */
+void test_alert_wheel_late_entry(void) {
+    Garage g = {0};
+    static AlertWheel w;
+    AlertLog log = {0};
+    Time closing = {22, 0};
+    alert_wheel_init(&w, 0, &closing, record_alert, &log);
+    garage_set_alerts(&g, &w);
+
+    register_entry(&g, "ALR6", (Time){6, 0}); // closing is many 64-minute blocks away
+    garage_advance_clock(&g, (Time){21, 59});
+    TEST_ASSERT_EQUAL_INT(0, log.count);
+
+    register_entry(&g, "ALR7", (Time){22, 30});
+    TEST_ASSERT_EQUAL_INT(2, log.count);
+    TEST_ASSERT_EQUAL_STRING("ALR6", log.plates[0]);
+    TEST_ASSERT_EQUAL_STRING("ALR7", log.plates[1]);
+    TEST_ASSERT_EQUAL_INT(ALERT_CLOSING, log.reasons[1]);
+}
@@ -0,0 +1,97 @@
+/**
+ * @file test_bay_map.c
+ * @brief Unit tests for the bay allocator in bay_map.c and its use by garage.c
+ */
+
+#include "unity.h"
+#include "bay_map.h"
+#include "garage.h"
+#include <stdio.h>
+
+/**
+ * @brief Test nearest-first allocation, freeing across summary words and a full map.
+ */
+void test_bay_map_nearest_free(void) {
+    BayMap *m = bay_map_create(2, 50000); // 100k bays, two levels
+    TEST_ASSERT_NOT_NULL(m);
+    TEST_ASSERT_NULL(bay_map_create(0, 10));
+    TEST_ASSERT_NULL(bay_map_create(5, BAY_MAP_MAX_BAYS));
+
+    for (int i = 0; i < 70000; ++i) TEST_ASSERT_EQUAL_INT(i, bay_map_alloc(m));
+    TEST_ASSERT_EQUAL_INT(0, bay_map_level_free(m, 0));
+    TEST_ASSERT_EQUAL_INT(30000, bay_map_level_free(m, 1));
+
+    TEST_ASSERT_EQUAL_INT(0, bay_map_free(m, 65000));
+    TEST_ASSERT_EQUAL_INT(0, bay_map_free(m, 4097));
+    TEST_ASSERT_EQUAL_INT(-1, bay_map_free(m, 4097));     // already free
+    TEST_ASSERT_EQUAL_INT(-1, bay_map_free(m, 100000));   // out of range
+    TEST_ASSERT_EQUAL_INT(4097, bay_map_alloc(m));
+    TEST_ASSERT_EQUAL_INT(65000, bay_map_alloc(m));
+    TEST_ASSERT_EQUAL_INT(70000, bay_map_alloc(m));
+
+    while (bay_map_alloc(m) >= 0) {}
+    TEST_ASSERT_EQUAL_INT(0, bay_map_free_count(m));
+    TEST_ASSERT_EQUAL_INT(0, bay_map_free(m, 99999));
+    TEST_ASSERT_EQUAL_INT(99999, bay_map_alloc(m));
+
+    int level, number;
+    bay_map_locate(m, 50001, &level, &number);
+    TEST_ASSERT_EQUAL_INT(1, level);
+    TEST_ASSERT_EQUAL_INT(1, number);
+    bay_map_destroy(m);
+}
+
+/**
+ * @brief Test that entries take the nearest bay, exits free it and a full bay map blocks entry.
+ */
+void test_garage_assigns_bays(void) {
+    Garage g = {0};
+    BayMap *m = bay_map_create(1, 2);
+    Ticket t1, t2;
+
+    TEST_ASSERT_EQUAL_INT(0, register_entry_ticket(&g, "BAY1", (Time){8, 0}, &t1));
+    garage_set_bays(&g, m); // BAY1 is already inside and gets bay 0
+    TEST_ASSERT_EQUAL_INT(0, find_vehicle_by_ticket(&g, t1)->bay);
+
+    TEST_ASSERT_EQUAL_INT(0, register_entry_ticket(&g, "BAY2", (Time){8, 5}, &t2));
+    TEST_ASSERT_EQUAL_INT(1, find_vehicle_by_ticket(&g, t2)->bay);
+    TEST_ASSERT_EQUAL_INT(-1, register_entry(&g, "BAY3", (Time){8, 10}));
+
+    log_exit(&g, "BAY1", (Time){9, 0});
+    TEST_ASSERT_EQUAL_INT(0, register_entry_ticket(&g, "BAY3", (Time){9, 5}, &t1));
+    TEST_ASSERT_EQUAL_INT(0, find_vehicle_by_ticket(&g, t1)->bay);
+    TEST_ASSERT_NULL(find_vehicle_by_ticket(&g, TICKET_INVALID));
+
+    garage_set_bays(&g, NULL);
+    bay_map_destroy(m);
+}
+
+/**
+ * @brief Test that replacing or detaching a bay map frees the bays held in the previous one.
+ */
+void test_garage_swaps_bay_maps(void) {
+    Garage g = {0};
+    BayMap *first = bay_map_create(1, 4);
+    BayMap *second = bay_map_create(1, 4);
+    Ticket t;
+
+    garage_set_bays(&g, first);
+    register_entry(&g, "SWP1", (Time){8, 0});
+    TEST_ASSERT_EQUAL_INT(0, register_entry_ticket(&g, "SWP2", (Time){8, 5}, &t));
+    TEST_ASSERT_EQUAL_INT(2, bay_map_free_count(first));
+
+    garage_set_bays(&g, second);
+    TEST_ASSERT_EQUAL_INT(4, bay_map_free_count(first));
+    TEST_ASSERT_EQUAL_INT(2, bay_map_free_count(second));
+    TEST_ASSERT_EQUAL_INT(1, find_vehicle_by_ticket(&g, t)->bay);
+
+    garage_set_bays(&g, NULL);
+    TEST_ASSERT_EQUAL_INT(4, bay_map_free_count(second));
+    TEST_ASSERT_EQUAL_INT(-1, find_vehicle_by_ticket(&g, t)->bay);
+
+    // an exit after detaching leaves the old map alone
+    log_exit(&g, "SWP1", (Time){9, 0});
+    TEST_ASSERT_EQUAL_INT(4, bay_map_free_count(second));
+    bay_map_destroy(first);
+    bay_map_destroy(second);
+}
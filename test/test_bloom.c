@@ -0,0 +1,73 @@
+/**
+ * @file test_bloom.c
+ * @brief Unit tests for the counting Bloom filter in bloom.c and its use by garage.c
+ */
+
+#include "unity.h"
+#include "bloom.h"
+#include "functions.h"
+#include "garage.h"
+#include <stdio.h>
+
+/**
+ * @brief Test add, lookup and remove on the counting filter.
+ */
+void test_bloom_add_remove(void) {
+    CountingBloom b = {{0}};
+    uint64_t h1 = plate_hash("BLM1");
+    uint64_t h2 = plate_hash("BLM2");
+
+    TEST_ASSERT_EQUAL_INT(0, bloom_maybe_contains(&b, h1));
+    bloom_add(&b, h1);
+    bloom_add(&b, h1);
+    TEST_ASSERT_EQUAL_INT(1, bloom_maybe_contains(&b, h1));
+
+    bloom_remove(&b, h1);
+    TEST_ASSERT_EQUAL_INT(1, bloom_maybe_contains(&b, h1)); // still added once
+    bloom_remove(&b, h1);
+    TEST_ASSERT_EQUAL_INT(0, bloom_maybe_contains(&b, h1));
+    TEST_ASSERT_EQUAL_INT(0, bloom_maybe_contains(&b, h2));
+}
+
+/**
+ * @brief Test that unknown plates on exit are rejected by the filter and counted.
+ */
+void test_bloom_rejects_unknown_exit(void) {
+    Garage g = {0};
+    Time in = {8, 0}, out = {9, 0};
+    register_entry(&g, "KNOWN1", in);
+
+    TEST_ASSERT_EQUAL_INT(-1, log_exit(&g, "MISREAD", out));
+    TEST_ASSERT_EQUAL_INT(2, log_exit(&g, "KNOWN1", out));
+    // Exited plates leave the active filter, but corrections still find them
+    TEST_ASSERT_EQUAL_INT(-1, log_exit(&g, "KNOWN1", out));
+    TEST_ASSERT_EQUAL_INT(0, update_entry_time(&g, "KNOWN1", in));
+
+    GarageStats stats;
+    get_garage_stats(&g, &stats);
+    TEST_ASSERT_EQUAL_INT(4, stats.plate_lookups);
+    TEST_ASSERT_EQUAL_INT(2, stats.bloom_rejects + stats.bloom_false_positives);
+}
+
+/**
+ * @brief Test that the measured false-positive rate stays low with a full garage.
+ */
+void test_bloom_false_positive_rate(void) {
+    Garage g = {0};
+    Time in = {8, 0}, out = {9, 0};
+    char plate[20];
+
+    for (int i = 0; i < 100; ++i) {
+        snprintf(plate, sizeof(plate), "IN%03d", i);
+        register_entry(&g, plate, in);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(plate, sizeof(plate), "GHOST%04d", i);
+        TEST_ASSERT_EQUAL_INT(-1, log_exit(&g, plate, out));
+    }
+
+    GarageStats stats;
+    get_garage_stats(&g, &stats);
+    TEST_ASSERT_EQUAL_INT(1000, stats.bloom_rejects + stats.bloom_false_positives);
+    TEST_ASSERT_TRUE(stats.bloom_false_positive_rate < 0.05);
+}
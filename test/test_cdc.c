@@ -0,0 +1,131 @@
+/**
+ * @file test_cdc.c
+ * @brief Unit tests for the change-data-capture ring in cdc.c
+ */
+
+#include "unity.h"
+#include "cdc.h"
+#include "garage.h"
+#include <pthread.h>
+#include <string.h>
+
+#define CDC_TEST_RECORDS 200000
+
+/**
+ * @brief Test that garage mutations are published with before/after values and fees.
+ */
+void test_cdc_garage_mutations(void) {
+    static Garage g;
+    init_garage(&g);
+    CdcRing *ring = cdc_ring_create(16);
+    TEST_ASSERT_NOT_NULL(ring);
+    garage_set_changes(&g, ring);
+
+    CdcCursor late;
+    register_entry(&g, "CDC1", (Time){8, 0});
+    cdc_cursor_init(&late, ring, CDC_FROM_NOW);
+    register_entry_class(&g, "CDC2", (Time){8, 30}, CLASS_PERMIT, NULL);
+    update_entry_time(&g, "CDC1", (Time){7, 45});
+    log_exit(&g, "CDC1", (Time){10, 0});
+    update_exit_time(&g, "CDC1", (Time){10, 20});
+    TEST_ASSERT_EQUAL_INT(-2, register_entry(&g, "CDC2", (Time){9, 0})); // rejected: not published
+
+    CdcCursor all;
+    cdc_cursor_init(&all, ring, CDC_FROM_OLDEST);
+    CdcRecord recs[8];
+    TEST_ASSERT_EQUAL_INT(5, cdc_cursor_poll(&all, recs, 8));
+    TEST_ASSERT_EQUAL_UINT64(0, all.lost);
+
+    TEST_ASSERT_EQUAL_UINT64(1, recs[0].seq);
+    TEST_ASSERT_EQUAL_INT(EVENT_ENTRY, recs[0].op);
+    TEST_ASSERT_EQUAL_STRING("CDC1", recs[0].license_plate);
+    TEST_ASSERT_EQUAL_INT(-1, recs[0].before);
+    TEST_ASSERT_EQUAL_INT(8 * 60, recs[0].after);
+
+    TEST_ASSERT_EQUAL_INT(CLASS_PERMIT, recs[1].vehicle_class);
+    TEST_ASSERT_EQUAL_INT(EVENT_CORRECT_ENTRY, recs[2].op);
+    TEST_ASSERT_EQUAL_INT(8 * 60, recs[2].before);
+    TEST_ASSERT_EQUAL_INT(7 * 60 + 45, recs[2].after);
+
+    TEST_ASSERT_EQUAL_INT(EVENT_EXIT, recs[3].op);
+    TEST_ASSERT_EQUAL_INT(6, recs[3].fee);
+    TEST_ASSERT_EQUAL_INT(recs[0].slot, recs[3].slot);
+
+    TEST_ASSERT_EQUAL_INT(EVENT_CORRECT_EXIT, recs[4].op);
+    TEST_ASSERT_EQUAL_INT(10 * 60, recs[4].before);
+    TEST_ASSERT_EQUAL_INT(10 * 60 + 20, recs[4].after);
+    TEST_ASSERT_EQUAL_UINT64(5, recs[4].seq);
+
+    // A cursor started later sees only what came after it
+    TEST_ASSERT_EQUAL_INT(4, cdc_cursor_poll(&late, recs, 8));
+    TEST_ASSERT_EQUAL_UINT64(2, recs[0].seq);
+    TEST_ASSERT_EQUAL_INT(0, cdc_cursor_poll(&late, recs, 8));
+
+    garage_set_changes(&g, NULL);
+    cdc_ring_destroy(ring);
+}
+
+/**
+ * @brief Test that a subscriber lapped by the producer skips ahead and counts the loss.
+ */
+void test_cdc_lapped_subscriber(void) {
+    CdcRing *ring = cdc_ring_create(4);
+    CdcCursor c;
+    cdc_cursor_init(&c, ring, CDC_FROM_OLDEST);
+
+    CdcRecord rec = {0};
+    for (int i = 0; i < 10; ++i) cdc_ring_publish(ring, &rec);
+    TEST_ASSERT_EQUAL_UINT64(10, cdc_ring_head(ring));
+
+    CdcRecord out[8];
+    TEST_ASSERT_EQUAL_INT(4, cdc_cursor_poll(&c, out, 8));
+    TEST_ASSERT_EQUAL_UINT64(6, c.lost);
+    TEST_ASSERT_EQUAL_UINT64(7, out[0].seq);
+    TEST_ASSERT_EQUAL_UINT64(10, out[3].seq);
+
+    CdcCursor oldest;
+    cdc_cursor_init(&oldest, ring, CDC_FROM_OLDEST);
+    TEST_ASSERT_EQUAL_UINT64(7, oldest.next);
+    cdc_ring_destroy(ring);
+}
+
+static void *cdc_producer_thread(void *arg) {
+    CdcRing *ring = arg;
+    CdcRecord rec = {0};
+    for (int i = 1; i <= CDC_TEST_RECORDS; ++i) {
+        rec.fee = i;
+        cdc_ring_publish(ring, &rec);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test that a concurrent subscriber only ever sees intact records in sequence order.
+ */
+void test_cdc_concurrent_subscriber(void) {
+    CdcRing *ring = cdc_ring_create(64);
+    CdcCursor c;
+    cdc_cursor_init(&c, ring, CDC_FROM_OLDEST);
+
+    pthread_t producer;
+    pthread_create(&producer, NULL, cdc_producer_thread, ring);
+
+    CdcRecord out[16];
+    uint64_t read = 0, last = 0;
+    int torn = 0, unordered = 0;
+    while (c.next <= CDC_TEST_RECORDS) {
+        int n = cdc_cursor_poll(&c, out, 16);
+        for (int i = 0; i < n; ++i) {
+            if ((uint64_t)out[i].fee != out[i].seq) torn++;
+            if (out[i].seq <= last) unordered++;
+            last = out[i].seq;
+        }
+        read += (uint64_t)n;
+    }
+    pthread_join(producer, NULL);
+    cdc_ring_destroy(ring);
+
+    TEST_ASSERT_EQUAL_INT(0, torn);
+    TEST_ASSERT_EQUAL_INT(0, unordered);
+    TEST_ASSERT_EQUAL_UINT64(CDC_TEST_RECORDS, read + c.lost);
+}
@@ -0,0 +1,56 @@
+/**
+ * @file test_debounce.c
+ * @brief Unit tests for the read debouncer in debounce.c and its use by gate_pipeline.c
+ */
+
+#include "unity.h"
+#include "debounce.h"
+#include "gate_pipeline.h"
+#include <stdio.h>
+
+/**
+ * @brief Test that repeats within the window are dropped across bucket boundaries.
+ */
+void test_debouncer_window(void) {
+    static Debouncer d;
+    GateEvent in = {.type = EVENT_ENTRY, .license_plate = "DEB1", .time = {8, 0}};
+    GateEvent out = {.type = EVENT_EXIT, .license_plate = "DEB1", .time = {8, 0}};
+    GateEvent fix = {.type = EVENT_CORRECT_ENTRY, .license_plate = "DEB1", .time = {8, 0}};
+    debouncer_init(&d, 2000);
+
+    TEST_ASSERT_EQUAL_INT(1, debouncer_accept(&d, &in, 10000));
+    TEST_ASSERT_EQUAL_INT(0, debouncer_accept(&d, &in, 10500));
+    TEST_ASSERT_EQUAL_INT(0, debouncer_accept(&d, &in, 12400)); // next bucket, still a repeat
+    TEST_ASSERT_EQUAL_INT(1, debouncer_accept(&d, &out, 12500)); // other event type
+    TEST_ASSERT_EQUAL_INT(1, debouncer_accept(&d, &fix, 12600));
+    TEST_ASSERT_EQUAL_INT(1, debouncer_accept(&d, &fix, 12700)); // corrections are never dropped
+
+    // A real second passage after a quiet window passes again
+    TEST_ASSERT_EQUAL_INT(1, debouncer_accept(&d, &in, 20000));
+    TEST_ASSERT_EQUAL_INT(2, (int)d.suppressed);
+    TEST_ASSERT_EQUAL_INT(5, (int)d.passed);
+}
+
+/**
+ * @brief Test that a debouncing pipeline applies one event per burst of reads.
+ */
+void test_gate_pipeline_debounce(void) {
+    Garage g = {0};
+    GatePipeline *p = gate_pipeline_create(&g, 1, 16);
+    gate_pipeline_set_debounce(p, 5000);
+
+    GateEvent in = {.type = EVENT_ENTRY, .license_plate = "DEB2", .time = {9, 0}};
+    TEST_ASSERT_EQUAL_INT(0, gate_pipeline_submit(p, 0, &in));
+    for (int i = 0; i < 5; ++i) TEST_ASSERT_EQUAL_INT(1, gate_pipeline_submit(p, 0, &in));
+
+    gate_pipeline_start(p);
+    gate_pipeline_stop(p);
+
+    GatePipelineStats stats;
+    gate_pipeline_get_stats(p, &stats);
+    gate_pipeline_destroy(p);
+
+    TEST_ASSERT_EQUAL_INT(1, (int)stats.submitted);
+    TEST_ASSERT_EQUAL_INT(5, (int)stats.debounced);
+    TEST_ASSERT_EQUAL_INT(1, g.count);
+}
@@ -0,0 +1,74 @@
+/**
+ * @file test_entry_heap.c
+ * @brief Unit tests for the entry-time heap in entry_heap.c and the garage queries built on it
+ */
+
+#include "unity.h"
+#include "entry_heap.h"
+#include "garage.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Test oldest-K and entered-before against a brute-force model after mixed updates.
+ */
+void test_entry_heap_matches_model(void) {
+    static EntryHeap h;
+    int keys[50];
+    memset(&h, 0, sizeof(h));
+
+    for (int slot = 0; slot < 50; ++slot) {
+        keys[slot] = (slot * 37) % 200;
+        entry_heap_set(&h, slot, keys[slot]);
+    }
+    for (int slot = 0; slot < 50; slot += 3) {
+        entry_heap_remove(&h, slot);
+        keys[slot] = -1;
+    }
+    for (int slot = 1; slot < 50; slot += 7) {
+        keys[slot] = 500 - slot;
+        entry_heap_set(&h, slot, keys[slot]);
+    }
+
+    int out[50];
+    int n = entry_heap_oldest(&h, 10, out);
+    TEST_ASSERT_EQUAL_INT(10, n);
+    for (int i = 0; i < n; ++i) {
+        TEST_ASSERT_TRUE(keys[out[i]] >= 0);
+        if (i > 0) TEST_ASSERT_TRUE(keys[out[i - 1]] <= keys[out[i]]);
+        // No unreported slot may be earlier than the last one reported
+        for (int s = 0; s < 50; ++s) {
+            int reported = 0;
+            for (int j = 0; j < n; ++j) reported |= out[j] == s;
+            if (!reported && keys[s] >= 0) TEST_ASSERT_TRUE(keys[s] >= keys[out[n - 1]]);
+        }
+    }
+
+    int expected = 0;
+    for (int s = 0; s < 50; ++s) expected += keys[s] >= 0 && keys[s] < 100;
+    n = entry_heap_before(&h, 100, out, 50);
+    TEST_ASSERT_EQUAL_INT(expected, n);
+    for (int i = 0; i < n; ++i) TEST_ASSERT_TRUE(keys[out[i]] >= 0 && keys[out[i]] < 100);
+}
+
+/**
+ * @brief Test that the garage queries follow entries, exits and corrections.
+ */
+void test_garage_longest_parked(void) {
+    Garage g = {0};
+    register_entry(&g, "OLD1", (Time){9, 0});
+    register_entry(&g, "OLD2", (Time){7, 30});
+    register_entry(&g, "OLD3", (Time){8, 15});
+    register_entry(&g, "OLD4", (Time){10, 0});
+    log_exit(&g, "OLD2", (Time){11, 0});
+    update_entry_time(&g, "OLD4", (Time){6, 45});
+
+    const Vehicle *out[GARAGE_CAPACITY];
+    TEST_ASSERT_EQUAL_INT(2, garage_longest_parked(&g, 2, out));
+    TEST_ASSERT_EQUAL_STRING("OLD4", out[0]->license_plate);
+    TEST_ASSERT_EQUAL_STRING("OLD3", out[1]->license_plate);
+    TEST_ASSERT_EQUAL_INT(3, garage_longest_parked(&g, 10, out));
+
+    TEST_ASSERT_EQUAL_INT(2, garage_active_entered_before(&g, (Time){9, 0}, out, GARAGE_CAPACITY));
+    TEST_ASSERT_EQUAL_INT(0, garage_active_entered_before(&g, (Time){6, 0}, out, GARAGE_CAPACITY));
+}
@@ -132,3 +132,30 @@ void test_calculate_duration_wrap_around(void) {
     TEST_ASSERT_EQUAL_INT(2, result);  // 2 hours: 23 → 24 → 1
 }
 
+
+/**
+ * @brief Test that amounts in cents are formatted as euros and cents.
+ */
+void test_format_cents(void) {
+    char buf[32];
+    format_cents(0, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("0.00", buf);
+    format_cents(1250, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("12.50", buf);
+    format_cents(-205, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("-2.05", buf);
+}
+
+/**
+ * @brief Test that malformed and out-of-range time strings are rejected.
+ */
+void test_parse_time_invalid(void) {
+    TEST_ASSERT_FALSE(time_valid(parse_time("25:30")));
+    TEST_ASSERT_FALSE(time_valid(parse_time("12:60")));
+    TEST_ASSERT_FALSE(time_valid(parse_time("-1:00")));
+    TEST_ASSERT_FALSE(time_valid(parse_time("noon")));
+    TEST_ASSERT_FALSE(time_valid(parse_time("12:30pm")));
+    TEST_ASSERT_FALSE(time_valid(parse_time("")));
+    TEST_ASSERT_EQUAL_INT(-1, parse_time("26:10").hour);
+    TEST_ASSERT_TRUE(time_valid(parse_time("12:30\n")));
+}
@@ -25,6 +25,9 @@ void test_list_unexited(void);
 void test_write_report_creates_file(void);
 void test_write_report_empty_garage(void);
 void test_vehicle_still_inside_after_22(void);
+void test_occupancy_curve_and_peak(void);
+void test_occupancy_curve_overnight_stay(void);
+void test_write_occupancy_csv(void);
 void test_parse_time_valid(void);
 void test_parse_time_midnight(void);
 void test_parse_time_boundary(void);
@@ -35,7 +38,81 @@ void test_calculate_duration_wrap_around(void);
 void test_print_occupancy_output(void);
 void test_list_unexited_output(void);
 void test_register_exit_update_times(void);
+void test_vehicle_iterator_filters(void);
+void test_garage_for_each_predicate_and_stop(void);
+void test_ticket_exit_and_corrections(void);
+void test_ticket_stale_after_slot_reuse(void);
+void test_ticket_format_and_parse(void);
+void test_duplicate_entry_rejected(void);
+void test_duplicate_entry_close_previous(void);
+void test_duplicate_close_previous_rejected_entry(void);
+void test_duplicate_entry_allowed(void);
+void test_server_entry_exit_commands(void);
+void test_server_occupancy_and_errors(void);
+void test_server_pipelined_socket(void);
+void test_server_backpressure(void);
+void test_binproto_handle(void);
+void test_binproto_pipelined_socket(void);
 
+void test_spsc_ring_full_and_wrap(void);
+void test_gate_pipeline_applies_all_gates(void);
+void test_gate_pipeline_result_handler(void);
+void test_occupancy_feed_publish_and_read(void);
+void test_occupancy_feed_open_missing(void);
+void test_occupancy_feed_open_old_layout(void);
+void test_bloom_add_remove(void);
+void test_bloom_rejects_unknown_exit(void);
+void test_bloom_false_positive_rate(void);
+void test_plate_index_insert_find_remove(void);
+void test_debouncer_window(void);
+void test_gate_pipeline_debounce(void);
+void test_reorder_exit_before_entry(void);
+void test_reorder_late_and_dropped(void);
+void test_gate_pipeline_reorder(void);
+void test_gate_event_parse_format(void);
+void test_gate_log_merge_order(void);
+void test_gate_log_replay(void);
+void test_alert_wheel_overstay_then_closing(void);
+void test_alert_wheel_events_and_corrections(void);
+void test_alert_wheel_late_entry(void);
+void test_entry_heap_matches_model(void);
+void test_garage_longest_parked(void);
+void test_stay_index_bitmaps(void);
+void test_stay_archive_lists(void);
+void test_garage_inside_at_matches_scan(void);
+void test_garage_inside_overnight_stay(void);
+void test_bay_map_nearest_free(void);
+void test_garage_assigns_bays(void);
+void test_garage_swaps_bay_maps(void);
+void test_class_quotas(void);
+void test_gate_event_class(void);
+void test_garage_manager_routes_and_totals(void);
+void test_garage_manager_rejects_invalid_and_full(void);
+void test_report_pool_writes_all_reports(void);
+void test_report_pool_counts_failures(void);
+void test_partitioned_garage_global_admission(void);
+void test_partitioned_garage_lookup_and_exit(void);
+void test_partitioned_garage_rebalance(void);
+void test_replication_standby_follows_primary(void);
+void test_replication_applies_by_ticket(void);
+void test_replication_log_full(void);
+void test_cdc_garage_mutations(void);
+void test_cdc_lapped_subscriber(void);
+void test_cdc_concurrent_subscriber(void);
+void test_correction_reprices_revenue(void);
+void test_correction_journal_wraps(void);
+void test_revenue_buckets(void);
+void test_format_cents(void);
+void test_write_stays_columnar(void);
+void test_busy_day_keeps_recycled_stays(void);
+void test_parse_time_invalid(void);
+void test_invalid_times_rejected(void);
+void test_partitioned_garage_overnight_exit(void);
+void test_overnight_fee(void);
+void test_correction_reversing_stay_rejected(void);
+void test_replication_overflow_diverges_standby(void);
+void test_replication_rejected_event_diverges(void);
+void test_replication_new_primary_epoch(void);
 
 /// @brief Global Garage object used across all test cases
 Garage g;
@@ -194,6 +271,11 @@ int main(void) {
     RUN_TEST(test_write_report_creates_file);
     RUN_TEST(test_write_report_empty_garage);
     RUN_TEST(test_vehicle_still_inside_after_22);
+    RUN_TEST(test_occupancy_curve_and_peak);
+    RUN_TEST(test_occupancy_curve_overnight_stay);
+    RUN_TEST(test_write_occupancy_csv);
+    RUN_TEST(test_write_stays_columnar);
+    RUN_TEST(test_busy_day_keeps_recycled_stays);
 
     // From test_functions.c
     RUN_TEST(test_parse_time_valid);
@@ -203,6 +285,8 @@ int main(void) {
     RUN_TEST(test_calculate_duration_partial_round_up);
     RUN_TEST(test_calculate_duration_normal);
     RUN_TEST(test_calculate_duration_wrap_around);
+    RUN_TEST(test_format_cents);
+    RUN_TEST(test_parse_time_invalid);
 
     //from test_garage_extra.c
     RUN_TEST(test_update_entry_time_not_found);
@@ -213,6 +297,112 @@ int main(void) {
     RUN_TEST(test_print_occupancy_output);
     RUN_TEST(test_list_unexited_output);
     RUN_TEST(test_register_exit_update_times);
+    RUN_TEST(test_vehicle_iterator_filters);
+    RUN_TEST(test_garage_for_each_predicate_and_stop);
+    RUN_TEST(test_ticket_exit_and_corrections);
+    RUN_TEST(test_ticket_stale_after_slot_reuse);
+    RUN_TEST(test_ticket_format_and_parse);
+    RUN_TEST(test_duplicate_entry_rejected);
+    RUN_TEST(test_duplicate_entry_close_previous);
+    RUN_TEST(test_duplicate_close_previous_rejected_entry);
+    RUN_TEST(test_duplicate_entry_allowed);
+    RUN_TEST(test_class_quotas);
+    RUN_TEST(test_gate_event_class);
+
+    // From test_server.c
+    RUN_TEST(test_server_entry_exit_commands);
+    RUN_TEST(test_server_occupancy_and_errors);
+    RUN_TEST(test_server_pipelined_socket);
+    RUN_TEST(test_server_backpressure);
+    RUN_TEST(test_binproto_handle);
+    RUN_TEST(test_binproto_pipelined_socket);
+
+    // From test_gate_pipeline.c
+    RUN_TEST(test_spsc_ring_full_and_wrap);
+    RUN_TEST(test_gate_pipeline_applies_all_gates);
+    RUN_TEST(test_gate_pipeline_result_handler);
+
+    // From test_occupancy_feed.c
+    RUN_TEST(test_occupancy_feed_publish_and_read);
+    RUN_TEST(test_occupancy_feed_open_missing);
+    RUN_TEST(test_occupancy_feed_open_old_layout);
+
+    // From test_bloom.c
+    RUN_TEST(test_bloom_add_remove);
+    RUN_TEST(test_bloom_rejects_unknown_exit);
+    RUN_TEST(test_bloom_false_positive_rate);
+
+    // From test_plate_index.c
+    RUN_TEST(test_plate_index_insert_find_remove);
+
+    // From test_debounce.c
+    RUN_TEST(test_debouncer_window);
+    RUN_TEST(test_gate_pipeline_debounce);
+
+    // From test_reorder.c
+    RUN_TEST(test_reorder_exit_before_entry);
+    RUN_TEST(test_reorder_late_and_dropped);
+    RUN_TEST(test_gate_pipeline_reorder);
+
+    // From test_gate_log.c
+    RUN_TEST(test_gate_event_parse_format);
+    RUN_TEST(test_gate_log_merge_order);
+    RUN_TEST(test_gate_log_replay);
+
+    // From test_alert_wheel.c
+    RUN_TEST(test_alert_wheel_overstay_then_closing);
+    RUN_TEST(test_alert_wheel_events_and_corrections);
+    RUN_TEST(test_alert_wheel_late_entry);
+
+    // From test_entry_heap.c
+    RUN_TEST(test_entry_heap_matches_model);
+    RUN_TEST(test_garage_longest_parked);
+
+    // From test_stay_index.c
+    RUN_TEST(test_stay_index_bitmaps);
+    RUN_TEST(test_stay_archive_lists);
+    RUN_TEST(test_garage_inside_at_matches_scan);
+    RUN_TEST(test_garage_inside_overnight_stay);
+
+    // From test_bay_map.c
+    RUN_TEST(test_bay_map_nearest_free);
+    RUN_TEST(test_garage_assigns_bays);
+    RUN_TEST(test_garage_swaps_bay_maps);
+
+    // From test_garage_manager.c
+    RUN_TEST(test_garage_manager_routes_and_totals);
+    RUN_TEST(test_garage_manager_rejects_invalid_and_full);
+
+    // From test_report_pool.c
+    RUN_TEST(test_report_pool_writes_all_reports);
+    RUN_TEST(test_report_pool_counts_failures);
+
+    // From test_partitioned_garage.c
+    RUN_TEST(test_partitioned_garage_global_admission);
+    RUN_TEST(test_partitioned_garage_lookup_and_exit);
+    RUN_TEST(test_partitioned_garage_rebalance);
+    RUN_TEST(test_partitioned_garage_overnight_exit);
+
+    // From test_replication.c
+    RUN_TEST(test_replication_standby_follows_primary);
+    RUN_TEST(test_replication_applies_by_ticket);
+    RUN_TEST(test_replication_log_full);
+    RUN_TEST(test_replication_overflow_diverges_standby);
+    RUN_TEST(test_replication_rejected_event_diverges);
+    RUN_TEST(test_replication_new_primary_epoch);
+
+    // From test_cdc.c
+    RUN_TEST(test_cdc_garage_mutations);
+    RUN_TEST(test_cdc_lapped_subscriber);
+    RUN_TEST(test_cdc_concurrent_subscriber);
+
+    // From test_garage_extra.c
+    RUN_TEST(test_correction_reprices_revenue);
+    RUN_TEST(test_correction_journal_wraps);
+    RUN_TEST(test_revenue_buckets);
+    RUN_TEST(test_invalid_times_rejected);
+    RUN_TEST(test_overnight_fee);
+    RUN_TEST(test_correction_reversing_stay_rejected);
 
     return UNITY_END();
 
@@ -9,6 +9,8 @@
 
 #include "unity.h"
 #include "garage.h"
+#include "gate_log.h"
+#include "server.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -240,3 +242,431 @@ void test_log_exit_vehicle_not_found(void) {
     TEST_ASSERT_EQUAL_INT(-1, fee);
 }
 
+
+static int count_visits(const Vehicle *v, void *ctx) {
+    (void)v;
+    (*(int *)ctx)++;
+    return 0;
+}
+
+static int stop_after_first(const Vehicle *v, void *ctx) {
+    *(const Vehicle **)ctx = v;
+    return 1;
+}
+
+/**
+ * @brief Test that the iterator selects by state and entry time without copying records.
+ */
+void test_vehicle_iterator_filters(void) {
+    Garage g = {0};
+    Time t1 = {7, 0}, t2 = {9, 30}, t3 = {11, 0}, out = {12, 0};
+    register_entry(&g, "ITER1", t1);
+    register_entry(&g, "ITER2", t2);
+    register_entry(&g, "ITER3", t3);
+    log_exit(&g, "ITER2", out);
+
+    VehicleFilter filter;
+    vehicle_filter_init(&filter, VEHICLES_ACTIVE);
+    filter.entered_before = 10 * 60;
+
+    VehicleIterator it;
+    vehicle_iter_init(&it, &g, &filter);
+    const Vehicle *v = vehicle_iter_next(&it);
+    TEST_ASSERT_EQUAL_PTR(&g.vehicles[0], v);
+    TEST_ASSERT_NULL(vehicle_iter_next(&it));
+
+    vehicle_filter_init(&filter, VEHICLES_EXITED);
+    vehicle_iter_init(&it, &g, &filter);
+    TEST_ASSERT_EQUAL_STRING("ITER2", vehicle_iter_next(&it)->license_plate);
+    TEST_ASSERT_NULL(vehicle_iter_next(&it));
+}
+
+static int plate_starts_with_b(const Vehicle *v, void *ctx) {
+    (void)ctx;
+    return v->license_plate[0] == 'B';
+}
+
+/**
+ * @brief Test garage_for_each() with a custom predicate and early stop.
+ */
+void test_garage_for_each_predicate_and_stop(void) {
+    Garage g = {0};
+    Time t = {8, 0};
+    register_entry(&g, "AAA1", t);
+    register_entry(&g, "BBB1", t);
+    register_entry(&g, "BBB2", t);
+
+    VehicleFilter filter;
+    vehicle_filter_init(&filter, VEHICLES_ALL);
+    filter.match = plate_starts_with_b;
+
+    int visits = 0;
+    TEST_ASSERT_EQUAL_INT(2, garage_for_each(&g, &filter, count_visits, &visits));
+    TEST_ASSERT_EQUAL_INT(2, visits);
+
+    const Vehicle *first = NULL;
+    TEST_ASSERT_EQUAL_INT(1, garage_for_each(&g, NULL, stop_after_first, &first));
+    TEST_ASSERT_EQUAL_PTR(&g.vehicles[0], first);
+}
+
+/**
+ * @brief Test exit and corrections through the ticket issued on entry.
+ */
+void test_ticket_exit_and_corrections(void) {
+    Garage g = {0};
+    Time in = {8, 0}, out = {10, 0}, fixed = {11, 0};
+    Ticket ticket = TICKET_INVALID;
+
+    TEST_ASSERT_EQUAL_INT(0, register_entry_ticket(&g, "TCK1", in, &ticket));
+    TEST_ASSERT_TRUE(ticket != TICKET_INVALID);
+    TEST_ASSERT_EQUAL_INT(-1, update_exit_time_by_ticket(&g, ticket, fixed));
+
+    TEST_ASSERT_EQUAL_INT(4, log_exit_by_ticket(&g, ticket, out));
+    TEST_ASSERT_EQUAL_INT(-1, log_exit_by_ticket(&g, ticket, out));
+    TEST_ASSERT_EQUAL_INT(0, update_exit_time_by_ticket(&g, ticket, fixed));
+    TEST_ASSERT_EQUAL_INT(11, g.vehicles[0].exit_time.hour);
+    TEST_ASSERT_EQUAL_INT(-1, log_exit_by_ticket(&g, TICKET_INVALID, out));
+}
+
+/**
+ * @brief Test that a full record table recycles exited slots and rejects stale tickets.
+ */
+void test_ticket_stale_after_slot_reuse(void) {
+    Garage g = {0};
+    Time in = {7, 0}, out = {9, 0};
+    Ticket first = TICKET_INVALID, reused = TICKET_INVALID;
+
+    register_entry_ticket(&g, "REUSE0", in, &first);
+    for (int i = 1; i < 100; ++i) {
+        char plate[10];
+        snprintf(plate, sizeof(plate), "REUSE%d", i);
+        register_entry(&g, plate, in);
+    }
+    TEST_ASSERT_EQUAL_INT(-1, register_entry(&g, "REUSE100", in));
+    TEST_ASSERT_EQUAL_INT(4, log_exit_by_ticket(&g, first, out));
+
+    // Garage has a free spot again; the new vehicle takes the recycled slot
+    TEST_ASSERT_EQUAL_INT(0, register_entry_ticket(&g, "REUSE100", out, &reused));
+    TEST_ASSERT_EQUAL_STRING("REUSE100", g.vehicles[0].license_plate);
+    TEST_ASSERT_TRUE(reused != first);
+    TEST_ASSERT_EQUAL_INT(-1, update_entry_time_by_ticket(&g, first, in));
+    TEST_ASSERT_EQUAL_INT(101, g.total_served);
+}
+
+/**
+ * @brief Test that ticket numbers survive a format/parse round trip.
+ */
+void test_ticket_format_and_parse(void) {
+    char buf[16];
+    format_ticket(0x1234u, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("0000004660", buf);
+    TEST_ASSERT_EQUAL_UINT32(0x1234u, parse_ticket(buf));
+    TEST_ASSERT_EQUAL_UINT32(TICKET_INVALID, parse_ticket("12AB"));
+    TEST_ASSERT_EQUAL_UINT32(TICKET_INVALID, parse_ticket(""));
+}
+
+/**
+ * @brief Test that a plate already inside is rejected by default.
+ */
+void test_duplicate_entry_rejected(void) {
+    Garage g = {0};
+    Time in = {8, 0}, again = {8, 5}, out = {9, 0};
+
+    TEST_ASSERT_EQUAL_INT(0, register_entry(&g, "DUP1", in));
+    TEST_ASSERT_EQUAL_INT(-2, register_entry(&g, "DUP1", again));
+    TEST_ASSERT_EQUAL_INT(1, g.count);
+
+    // After the exit the same plate may enter again
+    log_exit(&g, "DUP1", out);
+    TEST_ASSERT_EQUAL_INT(0, register_entry(&g, "DUP1", out));
+
+    GarageStats stats;
+    get_garage_stats(&g, &stats);
+    TEST_ASSERT_EQUAL_INT(1, stats.duplicate_entries);
+}
+
+/**
+ * @brief Test the close-previous policy: the earlier stay is closed at the re-entry time.
+ */
+void test_duplicate_entry_close_previous(void) {
+    Garage g = {0};
+    Time in = {8, 0}, again = {10, 0}, out = {11, 0};
+    set_duplicate_policy(&g, DUPLICATE_CLOSE_PREVIOUS);
+
+    register_entry(&g, "DUP2", in);
+    TEST_ASSERT_EQUAL_INT(0, register_entry(&g, "DUP2", again));
+    TEST_ASSERT_EQUAL_INT(1, g.vehicles[0].has_exited);
+    TEST_ASSERT_EQUAL_INT(10, g.vehicles[0].exit_time.hour);
+    TEST_ASSERT_EQUAL_INT(1, current_occupancy(&g));
+
+    TEST_ASSERT_EQUAL_INT(2, log_exit(&g, "DUP2", out));
+    TEST_ASSERT_EQUAL_INT(0, current_occupancy(&g));
+}
+
+/**
+ * @brief Test that a rejected re-entry leaves the previous stay open and unbilled.
+ */
+void test_duplicate_close_previous_rejected_entry(void) {
+    static Garage g;
+    init_garage(&g);
+    Time in = {8, 0}, again = {10, 0};
+    set_duplicate_policy(&g, DUPLICATE_CLOSE_PREVIOUS);
+    TEST_ASSERT_EQUAL_INT(0, set_class_quota(&g, CLASS_EV, 1));
+
+    register_entry_class(&g, "EV1", in, CLASS_EV, NULL);
+    register_entry(&g, "DUP4", in);
+    TEST_ASSERT_EQUAL_INT(-1, register_entry_class(&g, "DUP4", again, CLASS_EV, NULL));
+    TEST_ASSERT_EQUAL_INT(0, g.vehicles[1].has_exited);
+    TEST_ASSERT_EQUAL_INT(2, current_occupancy(&g));
+    TEST_ASSERT_EQUAL_INT64(0, g.revenue_cents);
+
+    // in a full garage the spot the previous stay frees admits the re-entry
+    for (int i = 2; i < GARAGE_CAPACITY; ++i) {
+        char plate[16];
+        snprintf(plate, sizeof(plate), "FULL%d", i);
+        TEST_ASSERT_EQUAL_INT(0, register_entry(&g, plate, in));
+    }
+    TEST_ASSERT_EQUAL_INT(0, register_entry(&g, "DUP4", again));
+    TEST_ASSERT_EQUAL_INT(1, g.history_count); // the closed stay's slot was recycled
+    TEST_ASSERT_EQUAL_STRING("DUP4", g.history[0].license_plate);
+    TEST_ASSERT_EQUAL_INT(GARAGE_CAPACITY, current_occupancy(&g));
+    TEST_ASSERT_EQUAL_INT64(400, g.revenue_cents);
+    free_garage(&g);
+}
+
+/**
+ * @brief Test the allow policy: exits close the earliest record first.
+ */
+void test_duplicate_entry_allowed(void) {
+    Garage g = {0};
+    Time in = {8, 0}, again = {9, 0}, out = {10, 0};
+    set_duplicate_policy(&g, DUPLICATE_ALLOW);
+
+    register_entry(&g, "DUP3", in);
+    TEST_ASSERT_EQUAL_INT(0, register_entry(&g, "DUP3", again));
+    TEST_ASSERT_EQUAL_INT(4, log_exit(&g, "DUP3", out));
+    TEST_ASSERT_EQUAL_INT(1, g.vehicles[0].has_exited);
+    TEST_ASSERT_EQUAL_INT(2, log_exit(&g, "DUP3", out));
+    TEST_ASSERT_EQUAL_INT(-1, log_exit(&g, "DUP3", out));
+}
+
+/**
+ * @brief Test that reserved class spots are admitted separately from the general pool.
+ */
+void test_class_quotas(void) {
+    static Garage g;
+    init_garage(&g);
+    char plate[20];
+
+    TEST_ASSERT_EQUAL_INT(-1, set_class_quota(&g, CLASS_STANDARD, 5));
+    TEST_ASSERT_EQUAL_INT(0, set_class_quota(&g, CLASS_EV, 2));
+    TEST_ASSERT_EQUAL_INT(0, set_class_quota(&g, CLASS_DISABLED, 3));
+    TEST_ASSERT_EQUAL_INT(-1, set_class_quota(&g, CLASS_PERMIT, GARAGE_CAPACITY));
+
+    TEST_ASSERT_EQUAL_INT(0, register_entry_class(&g, "EV1", (Time){8, 0}, CLASS_EV, NULL));
+    TEST_ASSERT_EQUAL_INT(0, register_entry_class(&g, "EV2", (Time){8, 1}, CLASS_EV, NULL));
+    TEST_ASSERT_EQUAL_INT(-1, register_entry_class(&g, "EV3", (Time){8, 2}, CLASS_EV, NULL));
+    TEST_ASSERT_EQUAL_INT(0, class_free_spots(&g, CLASS_EV));
+
+    // Standard cars and motorcycles share the 95 unreserved spots
+    for (int i = 0; i < 94; ++i) {
+        snprintf(plate, sizeof(plate), "STD%d", i);
+        TEST_ASSERT_EQUAL_INT(0, register_entry(&g, plate, (Time){9, 0}));
+    }
+    TEST_ASSERT_EQUAL_INT(0, register_entry_class(&g, "MOTO1", (Time){9, 5}, CLASS_MOTORCYCLE, NULL));
+    TEST_ASSERT_EQUAL_INT(-1, register_entry(&g, "STD94", (Time){9, 6}));
+    TEST_ASSERT_EQUAL_INT(0, register_entry_class(&g, "DIS1", (Time){9, 7}, CLASS_DISABLED, NULL));
+
+    log_exit(&g, "EV1", (Time){10, 0});
+    TEST_ASSERT_EQUAL_INT(1, class_occupancy(&g, CLASS_EV));
+    TEST_ASSERT_EQUAL_INT(1, class_free_spots(&g, CLASS_EV));
+    TEST_ASSERT_EQUAL_INT(0, class_free_spots(&g, CLASS_STANDARD));
+    TEST_ASSERT_EQUAL_INT(2, class_free_spots(&g, CLASS_DISABLED));
+}
+
+/**
+ * @brief Test that gate events carry the vehicle class through the text format.
+ */
+void test_gate_event_class(void) {
+    Garage g = {0};
+    GateEvent ev;
+    char line[64];
+
+    TEST_ASSERT_EQUAL_INT(0, gate_event_parse("ENTRY CLS1 08:00 PERMIT", &ev));
+    TEST_ASSERT_EQUAL_INT(CLASS_PERMIT, ev.vehicle_class);
+    gate_event_format(&ev, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("ENTRY CLS1 08:00 PERMIT\n", line);
+    TEST_ASSERT_EQUAL_INT(-1, gate_event_parse("ENTRY CLS1 08:00 TRUCK", &ev));
+
+    char out[32];
+    server_handle_line(&g, "ENTRY CLS2 08:00 EV", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("OK\n", out);
+    TEST_ASSERT_EQUAL_INT(CLASS_EV, g.vehicles[0].vehicle_class);
+    TEST_ASSERT_EQUAL_INT(1, class_occupancy(&g, CLASS_EV));
+}
+
+/**
+ * @brief Test that corrections re-price the stay and adjust the revenue.
+ */
+void test_correction_reprices_revenue(void) {
+    Garage g = {0};
+    register_entry(&g, "CORR1", (Time){8, 0});
+    register_entry(&g, "CORR2", (Time){9, 0});
+    TEST_ASSERT_EQUAL_INT(4, log_exit(&g, "CORR1", (Time){10, 0}));
+    TEST_ASSERT_EQUAL_INT(4, g.vehicles[0].fee);
+
+    TEST_ASSERT_EQUAL_INT(0, update_exit_time(&g, "CORR1", (Time){11, 30}));
+    TEST_ASSERT_EQUAL_INT(8, g.vehicles[0].fee);
+    TEST_ASSERT_EQUAL_INT(0, update_entry_time(&g, "CORR1", (Time){9, 15}));
+    TEST_ASSERT_EQUAL_INT(6, g.vehicles[0].fee);
+    TEST_ASSERT_EQUAL_INT(0, update_entry_time(&g, "CORR2", (Time){8, 45})); // still inside: no fee yet
+    TEST_ASSERT_EQUAL_INT(0, g.vehicles[1].fee);
+    TEST_ASSERT_EQUAL_INT64(600, g.revenue_cents);
+
+    Correction journal[4];
+    TEST_ASSERT_EQUAL_INT(3, garage_corrections(&g, journal, 4));
+    TEST_ASSERT_EQUAL_INT(EVENT_CORRECT_EXIT, journal[0].type);
+    TEST_ASSERT_EQUAL_INT(10, journal[0].old_time.hour);
+    TEST_ASSERT_EQUAL_INT(4, journal[0].old_fee);
+    TEST_ASSERT_EQUAL_INT(8, journal[0].new_fee);
+    TEST_ASSERT_EQUAL_INT(EVENT_CORRECT_ENTRY, journal[1].type);
+    TEST_ASSERT_EQUAL_INT(6, journal[1].new_fee);
+    TEST_ASSERT_EQUAL_STRING("CORR2", journal[2].license_plate);
+    TEST_ASSERT_EQUAL_INT(journal[2].old_fee, journal[2].new_fee);
+
+    // CORR2 is priced from its corrected entry time
+    TEST_ASSERT_EQUAL_INT(8, log_exit(&g, "CORR2", (Time){12, 45}));
+    RevenueAudit audit;
+    garage_revenue_audit(&g, &audit);
+    TEST_ASSERT_EQUAL_INT64(1400, audit.total_cents);
+    TEST_ASSERT_EQUAL_INT64(1200, audit.booked_cents);
+    TEST_ASSERT_EQUAL_INT64(200, audit.adjustment_cents);
+    TEST_ASSERT_EQUAL_INT(3, audit.corrections);
+}
+
+/**
+ * @brief Test that the journal keeps the newest corrections and the running totals.
+ */
+void test_correction_journal_wraps(void) {
+    Garage g = {0};
+    register_entry(&g, "WRAP1", (Time){8, 0});
+    log_exit(&g, "WRAP1", (Time){9, 0});
+
+    int corrections = CORRECTION_JOURNAL_CAPACITY + 5;
+    for (int i = 0; i < corrections; ++i) {
+        update_exit_time(&g, "WRAP1", (Time){9 + i % 4, 0});
+    }
+
+    Correction journal[CORRECTION_JOURNAL_CAPACITY];
+    TEST_ASSERT_EQUAL_INT(CORRECTION_JOURNAL_CAPACITY,
+                          garage_corrections(&g, journal, CORRECTION_JOURNAL_CAPACITY));
+    TEST_ASSERT_EQUAL_INT(5 % 4 + 9, journal[0].new_time.hour); // the five oldest were overwritten
+    TEST_ASSERT_EQUAL_INT((corrections - 1) % 4 + 9, journal[CORRECTION_JOURNAL_CAPACITY - 1].new_time.hour);
+
+    RevenueAudit audit;
+    garage_revenue_audit(&g, &audit);
+    TEST_ASSERT_EQUAL_INT(corrections, audit.corrections);
+    TEST_ASSERT_EQUAL_INT64(200, audit.booked_cents);
+    TEST_ASSERT_EQUAL_INT64(g.vehicles[0].fee * 100, audit.total_cents);
+    TEST_ASSERT_EQUAL_INT64(audit.booked_cents + audit.adjustment_cents, audit.total_cents);
+}
+
+/**
+ * @brief Test that revenue is bucketed by exit hour and class, and corrections move it.
+ */
+void test_revenue_buckets(void) {
+    Garage g = {0};
+    register_entry(&g, "HOUR1", (Time){8, 0});
+    register_entry_class(&g, "HOUR2", (Time){8, 0}, CLASS_EV, NULL);
+    register_entry(&g, "HOUR3", (Time){9, 0});
+    log_exit(&g, "HOUR1", (Time){9, 30});  // 4€ in hour 9
+    log_exit(&g, "HOUR2", (Time){10, 0});  // 4€ in hour 10
+    log_exit(&g, "HOUR3", (Time){10, 45}); // 4€ in hour 10
+
+    TEST_ASSERT_EQUAL_INT64(1200, g.revenue_cents);
+    TEST_ASSERT_EQUAL_INT64(400, g.revenue_by_hour[9]);
+    TEST_ASSERT_EQUAL_INT64(800, g.revenue_by_hour[10]);
+    TEST_ASSERT_EQUAL_INT64(800, g.revenue_by_class[CLASS_STANDARD]);
+    TEST_ASSERT_EQUAL_INT64(400, g.revenue_by_class[CLASS_EV]);
+    TEST_ASSERT_EQUAL_INT64(1200, garage_revenue_between(&g, 0, HOURS_PER_DAY));
+    TEST_ASSERT_EQUAL_INT64(800, garage_revenue_between(&g, 10, 11));
+
+    // Moving the exit to 12:15 takes 4€ out of hour 9 and books 10€ to hour 12
+    update_exit_time(&g, "HOUR1", (Time){12, 15});
+    TEST_ASSERT_EQUAL_INT64(0, g.revenue_by_hour[9]);
+    TEST_ASSERT_EQUAL_INT64(1000, g.revenue_by_hour[12]);
+    TEST_ASSERT_EQUAL_INT64(1800, g.revenue_cents);
+    TEST_ASSERT_EQUAL_INT64(1400, g.revenue_by_class[CLASS_STANDARD]);
+    TEST_ASSERT_EQUAL_INT64(g.revenue_cents, garage_revenue_between(&g, 0, HOURS_PER_DAY));
+
+    // An exit hour outside the day has no bucket and books nothing
+    register_entry(&g, "HOUR4", (Time){11, 0});
+    TEST_ASSERT_EQUAL_INT(-1, log_exit(&g, "HOUR4", (Time){26, 0}));
+    TEST_ASSERT_EQUAL_INT64(1800, g.revenue_cents);
+    TEST_ASSERT_EQUAL_INT64(g.revenue_cents, garage_revenue_between(&g, 0, HOURS_PER_DAY));
+}
+
+/**
+ * @brief Test that entries, exits and corrections with out-of-range times are rejected.
+ */
+void test_invalid_times_rejected(void) {
+    Garage g = {0};
+    Ticket ticket;
+    TEST_ASSERT_EQUAL_INT(-1, register_entry(&g, "BAD1", (Time){25, 30}));
+    TEST_ASSERT_EQUAL_INT(-1, register_entry(&g, "BAD1", (Time){8, 60}));
+    TEST_ASSERT_EQUAL_INT(-1, register_entry(&g, "BAD1", (Time){-1, 0}));
+    TEST_ASSERT_EQUAL_INT(0, g.count);
+
+    TEST_ASSERT_EQUAL_INT(0, register_entry_ticket(&g, "BAD1", (Time){8, 0}, &ticket));
+    TEST_ASSERT_EQUAL_INT(-1, update_entry_time(&g, "BAD1", (Time){24, 0}));
+    TEST_ASSERT_EQUAL_INT(-1, update_entry_time_by_ticket(&g, ticket, (Time){8, -5}));
+    TEST_ASSERT_EQUAL_INT(-1, log_exit(&g, "BAD1", (Time){26, 10}));
+    TEST_ASSERT_EQUAL_INT(-1, log_exit_by_ticket(&g, ticket, (Time){26, 10}));
+    TEST_ASSERT_EQUAL_INT(1, current_occupancy(&g));
+
+    TEST_ASSERT_EQUAL_INT(2, log_exit(&g, "BAD1", (Time){9, 0}));
+    TEST_ASSERT_EQUAL_INT(-1, update_exit_time(&g, "BAD1", (Time){9, 99}));
+    TEST_ASSERT_EQUAL_INT(-1, update_exit_time_by_ticket(&g, ticket, (Time){30, 0}));
+    TEST_ASSERT_EQUAL_INT(9, g.vehicles[0].exit_time.hour);
+    TEST_ASSERT_EQUAL_INT64(200, g.revenue_cents);
+}
+
+/**
+ * @brief Test that overnight stays are priced positive and reported as exits.
+ */
+void test_overnight_fee(void) {
+    Garage g = {0};
+    TEST_ASSERT_EQUAL_INT(4, calculate_fee((Time){23, 0}, (Time){1, 0}));
+    TEST_ASSERT_EQUAL_INT(0, calculate_fee((Time){8, 0}, (Time){8, 0}));
+
+    char out[32];
+    server_handle_line(&g, "ENTRY NIGHT1 23:00", out, sizeof(out));
+    server_handle_line(&g, "EXIT NIGHT1 01:00", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("FEE 4\n", out);
+    TEST_ASSERT_EQUAL_INT64(400, g.revenue_cents);
+
+    // An overnight stay stays overnight when its exit is corrected
+    TEST_ASSERT_EQUAL_INT(0, update_exit_time(&g, "NIGHT1", (Time){2, 30}));
+    TEST_ASSERT_EQUAL_INT(8, g.vehicles[0].fee);
+    TEST_ASSERT_EQUAL_INT64(800, g.revenue_cents);
+}
+
+/**
+ * @brief Test that corrections putting the exit before the entry are rejected.
+ */
+void test_correction_reversing_stay_rejected(void) {
+    Garage g = {0};
+    register_entry(&g, "REV1", (Time){8, 0});
+    TEST_ASSERT_EQUAL_INT(4, log_exit(&g, "REV1", (Time){10, 0}));
+
+    TEST_ASSERT_EQUAL_INT(-1, update_exit_time(&g, "REV1", (Time){7, 30}));
+    TEST_ASSERT_EQUAL_INT(-1, update_entry_time(&g, "REV1", (Time){10, 30}));
+    TEST_ASSERT_EQUAL_INT(10, g.vehicles[0].exit_time.hour);
+    TEST_ASSERT_EQUAL_INT(8, g.vehicles[0].entry_time.hour);
+    TEST_ASSERT_EQUAL_INT(4, g.vehicles[0].fee);
+    TEST_ASSERT_EQUAL_INT64(400, g.revenue_cents);
+    TEST_ASSERT_EQUAL_INT(0, g.corrections.total);
+
+    TEST_ASSERT_EQUAL_INT(0, update_entry_time(&g, "REV1", (Time){10, 0})); // zero-length stay is allowed
+    TEST_ASSERT_EQUAL_INT(0, g.vehicles[0].fee);
+}
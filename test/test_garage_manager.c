@@ -0,0 +1,103 @@
+/**
+ * @file test_garage_manager.c
+ * @brief Unit tests for the sharded multi-garage manager in garage_manager.c
+ */
+
+#include "unity.h"
+#include "garage.h"
+#include "garage_manager.h"
+#include <pthread.h>
+#include <stdio.h>
+
+#define MANAGER_TEST_GARAGES 5
+
+typedef struct {
+    GarageManager *m;
+    int producer;
+} ManagerProducerArgs;
+
+static void *manager_producer_thread(void *arg) {
+    ManagerProducerArgs *a = arg;
+    GateEvent ev = {0};
+    // Every producer parks 4 cars in each garage and takes 1 of them out again
+    for (int garage = 0; garage < MANAGER_TEST_GARAGES; ++garage) {
+        for (int i = 0; i < 4; ++i) {
+            ev.type = EVENT_ENTRY;
+            snprintf(ev.license_plate, sizeof(ev.license_plate), "M%d-%d-%d", a->producer, garage, i);
+            ev.time = (Time){8, i};
+            while (garage_manager_submit(a->m, a->producer, garage, &ev) != 0) {}
+        }
+        ev.type = EVENT_EXIT;
+        snprintf(ev.license_plate, sizeof(ev.license_plate), "M%d-%d-0", a->producer, garage);
+        ev.time = (Time){10, 0};
+        while (garage_manager_submit(a->m, a->producer, garage, &ev) != 0) {}
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test that events from several producers reach the right garages and add up in the totals.
+ */
+void test_garage_manager_routes_and_totals(void) {
+    GarageManager *m = garage_manager_create(MANAGER_TEST_GARAGES, 2, 3, 4);
+    TEST_ASSERT_NOT_NULL(m);
+    TEST_ASSERT_EQUAL_INT(1, garage_manager_worker_of(m, 3));
+    TEST_ASSERT_EQUAL_INT(-1, garage_manager_worker_of(m, MANAGER_TEST_GARAGES));
+    TEST_ASSERT_EQUAL_INT(0, garage_manager_start(m));
+
+    pthread_t threads[3];
+    ManagerProducerArgs args[3];
+    for (int i = 0; i < 3; ++i) {
+        args[i].m = m;
+        args[i].producer = i;
+        pthread_create(&threads[i], NULL, manager_producer_thread, &args[i]);
+    }
+    for (int i = 0; i < 3; ++i) pthread_join(threads[i], NULL);
+    garage_manager_stop(m);
+
+    ManagerTotals totals;
+    garage_manager_totals(m, &totals);
+    TEST_ASSERT_EQUAL_INT(MANAGER_TEST_GARAGES, totals.garages);
+    TEST_ASSERT_EQUAL_UINT64(3 * MANAGER_TEST_GARAGES * 5, totals.applied);
+    TEST_ASSERT_EQUAL_INT(3 * MANAGER_TEST_GARAGES * 4, totals.served);
+    TEST_ASSERT_EQUAL_INT(3 * MANAGER_TEST_GARAGES * 3, totals.inside);
+    TEST_ASSERT_EQUAL_INT64(3 * MANAGER_TEST_GARAGES * 400, totals.revenue_cents);
+
+    for (int id = 0; id < MANAGER_TEST_GARAGES; ++id) {
+        TEST_ASSERT_EQUAL_INT(9, garage_manager_occupancy(m, id));
+        TEST_ASSERT_EQUAL_INT(9, current_occupancy(garage_manager_garage(m, id)));
+    }
+    garage_manager_destroy(m);
+}
+
+/**
+ * @brief Test that invalid producers and garage ids are rejected and full rings are counted.
+ */
+void test_garage_manager_rejects_invalid_and_full(void) {
+    GarageManager *m = garage_manager_create(2, 4, 1, 2);
+    TEST_ASSERT_NOT_NULL(m);
+    TEST_ASSERT_NULL(garage_manager_garage(m, 2));
+
+    GateEvent ev = {0};
+    ev.type = EVENT_ENTRY;
+    ev.time = (Time){9, 0};
+    snprintf(ev.license_plate, sizeof(ev.license_plate), "FULL");
+    TEST_ASSERT_EQUAL_INT(-1, garage_manager_submit(m, 1, 0, &ev));
+    TEST_ASSERT_EQUAL_INT(-1, garage_manager_submit(m, 0, -1, &ev));
+
+    // Not started: the ring of garage 1 fills up after two events
+    TEST_ASSERT_EQUAL_INT(0, garage_manager_submit(m, 0, 1, &ev));
+    TEST_ASSERT_EQUAL_INT(0, garage_manager_submit(m, 0, 1, &ev));
+    TEST_ASSERT_EQUAL_INT(-1, garage_manager_submit(m, 0, 1, &ev));
+
+    TEST_ASSERT_EQUAL_INT(0, garage_manager_start(m));
+    garage_manager_stop(m);
+
+    ManagerTotals totals;
+    garage_manager_totals(m, &totals);
+    TEST_ASSERT_EQUAL_UINT64(1, totals.ring_full);
+    TEST_ASSERT_EQUAL_UINT64(2, totals.applied);
+    TEST_ASSERT_EQUAL_INT(1, garage_manager_occupancy(m, 1));
+    TEST_ASSERT_EQUAL_INT(0, garage_manager_occupancy(m, 0));
+    garage_manager_destroy(m);
+}
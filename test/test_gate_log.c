@@ -0,0 +1,100 @@
+/**
+ * @file test_gate_log.c
+ * @brief Unit tests for gate log parsing and the k-way merge in gate_log.c
+ */
+
+#include "unity.h"
+#include "gate_log.h"
+#include "garage.h"
+#include <stdio.h>
+#include <string.h>
+
+/// @brief Collects merged events for inspection
+typedef struct {
+    GateEvent events[16];
+    int sources[16];
+    int count;
+} Collected;
+
+static void collect(void *ctx, int source, const GateEvent *ev) {
+    Collected *c = ctx;
+    if (c->count < 16) {
+        c->events[c->count] = *ev;
+        c->sources[c->count] = source;
+    }
+    c->count++;
+}
+
+static void write_file(const char *path, const char *content) {
+    FILE *f = fopen(path, "w");
+    fputs(content, f);
+    fclose(f);
+}
+
+/**
+ * @brief Test that a formatted event parses back and bad lines are rejected.
+ */
+void test_gate_event_parse_format(void) {
+    GateEvent ev = {.type = EVENT_CORRECT_EXIT, .license_plate = "LOG1", .time = {7, 5}}, back;
+    char line[64];
+    gate_event_format(&ev, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("CORRECT_EXIT LOG1 07:05\n", line);
+
+    TEST_ASSERT_EQUAL_INT(0, gate_event_parse(line, &back));
+    TEST_ASSERT_EQUAL_INT(EVENT_CORRECT_EXIT, back.type);
+    TEST_ASSERT_EQUAL_STRING("LOG1", back.license_plate);
+    TEST_ASSERT_EQUAL_INT(5, back.time.minute);
+
+    TEST_ASSERT_EQUAL_INT(-1, gate_event_parse("PARK LOG1 07:05", &back));
+    TEST_ASSERT_EQUAL_INT(-1, gate_event_parse("ENTRY LOG1 25:00", &back));
+    TEST_ASSERT_EQUAL_INT(-1, gate_event_parse("ENTRY LOG1", &back));
+}
+
+/**
+ * @brief Test that three logs are merged in time order, ties in log order.
+ */
+void test_gate_log_merge_order(void) {
+    const char *paths[] = {"test_gate_log_a.log", "test_gate_log_b.log", "test_gate_log_c.log"};
+    write_file(paths[0], "ENTRY A1 08:00\nEXIT A1 10:00\n");
+    write_file(paths[1], "ENTRY B1 09:00\ngarbage\nEXIT B1 08:30\n");
+    write_file(paths[2], "ENTRY C1 08:00\n");
+
+    Collected c = {0};
+    GateLogStats stats;
+    TEST_ASSERT_EQUAL_INT(0, gate_log_merge(paths, 3, collect, &c, &stats));
+
+    TEST_ASSERT_EQUAL_INT(5, c.count);
+    TEST_ASSERT_EQUAL_STRING("A1", c.events[0].license_plate);
+    TEST_ASSERT_EQUAL_STRING("C1", c.events[1].license_plate);
+    TEST_ASSERT_EQUAL_INT(2, c.sources[1]);
+    TEST_ASSERT_EQUAL_STRING("B1", c.events[2].license_plate);
+    TEST_ASSERT_EQUAL_INT(EVENT_EXIT, c.events[3].type); // unsorted line comes right after its predecessor
+    TEST_ASSERT_EQUAL_INT(10, c.events[4].time.hour);
+    TEST_ASSERT_EQUAL_INT(1, (int)stats.malformed);
+    TEST_ASSERT_EQUAL_INT(1, (int)stats.unsorted);
+
+    const char *missing[] = {"test_gate_log_missing.log"};
+    TEST_ASSERT_EQUAL_INT(-1, gate_log_merge(missing, 1, collect, &c, NULL));
+
+    for (int i = 0; i < 3; ++i) remove(paths[i]);
+}
+
+/**
+ * @brief Test replaying logs where the exit gate's log lists the exit first.
+ */
+void test_gate_log_replay(void) {
+    const char *paths[] = {"test_gate_log_out.log", "test_gate_log_in.log"};
+    write_file(paths[0], "EXIT RPL1 11:00\nEXIT RPL2 12:00\n");
+    write_file(paths[1], "ENTRY RPL1 09:00\n");
+
+    Garage g = {0};
+    GateLogStats stats;
+    TEST_ASSERT_EQUAL_INT(0, gate_log_replay(&g, paths, 2, &stats));
+
+    TEST_ASSERT_EQUAL_INT(3, (int)stats.events);
+    TEST_ASSERT_EQUAL_INT(1, (int)stats.rejected); // RPL2 never entered
+    TEST_ASSERT_EQUAL_INT(1, g.vehicles[0].has_exited);
+    TEST_ASSERT_EQUAL_INT(0, current_occupancy(&g));
+
+    for (int i = 0; i < 2; ++i) remove(paths[i]);
+}
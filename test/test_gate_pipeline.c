@@ -0,0 +1,111 @@
+/**
+ * @file test_gate_pipeline.c
+ * @brief Unit tests for the SPSC ring in spsc_ring.c and the gate pipeline in gate_pipeline.c
+ */
+
+#include "unity.h"
+#include "garage.h"
+#include "gate_pipeline.h"
+#include "spsc_ring.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Test that the ring rejects pushes when full and preserves order across wrap-around.
+ */
+void test_spsc_ring_full_and_wrap(void) {
+    SpscRing r;
+    TEST_ASSERT_EQUAL_INT(0, spsc_ring_init(&r, 4, sizeof(int)));
+
+    for (int i = 0; i < 4; ++i) TEST_ASSERT_EQUAL_INT(0, spsc_ring_push(&r, &i));
+    int extra = 99;
+    TEST_ASSERT_EQUAL_INT(-1, spsc_ring_push(&r, &extra));
+
+    int out[4];
+    TEST_ASSERT_EQUAL_UINT(3, spsc_ring_pop_batch(&r, out, 3));
+    TEST_ASSERT_EQUAL_INT(0, out[0]);
+    TEST_ASSERT_EQUAL_INT(2, out[2]);
+
+    for (int i = 4; i < 7; ++i) TEST_ASSERT_EQUAL_INT(0, spsc_ring_push(&r, &i));
+    TEST_ASSERT_EQUAL_UINT(4, spsc_ring_pop_batch(&r, out, 4));
+    TEST_ASSERT_EQUAL_INT(3, out[0]);
+    TEST_ASSERT_EQUAL_INT(6, out[3]);
+    TEST_ASSERT_EQUAL_UINT(0, spsc_ring_pop_batch(&r, out, 4));
+
+    spsc_ring_free(&r);
+}
+
+typedef struct {
+    GatePipeline *p;
+    int gate;
+} PipelineGateArgs;
+
+static void *pipeline_gate_thread(void *arg) {
+    PipelineGateArgs *a = arg;
+    GateEvent ev = {0};
+    for (int i = 0; i < 20; ++i) {
+        ev.type = EVENT_ENTRY;
+        snprintf(ev.license_plate, sizeof(ev.license_plate), "PG%d-%d", a->gate, i);
+        ev.time.hour = 8;
+        ev.time.minute = i;
+        while (gate_pipeline_submit(a->p, a->gate, &ev) != 0) {}
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test that events from several gate threads all reach the garage exactly once.
+ */
+void test_gate_pipeline_applies_all_gates(void) {
+    Garage g = {0};
+    GatePipeline *p = gate_pipeline_create(&g, 3, 8);
+    TEST_ASSERT_NOT_NULL(p);
+    TEST_ASSERT_EQUAL_INT(0, gate_pipeline_start(p));
+
+    pthread_t threads[3];
+    PipelineGateArgs args[3];
+    for (int i = 0; i < 3; ++i) {
+        args[i].p = p;
+        args[i].gate = i;
+        pthread_create(&threads[i], NULL, pipeline_gate_thread, &args[i]);
+    }
+    for (int i = 0; i < 3; ++i) pthread_join(threads[i], NULL);
+    gate_pipeline_stop(p);
+
+    GatePipelineStats stats;
+    gate_pipeline_get_stats(p, &stats);
+    gate_pipeline_destroy(p);
+
+    TEST_ASSERT_EQUAL_UINT64(60, stats.applied);
+    TEST_ASSERT_EQUAL_UINT64(60, stats.submitted);
+    TEST_ASSERT_EQUAL_INT(60, g.count);
+    TEST_ASSERT_EQUAL_INT(60, g.total_served);
+}
+
+static void count_fees(void *ctx, int gate, const GateEvent *ev, int result) {
+    (void)gate;
+    if (ev->type == EVENT_EXIT && result > 0) *(int *)ctx += result;
+}
+
+/**
+ * @brief Test that the result handler sees the outcome of each applied event.
+ */
+void test_gate_pipeline_result_handler(void) {
+    Garage g = {0};
+    int fees = 0;
+    GatePipeline *p = gate_pipeline_create(&g, 1, 4);
+    gate_pipeline_set_result_handler(p, count_fees, &fees);
+
+    GateEvent in = {.type = EVENT_ENTRY, .license_plate = "HND1", .time = {9, 0}};
+    GateEvent out = {.type = EVENT_EXIT, .license_plate = "HND1", .time = {11, 30}};
+    TEST_ASSERT_EQUAL_INT(0, gate_pipeline_submit(p, 0, &in));
+    TEST_ASSERT_EQUAL_INT(0, gate_pipeline_submit(p, 0, &out));
+    TEST_ASSERT_EQUAL_INT(-1, gate_pipeline_submit(p, 1, &out));
+
+    gate_pipeline_start(p);
+    gate_pipeline_stop(p);
+    gate_pipeline_destroy(p);
+
+    TEST_ASSERT_EQUAL_INT(6, fees);
+}
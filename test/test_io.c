@@ -1,6 +1,6 @@
 /**
  * @file test_io.c
- * @brief Unit tests for the write_report() function in io.c
+ * @brief Unit tests for the report, occupancy curve and stays export in io.c
  */
 
 #include "unity.h"
@@ -33,7 +33,7 @@ void test_write_report_creates_file(void) {
 
     g.count = 2;
     g.total_served = 2;
-    g.total_revenue = 4.0;
+    g.revenue_cents = 400;
 
     const char *report_file = "test_report.txt";
     write_report(&g, report_file);
@@ -92,7 +92,7 @@ void test_vehicle_still_inside_after_22(void) {
 
     g.count = 1;
     g.total_served = 1;
-    g.total_revenue = 0.0;
+    g.revenue_cents = 0;
 
     const char *filename = "test_late.txt";
     write_report(&g, filename);
@@ -114,3 +114,194 @@ void test_vehicle_still_inside_after_22(void) {
     TEST_ASSERT_TRUE(found);
 }
 
+
+/**
+ * @brief Test the occupancy curve and peak through entries, exits and corrections.
+ */
+void test_occupancy_curve_and_peak(void) {
+    static Garage g;
+    init_garage(&g);
+    register_entry(&g, "CRV1", (Time){8, 0});
+    register_entry(&g, "CRV2", (Time){8, 30});
+    register_entry(&g, "CRV3", (Time){9, 0});
+    log_exit(&g, "CRV1", (Time){9, 0});
+    log_exit(&g, "CRV2", (Time){12, 0});
+    update_exit_time(&g, "CRV1", (Time){9, 15});
+
+    int curve[MINUTES_PER_DAY];
+    OccupancyPeak peak;
+    garage_occupancy_curve(&g, curve, &peak);
+
+    TEST_ASSERT_EQUAL_INT(0, curve[7 * 60 + 59]);
+    TEST_ASSERT_EQUAL_INT(1, curve[8 * 60]);
+    TEST_ASSERT_EQUAL_INT(3, curve[9 * 60 + 14]);
+    TEST_ASSERT_EQUAL_INT(2, curve[9 * 60 + 15]);
+    TEST_ASSERT_EQUAL_INT(1, curve[12 * 60]);
+    TEST_ASSERT_EQUAL_INT(1, curve[MINUTES_PER_DAY - 1]);
+    TEST_ASSERT_EQUAL_INT(3, peak.occupied);
+    TEST_ASSERT_EQUAL_INT(9, peak.time.hour);
+    TEST_ASSERT_EQUAL_INT(0, peak.time.minute);
+}
+
+/**
+ * @brief Test that an overnight stay counts from midnight to its exit and from its entry to midnight.
+ */
+void test_occupancy_curve_overnight_stay(void) {
+    static Garage g;
+    init_garage(&g);
+    register_entry(&g, "NGT1", (Time){22, 0});
+    register_entry(&g, "NGT2", (Time){1, 0});
+    log_exit(&g, "NGT1", (Time){2, 0});
+    log_exit(&g, "NGT2", (Time){3, 0});
+
+    int curve[MINUTES_PER_DAY];
+    OccupancyPeak peak;
+    garage_occupancy_curve(&g, curve, &peak);
+    TEST_ASSERT_EQUAL_INT(1, curve[0]);
+    TEST_ASSERT_EQUAL_INT(2, curve[1 * 60 + 30]);
+    TEST_ASSERT_EQUAL_INT(1, curve[2 * 60]);
+    TEST_ASSERT_EQUAL_INT(0, curve[12 * 60]);
+    TEST_ASSERT_EQUAL_INT(1, curve[22 * 60]);
+    TEST_ASSERT_EQUAL_INT(1, curve[MINUTES_PER_DAY - 1]);
+    TEST_ASSERT_EQUAL_INT(2, peak.occupied);
+    TEST_ASSERT_EQUAL_INT(1, peak.time.hour);
+
+    // corrections keep both parts of the stay
+    TEST_ASSERT_EQUAL_INT(0, update_entry_time(&g, "NGT1", (Time){23, 30}));
+    TEST_ASSERT_EQUAL_INT(0, update_exit_time(&g, "NGT1", (Time){0, 30}));
+    garage_occupancy_curve(&g, curve, &peak);
+    TEST_ASSERT_EQUAL_INT(1, curve[0]);
+    TEST_ASSERT_EQUAL_INT(0, curve[0 * 60 + 30]);
+    TEST_ASSERT_EQUAL_INT(0, curve[22 * 60 + 30]);
+    TEST_ASSERT_EQUAL_INT(1, curve[23 * 60 + 30]);
+    for (int m = 0; m < MINUTES_PER_DAY; ++m) TEST_ASSERT_TRUE(curve[m] >= 0);
+    TEST_ASSERT_EQUAL_INT(1, peak.occupied);
+    TEST_ASSERT_EQUAL_INT(0, peak.time.hour);
+}
+
+/**
+ * @brief Test that write_occupancy_csv writes one row per minute.
+ */
+void test_write_occupancy_csv(void) {
+    static Garage g;
+    init_garage(&g);
+    register_entry(&g, "CSV1", (Time){0, 1});
+
+    const char *filename = "test_occupancy.csv";
+    TEST_ASSERT_EQUAL_INT(0, write_occupancy_csv(&g, filename));
+    TEST_ASSERT_EQUAL_INT(-1, write_occupancy_csv(&g, "no_such_dir/test_occupancy.csv"));
+
+    FILE *fp = fopen(filename, "r");
+    TEST_ASSERT_NOT_NULL(fp);
+
+    char buffer[64];
+    int rows = 0;
+    TEST_ASSERT_NOT_NULL(fgets(buffer, sizeof(buffer), fp));
+    TEST_ASSERT_EQUAL_STRING("time,occupied\n", buffer);
+    while (fgets(buffer, sizeof(buffer), fp)) {
+        if (rows == 0) TEST_ASSERT_EQUAL_STRING("00:00,0\n", buffer);
+        if (rows == 1) TEST_ASSERT_EQUAL_STRING("00:01,1\n", buffer);
+        rows++;
+    }
+    fclose(fp);
+    TEST_ASSERT_EQUAL_INT(MINUTES_PER_DAY, rows);
+}
+
+/**
+ * @brief Test that the stays export holds aligned columns matching the records.
+ */
+void test_write_stays_columnar(void) {
+    static Garage g;
+    init_garage(&g);
+    register_entry(&g, "COL1", (Time){8, 0});
+    register_entry_class(&g, "COLUMN2", (Time){8, 30}, CLASS_EV, NULL);
+    register_entry(&g, "C3", (Time){9, 15});
+    log_exit(&g, "COL1", (Time){10, 30});
+    log_exit(&g, "C3", (Time){9, 45});
+
+    const char *filename = "test_stays.bin";
+    TEST_ASSERT_EQUAL_INT(0, write_stays_columnar(&g, filename));
+
+    static unsigned char file[4096];
+    FILE *fp = fopen(filename, "rb");
+    TEST_ASSERT_NOT_NULL(fp);
+    size_t size = fread(file, 1, sizeof(file), fp);
+    fclose(fp);
+
+    StaysHeader h;
+    TEST_ASSERT_TRUE(size >= sizeof(h));
+    memcpy(&h, file, sizeof(h));
+    TEST_ASSERT_EQUAL_MEMORY(STAYS_MAGIC, h.magic, sizeof(h.magic));
+    TEST_ASSERT_EQUAL_UINT32(3, h.rows);
+    TEST_ASSERT_EQUAL_UINT32(13, h.plate_bytes);
+    TEST_ASSERT_EQUAL_UINT64(0, h.fee_cents % STAYS_ALIGNMENT);
+    TEST_ASSERT_TRUE(h.vehicle_class + h.rows <= size);
+    TEST_ASSERT_EQUAL_UINT64(0, size % STAYS_ALIGNMENT);
+
+    const uint32_t *offsets = (const uint32_t *)(file + h.plate_offsets);
+    const char *plates = (const char *)(file + h.plate_data);
+    const int16_t *entries = (const int16_t *)(file + h.entry_minute);
+    const int16_t *exits = (const int16_t *)(file + h.exit_minute);
+    const int32_t *fees = (const int32_t *)(file + h.fee_cents);
+    const uint8_t *classes = file + h.vehicle_class;
+
+    TEST_ASSERT_EQUAL_UINT32(4, offsets[1]);
+    TEST_ASSERT_EQUAL_UINT32(13, offsets[3]);
+    TEST_ASSERT_EQUAL_MEMORY("COLUMN2", plates + offsets[1], offsets[2] - offsets[1]);
+    TEST_ASSERT_EQUAL_INT16(8 * 60 + 30, entries[1]);
+    TEST_ASSERT_EQUAL_INT16(10 * 60 + 30, exits[0]);
+    TEST_ASSERT_EQUAL_INT16(-1, exits[1]);
+    TEST_ASSERT_EQUAL_INT32(600, fees[0]);
+    TEST_ASSERT_EQUAL_INT32(0, fees[1]);
+    TEST_ASSERT_EQUAL_INT32(200, fees[2]);
+    TEST_ASSERT_EQUAL_UINT8(CLASS_EV, classes[1]);
+    remove(filename);
+}
+
+/**
+ * @brief Test that stays whose record slots were recycled stay in the report, audits and export.
+ */
+void test_busy_day_keeps_recycled_stays(void) {
+    static Garage g;
+    init_garage(&g);
+    for (int i = 0; i < 150; ++i) {
+        char plate[16];
+        snprintf(plate, sizeof(plate), "BUSY%d", i);
+        int minute = 6 * 60 + i;
+        TEST_ASSERT_EQUAL_INT(0, register_entry(&g, plate, (Time){minute / 60, minute % 60}));
+        TEST_ASSERT_EQUAL_INT(2, log_exit(&g, plate, (Time){(minute + 1) / 60, (minute + 1) % 60}));
+    }
+    TEST_ASSERT_EQUAL_INT(50, g.history_count);
+
+    const Vehicle *inside[4];
+    TEST_ASSERT_EQUAL_INT(1, garage_inside_at(&g, (Time){6, 0}, inside, 4));
+    TEST_ASSERT_EQUAL_STRING("BUSY0", inside[0]->license_plate);
+
+    const char *report_file = "test_busy_report.txt";
+    TEST_ASSERT_EQUAL_INT(0, write_report(&g, report_file));
+    FILE *fp = fopen(report_file, "r");
+    TEST_ASSERT_NOT_NULL(fp);
+    char buffer[256];
+    int served = 0, first = 0;
+    while (fgets(buffer, sizeof(buffer), fp)) {
+        if (strstr(buffer, "BUSY")) served++;
+        if (strstr(buffer, "BUSY0 ")) first = 1;
+    }
+    fclose(fp);
+    remove(report_file);
+    TEST_ASSERT_EQUAL_INT(150, served);
+    TEST_ASSERT_TRUE(first);
+
+    const char *stays_file = "test_busy_stays.bin";
+    TEST_ASSERT_EQUAL_INT(0, write_stays_columnar(&g, stays_file));
+    StaysHeader h;
+    fp = fopen(stays_file, "rb");
+    TEST_ASSERT_NOT_NULL(fp);
+    TEST_ASSERT_EQUAL_size_t(1, fread(&h, sizeof(h), 1, fp));
+    fclose(fp);
+    remove(stays_file);
+    TEST_ASSERT_EQUAL_UINT32(150, h.rows);
+
+    free_garage(&g);
+    TEST_ASSERT_NULL(g.history);
+}
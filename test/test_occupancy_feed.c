@@ -0,0 +1,75 @@
+/**
+ * @file test_occupancy_feed.c
+ * @brief Unit tests for the shared-memory occupancy feed in occupancy_feed.c
+ */
+
+#include "unity.h"
+#include "garage.h"
+#include "occupancy_feed.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/**
+ * @brief Test that a reader sees each published garage state.
+ */
+void test_occupancy_feed_publish_and_read(void) {
+    char name[64];
+    snprintf(name, sizeof(name), "/pgs_test_feed_%d", (int)getpid());
+
+    Garage g = {0};
+    OccupancyFeed *writer = occupancy_feed_create(name);
+    TEST_ASSERT_NOT_NULL(writer);
+    OccupancyFeed *reader = occupancy_feed_open(name);
+    TEST_ASSERT_NOT_NULL(reader);
+
+    Time in = {8, 0}, out = {9, 0};
+    register_entry(&g, "FEED1", in);
+    register_entry(&g, "FEED2", in);
+    occupancy_feed_publish(writer, &g);
+
+    OccupancySnapshot snap;
+    occupancy_feed_read(reader, &snap);
+    TEST_ASSERT_EQUAL_INT(2, snap.occupied);
+    TEST_ASSERT_EQUAL_INT(98, snap.free_spots);
+    TEST_ASSERT_EQUAL_INT(98, snap.zone_free[0]);
+    TEST_ASSERT_EQUAL_UINT64(1, snap.updates);
+
+    log_exit(&g, "FEED1", out);
+    occupancy_feed_publish(writer, &g);
+    occupancy_feed_read(reader, &snap);
+    TEST_ASSERT_EQUAL_INT(1, snap.occupied);
+    TEST_ASSERT_EQUAL_INT(2, snap.total_served);
+    TEST_ASSERT_EQUAL_INT64(200, snap.revenue_cents);
+    TEST_ASSERT_EQUAL_UINT64(2, snap.updates);
+
+    occupancy_feed_close(reader);
+    occupancy_feed_close(writer);
+}
+
+/**
+ * @brief Test that opening a feed that was never created fails.
+ */
+void test_occupancy_feed_open_missing(void) {
+    TEST_ASSERT_NULL(occupancy_feed_open("/pgs_test_feed_missing"));
+}
+
+/**
+ * @brief Test that a segment written with the previous, smaller layout is refused.
+ */
+void test_occupancy_feed_open_old_layout(void) {
+    char name[64];
+    snprintf(name, sizeof(name), "/pgs_test_feed_old_%d", (int)getpid());
+
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    TEST_ASSERT_TRUE(fd >= 0);
+    uint32_t old_magic = 0x47415246u; // "GARF", layout without class_free
+    TEST_ASSERT_EQUAL_INT(0, ftruncate(fd, 80));
+    TEST_ASSERT_EQUAL_INT((int)sizeof(old_magic), (int)write(fd, &old_magic, sizeof(old_magic)));
+    close(fd);
+
+    TEST_ASSERT_NULL(occupancy_feed_open(name));
+    shm_unlink(name);
+}
@@ -0,0 +1,144 @@
+/**
+ * @file test_partitioned_garage.c
+ * @brief Unit tests for the plate-partitioned garage in partitioned_garage.c
+ */
+
+#include "unity.h"
+#include "partitioned_garage.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    PartitionedGarage *pg;
+    int thread;
+    int admitted;
+} PartitionEntryArgs;
+
+static void *partition_entry_thread(void *arg) {
+    PartitionEntryArgs *a = arg;
+    char plate[20];
+    for (int i = 0; i < 150; ++i) {
+        snprintf(plate, sizeof(plate), "PT%d-%d", a->thread, i);
+        if (partitioned_garage_entry(a->pg, plate, (Time){8, i % 60}, CLASS_STANDARD) == 0) a->admitted++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test that concurrent entries never admit more vehicles than the site capacity.
+ */
+void test_partitioned_garage_global_admission(void) {
+    PartitionedGarage *pg = partitioned_garage_create(8, 300);
+    TEST_ASSERT_NOT_NULL(pg);
+
+    pthread_t threads[4];
+    PartitionEntryArgs args[4];
+    for (int i = 0; i < 4; ++i) {
+        args[i] = (PartitionEntryArgs){pg, i, 0};
+        pthread_create(&threads[i], NULL, partition_entry_thread, &args[i]);
+    }
+    int admitted = 0;
+    for (int i = 0; i < 4; ++i) {
+        pthread_join(threads[i], NULL);
+        admitted += args[i].admitted;
+    }
+
+    PartitionStats stats;
+    partitioned_garage_stats(pg, &stats);
+    TEST_ASSERT_EQUAL_INT(300, admitted);
+    TEST_ASSERT_EQUAL_INT(300, partitioned_garage_occupancy(pg));
+    TEST_ASSERT_EQUAL_INT(300, stats.served);
+    TEST_ASSERT_EQUAL_INT(8, stats.shards);
+    partitioned_garage_destroy(pg);
+}
+
+/**
+ * @brief Test entry, lookup, duplicate rejection and exit through the owning shard.
+ */
+void test_partitioned_garage_lookup_and_exit(void) {
+    PartitionedGarage *pg = partitioned_garage_create(4, 1000);
+    TEST_ASSERT_NOT_NULL(pg);
+
+    int shard = partitioned_garage_shard_of(pg, "KEY42");
+    TEST_ASSERT_TRUE(shard >= 0 && shard < 4);
+    TEST_ASSERT_EQUAL_INT(shard, partitioned_garage_shard_of(pg, "KEY42"));
+
+    TEST_ASSERT_EQUAL_INT(0, partitioned_garage_entry(pg, "KEY42", (Time){9, 15}, CLASS_EV));
+    TEST_ASSERT_EQUAL_INT(-2, partitioned_garage_entry(pg, "KEY42", (Time){9, 20}, CLASS_EV));
+    TEST_ASSERT_EQUAL_INT(1, partitioned_garage_occupancy(pg));
+
+    Vehicle v;
+    TEST_ASSERT_EQUAL_INT(0, partitioned_garage_find(pg, "KEY42", &v));
+    TEST_ASSERT_EQUAL_STRING("KEY42", v.license_plate);
+    TEST_ASSERT_EQUAL_INT(CLASS_EV, v.vehicle_class);
+    TEST_ASSERT_EQUAL_INT(-1, partitioned_garage_find(pg, "KEY43", &v));
+
+    TEST_ASSERT_EQUAL_INT(4, partitioned_garage_exit(pg, "KEY42", (Time){10, 45}));
+    TEST_ASSERT_EQUAL_INT(-1, partitioned_garage_exit(pg, "KEY42", (Time){11, 0}));
+    TEST_ASSERT_EQUAL_INT(0, partitioned_garage_occupancy(pg));
+    TEST_ASSERT_EQUAL_INT(-1, partitioned_garage_find(pg, "KEY42", &v));
+    partitioned_garage_destroy(pg);
+}
+
+/**
+ * @brief Test that growing the ring moves only some plates and keeps every record.
+ */
+void test_partitioned_garage_rebalance(void) {
+    PartitionedGarage *pg = partitioned_garage_create(4, 1000);
+    char plate[20];
+    int before[200];
+    for (int i = 0; i < 200; ++i) {
+        snprintf(plate, sizeof(plate), "RB%d", i);
+        TEST_ASSERT_EQUAL_INT(0, partitioned_garage_entry(pg, plate, (Time){7, i % 60}, CLASS_STANDARD));
+        if (i % 4 == 0) partitioned_garage_exit(pg, plate, (Time){9, 0});
+        before[i] = partitioned_garage_shard_of(pg, plate);
+    }
+
+    int moved = -1;
+    TEST_ASSERT_EQUAL_INT(0, partitioned_garage_rebalance(pg, 5, &moved));
+
+    int changed = 0;
+    for (int i = 0; i < 200; ++i) {
+        snprintf(plate, sizeof(plate), "RB%d", i);
+        int after = partitioned_garage_shard_of(pg, plate);
+        // Consistent hashing: plates only ever move to the new shard
+        if (after != before[i]) {
+            TEST_ASSERT_EQUAL_INT(4, after);
+            changed++;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(changed, moved);
+    TEST_ASSERT_TRUE(moved > 0 && moved < 100);
+
+    PartitionStats stats;
+    partitioned_garage_stats(pg, &stats);
+    TEST_ASSERT_EQUAL_INT(5, stats.shards);
+    TEST_ASSERT_EQUAL_INT(150, stats.inside);
+    TEST_ASSERT_EQUAL_INT(200, stats.served);
+    TEST_ASSERT_EQUAL_INT64(50 * 400, stats.revenue_cents);
+
+    Vehicle v;
+    TEST_ASSERT_EQUAL_INT(0, partitioned_garage_find(pg, "RB1", &v));
+    TEST_ASSERT_EQUAL_INT(-1, partitioned_garage_find(pg, "RB0", &v));
+    TEST_ASSERT_TRUE(partitioned_garage_exit(pg, "RB1", (Time){12, 0}) > 0);
+
+    // 149 vehicles inside do not fit into one shard's records
+    TEST_ASSERT_EQUAL_INT(-1, partitioned_garage_rebalance(pg, 1, NULL));
+    TEST_ASSERT_EQUAL_INT(149, partitioned_garage_occupancy(pg));
+    partitioned_garage_destroy(pg);
+}
+
+/**
+ * @brief Test that an overnight exit releases its admission slot.
+ */
+void test_partitioned_garage_overnight_exit(void) {
+    PartitionedGarage *pg = partitioned_garage_create(2, 1);
+    TEST_ASSERT_NOT_NULL(pg);
+    TEST_ASSERT_EQUAL_INT(0, partitioned_garage_entry(pg, "NIGHT1", (Time){23, 0}, CLASS_STANDARD));
+    TEST_ASSERT_EQUAL_INT(-1, partitioned_garage_entry(pg, "NIGHT2", (Time){23, 30}, CLASS_STANDARD));
+    TEST_ASSERT_TRUE(partitioned_garage_exit(pg, "NIGHT1", (Time){1, 0}) != -1);
+    TEST_ASSERT_EQUAL_INT(0, partitioned_garage_occupancy(pg));
+    TEST_ASSERT_EQUAL_INT(0, partitioned_garage_entry(pg, "NIGHT2", (Time){1, 5}, CLASS_STANDARD));
+    partitioned_garage_destroy(pg);
+}
@@ -0,0 +1,30 @@
+/**
+ * @file test_plate_index.c
+ * @brief Unit tests for the plate hash index in plate_index.c
+ */
+
+#include "unity.h"
+#include "functions.h"
+#include "plate_index.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Test insert, find and backward-shift removal with colliding buckets.
+ */
+void test_plate_index_insert_find_remove(void) {
+    static PlateIndex idx;
+    char plates[3][20] = {"IDX1", "IDX2", "IDX3"};
+    memset(&idx, 0, sizeof(idx));
+
+    // Force all three into the same probe run by reusing one hash
+    uint64_t h = plate_hash("IDX1");
+    for (int i = 0; i < 3; ++i) plate_index_insert(&idx, h, i);
+
+    TEST_ASSERT_EQUAL_INT(1, plate_index_find(&idx, plates[0], sizeof(plates[0]), "IDX2", h));
+    TEST_ASSERT_EQUAL_INT(1, plate_index_remove(&idx, h, 0));
+    TEST_ASSERT_EQUAL_INT(-1, plate_index_find(&idx, plates[0], sizeof(plates[0]), "IDX1", h));
+    TEST_ASSERT_EQUAL_INT(2, plate_index_find(&idx, plates[0], sizeof(plates[0]), "IDX3", h));
+    TEST_ASSERT_EQUAL_INT(0, plate_index_remove(&idx, h, 0));
+    TEST_ASSERT_EQUAL_INT(-1, plate_index_find(&idx, plates[0], sizeof(plates[0]), "NOPE", plate_hash("NOPE")));
+}
@@ -0,0 +1,81 @@
+/**
+ * @file test_reorder.c
+ * @brief Unit tests for the event-time reorder buffer in reorder.c and its use by gate_pipeline.c
+ */
+
+#include "unity.h"
+#include "reorder.h"
+#include "gate_pipeline.h"
+#include "garage.h"
+#include <stdio.h>
+
+/**
+ * @brief Test that an exit delivered before its entry is applied after it.
+ */
+void test_reorder_exit_before_entry(void) {
+    Garage g = {0};
+    static ReorderBuffer rb;
+    reorder_init(&rb, &g, 10);
+
+    GateEvent out = {.type = EVENT_EXIT, .license_plate = "ORD1", .time = {10, 0}};
+    GateEvent in = {.type = EVENT_ENTRY, .license_plate = "ORD1", .time = {8, 30}};
+    GateEvent other = {.type = EVENT_ENTRY, .license_plate = "ORD2", .time = {10, 5}};
+
+    TEST_ASSERT_EQUAL_INT(0, reorder_push(&rb, 0, &out));
+    TEST_ASSERT_EQUAL_INT(1, reorder_push(&rb, 1, &in)); // below the watermark already
+    TEST_ASSERT_EQUAL_INT(0, reorder_push(&rb, 1, &other));
+    TEST_ASSERT_EQUAL_INT(1, g.count);
+
+    TEST_ASSERT_EQUAL_INT(2, reorder_flush(&rb));
+    TEST_ASSERT_EQUAL_INT(1, g.vehicles[0].has_exited);
+    TEST_ASSERT_EQUAL_INT(1, current_occupancy(&g));
+    TEST_ASSERT_EQUAL_INT(0, (int)rb.stats.dropped);
+    TEST_ASSERT_EQUAL_INT(2, rb.stats.max_depth);
+}
+
+/**
+ * @brief Test the late and dropped counters.
+ */
+void test_reorder_late_and_dropped(void) {
+    Garage g = {0};
+    static ReorderBuffer rb;
+    reorder_init(&rb, &g, 0);
+
+    GateEvent in = {.type = EVENT_ENTRY, .license_plate = "ORD3", .time = {9, 0}};
+    GateEvent late_in = {.type = EVENT_ENTRY, .license_plate = "ORD4", .time = {8, 0}};
+    GateEvent stray = {.type = EVENT_EXIT, .license_plate = "ORD5", .time = {9, 30}};
+
+    TEST_ASSERT_EQUAL_INT(1, reorder_push(&rb, 0, &in));
+    TEST_ASSERT_EQUAL_INT(1, reorder_push(&rb, 0, &late_in)); // applied at once, out of order
+    TEST_ASSERT_EQUAL_INT(1, reorder_push(&rb, 0, &stray));   // exit without entry
+
+    TEST_ASSERT_EQUAL_INT(3, (int)rb.stats.applied);
+    TEST_ASSERT_EQUAL_INT(1, (int)rb.stats.late);
+    TEST_ASSERT_EQUAL_INT(1, (int)rb.stats.dropped);
+    TEST_ASSERT_EQUAL_INT(2, g.count);
+}
+
+/**
+ * @brief Test that a reordering pipeline matches an exit submitted on another gate first.
+ */
+void test_gate_pipeline_reorder(void) {
+    Garage g = {0};
+    GatePipeline *p = gate_pipeline_create(&g, 2, 8);
+    TEST_ASSERT_EQUAL_INT(0, gate_pipeline_set_reorder(p, 30));
+
+    GateEvent out = {.type = EVENT_EXIT, .license_plate = "ORD6", .time = {12, 0}};
+    GateEvent in = {.type = EVENT_ENTRY, .license_plate = "ORD6", .time = {11, 50}};
+    gate_pipeline_submit(p, 0, &out);
+    gate_pipeline_submit(p, 1, &in);
+
+    gate_pipeline_start(p);
+    gate_pipeline_stop(p);
+
+    GatePipelineStats stats;
+    gate_pipeline_get_stats(p, &stats);
+    gate_pipeline_destroy(p);
+
+    TEST_ASSERT_EQUAL_INT(0, (int)stats.dropped);
+    TEST_ASSERT_EQUAL_INT(1, g.vehicles[0].has_exited);
+    TEST_ASSERT_EQUAL_INT(0, current_occupancy(&g));
+}
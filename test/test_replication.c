@@ -0,0 +1,297 @@
+/**
+ * @file test_replication.c
+ * @brief Unit tests for primary/standby log shipping in replication.c
+ */
+
+#include "unity.h"
+#include "garage.h"
+#include "functions.h"
+#include "replication.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static void *standby_thread(void *arg) {
+    standby_run(arg);
+    return NULL;
+}
+
+/**
+ * @brief Test that the standby ends up with the primary's vehicles, fees and corrections.
+ */
+void test_replication_standby_follows_primary(void) {
+    static Garage primary, standby;
+    init_garage(&primary);
+    init_garage(&standby);
+    const char *path = "test_replication.sock";
+
+    // The primary starts first: events are kept until the standby is reachable
+    Replicator *r = replicator_create(path, 1024);
+    TEST_ASSERT_NOT_NULL(r);
+    garage_set_replicator(&primary, r);
+
+    char plate[20];
+    Ticket ticket;
+    for (int i = 0; i < 40; ++i) {
+        snprintf(plate, sizeof(plate), "REP%d", i);
+        TEST_ASSERT_EQUAL_INT(0, register_entry(&primary, plate, (Time){7, i}));
+    }
+    TEST_ASSERT_EQUAL_INT(-2, register_entry(&primary, "REP0", (Time){7, 50}));
+    TEST_ASSERT_EQUAL_INT(-1, replicator_sync(r, 50));
+
+    Standby *s = standby_create(&standby, path);
+    TEST_ASSERT_NOT_NULL(s);
+    pthread_t thread;
+    pthread_create(&thread, NULL, standby_thread, s);
+
+    for (int i = 0; i < 40; i += 3) {
+        snprintf(plate, sizeof(plate), "REP%d", i);
+        log_exit(&primary, plate, (Time){11, 30});
+    }
+    TEST_ASSERT_EQUAL_INT(0, register_entry_class(&primary, "REPEV", (Time){8, 0}, CLASS_EV, &ticket));
+    TEST_ASSERT_EQUAL_INT(0, update_entry_time(&primary, "REP1", (Time){6, 45}));
+    TEST_ASSERT_EQUAL_INT(0, update_exit_time(&primary, "REP3", (Time){12, 15}));
+    TEST_ASSERT_TRUE(log_exit_by_ticket(&primary, ticket, (Time){9, 0}) >= 0);
+
+    TEST_ASSERT_EQUAL_INT(0, replicator_sync(r, 5000));
+    ReplicationStats stats;
+    replicator_get_stats(r, &stats);
+    TEST_ASSERT_EQUAL_UINT64(58, stats.appended);
+    TEST_ASSERT_EQUAL_UINT64(58, stats.acked);
+    TEST_ASSERT_EQUAL_UINT64(0, stats.lag_events);
+    TEST_ASSERT_EQUAL_UINT64(0, stats.dropped);
+    TEST_ASSERT_EQUAL_INT(1, stats.connected);
+    TEST_ASSERT_TRUE(stats.batches >= 1);
+
+    standby_stop(s);
+    pthread_join(thread, NULL);
+    StandbyStats sstats;
+    standby_get_stats(s, &sstats);
+    standby_destroy(s);
+    replicator_destroy(r);
+
+    TEST_ASSERT_EQUAL_UINT64(58, sstats.applied_seq);
+    TEST_ASSERT_EQUAL_UINT64(0, sstats.rejected);
+    TEST_ASSERT_EQUAL_INT(primary.count, standby.count);
+    TEST_ASSERT_EQUAL_INT(current_occupancy(&primary), current_occupancy(&standby));
+    TEST_ASSERT_EQUAL_INT(primary.total_served, standby.total_served);
+    TEST_ASSERT_EQUAL_INT64(primary.revenue_cents, standby.revenue_cents);
+    TEST_ASSERT_EQUAL_INT64_ARRAY(primary.revenue_by_hour, standby.revenue_by_hour, HOURS_PER_DAY);
+    TEST_ASSERT_EQUAL_INT(0, class_occupancy(&standby, CLASS_EV));
+    for (int i = 0; i < primary.count; ++i) {
+        TEST_ASSERT_EQUAL_STRING(primary.vehicles[i].license_plate, standby.vehicles[i].license_plate);
+        TEST_ASSERT_EQUAL_INT(primary.vehicles[i].has_exited, standby.vehicles[i].has_exited);
+        TEST_ASSERT_EQUAL_INT(primary.vehicles[i].entry_time.minute, standby.vehicles[i].entry_time.minute);
+        TEST_ASSERT_EQUAL_INT(primary.vehicles[i].exit_time.minute, standby.vehicles[i].exit_time.minute);
+    }
+}
+
+/**
+ * @brief Test that exits and corrections by ticket change the same record on the standby.
+ */
+void test_replication_applies_by_ticket(void) {
+    static Garage primary, standby;
+    init_garage(&primary);
+    init_garage(&standby);
+    set_duplicate_policy(&primary, DUPLICATE_ALLOW);
+    set_duplicate_policy(&standby, DUPLICATE_ALLOW);
+    const char *path = "test_replication_ticket.sock";
+
+    Standby *s = standby_create(&standby, path);
+    TEST_ASSERT_NOT_NULL(s);
+    pthread_t thread;
+    pthread_create(&thread, NULL, standby_thread, s);
+    Replicator *r = replicator_create(path, 64);
+    TEST_ASSERT_NOT_NULL(r);
+    garage_set_replicator(&primary, r);
+
+    // the later record of the plate is exited and corrected, the earlier one stays inside
+    Ticket first, later;
+    TEST_ASSERT_EQUAL_INT(0, register_entry_ticket(&primary, "TIX1", (Time){8, 0}, &first));
+    TEST_ASSERT_EQUAL_INT(0, register_entry_ticket(&primary, "TIX1", (Time){9, 0}, &later));
+    TEST_ASSERT_EQUAL_INT(2, log_exit_by_ticket(&primary, later, (Time){10, 0}));
+    TEST_ASSERT_EQUAL_INT(0, update_entry_time_by_ticket(&primary, later, (Time){8, 30}));
+    TEST_ASSERT_EQUAL_INT(0, update_exit_time_by_ticket(&primary, later, (Time){11, 0}));
+    TEST_ASSERT_EQUAL_INT(0, update_entry_time_by_ticket(&primary, first, (Time){7, 45}));
+
+    TEST_ASSERT_EQUAL_INT(0, replicator_sync(r, 5000));
+    standby_stop(s);
+    pthread_join(thread, NULL);
+    StandbyStats sstats;
+    standby_get_stats(s, &sstats);
+    standby_destroy(s);
+    replicator_destroy(r);
+
+    TEST_ASSERT_EQUAL_UINT64(0, sstats.rejected);
+    TEST_ASSERT_EQUAL_INT(0, sstats.diverged);
+    for (int i = 0; i < 2; ++i) {
+        TEST_ASSERT_EQUAL_INT(primary.vehicles[i].has_exited, standby.vehicles[i].has_exited);
+        TEST_ASSERT_EQUAL_INT(primary.vehicles[i].fee, standby.vehicles[i].fee);
+        TEST_ASSERT_EQUAL_INT(time_to_minutes(primary.vehicles[i].entry_time),
+                              time_to_minutes(standby.vehicles[i].entry_time));
+    }
+    TEST_ASSERT_EQUAL_INT(0, standby.vehicles[0].has_exited);
+    TEST_ASSERT_EQUAL_INT64(primary.revenue_cents, standby.revenue_cents);
+}
+
+/**
+ * @brief Test that a full log drops new events and reports the lag.
+ */
+void test_replication_log_full(void) {
+    Replicator *r = replicator_create("test_replication_absent.sock", 2);
+    TEST_ASSERT_NOT_NULL(r);
+
+    ReplEvent ev = {0};
+    ev.ev.type = EVENT_ENTRY;
+    strcpy(ev.ev.license_plate, "LAG1");
+    TEST_ASSERT_EQUAL_INT(0, replicator_append(r, &ev));
+    TEST_ASSERT_EQUAL_INT(0, replicator_append(r, &ev));
+    TEST_ASSERT_EQUAL_INT(-1, replicator_append(r, &ev));
+
+    ReplicationStats stats;
+    replicator_get_stats(r, &stats);
+    TEST_ASSERT_EQUAL_UINT64(2, stats.appended);
+    TEST_ASSERT_EQUAL_UINT64(2, stats.lag_events);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.dropped);
+    TEST_ASSERT_EQUAL_INT(0, stats.connected);
+    TEST_ASSERT_EQUAL_INT(1, stats.broken);
+    TEST_ASSERT_TRUE(stats.lag_ns > 0);
+
+    // Once broken, nothing more is logged, even after the log drained
+    TEST_ASSERT_EQUAL_INT(-1, replicator_append(r, &ev));
+    TEST_ASSERT_EQUAL_INT(-1, replicator_sync(r, 10));
+    replicator_destroy(r);
+}
+
+static void *standby_result_thread(void *arg) {
+    static int result;
+    result = standby_run(arg);
+    return &result;
+}
+
+/**
+ * @brief Polls a standby's counters until it reports diverged or two seconds pass.
+ */
+static void wait_diverged(Standby *s, StandbyStats *stats) {
+    for (int i = 0; i < 200; ++i) {
+        standby_get_stats(s, stats);
+        if (stats->diverged) return;
+        usleep(10000);
+    }
+}
+
+/**
+ * @brief Test that a standby behind an overflowed log diverges and refuses promotion.
+ */
+void test_replication_overflow_diverges_standby(void) {
+    static Garage primary, standby;
+    init_garage(&primary);
+    init_garage(&standby);
+    const char *path = "test_replication_overflow.sock";
+
+    Replicator *r = replicator_create(path, 2);
+    TEST_ASSERT_NOT_NULL(r);
+    garage_set_replicator(&primary, r);
+    register_entry(&primary, "OVF1", (Time){8, 0});
+    register_entry(&primary, "OVF2", (Time){8, 1});
+    register_entry(&primary, "OVF3", (Time){8, 2}); // does not fit: the stream breaks
+
+    Standby *s = standby_create(&standby, path);
+    TEST_ASSERT_NOT_NULL(s);
+    pthread_t thread;
+    pthread_create(&thread, NULL, standby_result_thread, s);
+
+    StandbyStats sstats;
+    wait_diverged(s, &sstats);
+    TEST_ASSERT_EQUAL_INT(1, sstats.diverged);
+    TEST_ASSERT_EQUAL_UINT64(2, sstats.applied_seq);
+
+    standby_stop(s);
+    void *result;
+    pthread_join(thread, &result);
+    TEST_ASSERT_EQUAL_INT(-1, *(int *)result);
+    standby_destroy(s);
+    replicator_destroy(r);
+}
+
+/**
+ * @brief Test that a standby whose garage refuses an event diverges and applies nothing more.
+ */
+void test_replication_rejected_event_diverges(void) {
+    static Garage primary, standby;
+    init_garage(&primary);
+    init_garage(&standby);
+    set_duplicate_policy(&primary, DUPLICATE_ALLOW); // the standby keeps rejecting duplicates
+    const char *path = "test_replication_rejected.sock";
+
+    Standby *s = standby_create(&standby, path);
+    TEST_ASSERT_NOT_NULL(s);
+    pthread_t thread;
+    pthread_create(&thread, NULL, standby_result_thread, s);
+    Replicator *r = replicator_create(path, 64);
+    TEST_ASSERT_NOT_NULL(r);
+    garage_set_replicator(&primary, r);
+
+    register_entry(&primary, "REJ1", (Time){8, 0});
+    register_entry(&primary, "REJ1", (Time){8, 5});
+    register_entry(&primary, "REJ2", (Time){8, 10});
+
+    StandbyStats sstats;
+    wait_diverged(s, &sstats);
+    TEST_ASSERT_EQUAL_INT(1, sstats.diverged);
+    TEST_ASSERT_EQUAL_UINT64(1, sstats.rejected);
+    TEST_ASSERT_EQUAL_INT(-1, replicator_sync(r, 5000));
+
+    standby_stop(s);
+    void *result;
+    pthread_join(thread, &result);
+    TEST_ASSERT_EQUAL_INT(-1, *(int *)result);
+    TEST_ASSERT_EQUAL_INT(1, current_occupancy(&standby)); // nothing after the refused entry
+    standby_destroy(s);
+    replicator_destroy(r);
+}
+
+/**
+ * @brief Test that a restarted primary is not mistaken for a resend of the old one.
+ */
+void test_replication_new_primary_epoch(void) {
+    static Garage first, second, standby;
+    init_garage(&first);
+    init_garage(&second);
+    init_garage(&standby);
+    const char *path = "test_replication_epoch.sock";
+
+    Standby *s = standby_create(&standby, path);
+    TEST_ASSERT_NOT_NULL(s);
+    pthread_t thread;
+    pthread_create(&thread, NULL, standby_result_thread, s);
+
+    Replicator *r = replicator_create(path, 64);
+    garage_set_replicator(&first, r);
+    register_entry(&first, "EPO1", (Time){8, 0});
+    register_entry(&first, "EPO2", (Time){8, 5});
+    TEST_ASSERT_EQUAL_INT(0, replicator_sync(r, 5000));
+    replicator_destroy(r);
+
+    // The restarted primary numbers its events from 1 again
+    r = replicator_create(path, 64);
+    garage_set_replicator(&second, r);
+    register_entry(&second, "EPO3", (Time){9, 0});
+
+    StandbyStats sstats;
+    wait_diverged(s, &sstats);
+    TEST_ASSERT_EQUAL_INT(1, sstats.diverged);
+    TEST_ASSERT_EQUAL_INT(-1, replicator_sync(r, 5000)); // returns once the diverged ack arrived
+    ReplicationStats stats;
+    replicator_get_stats(r, &stats);
+    TEST_ASSERT_EQUAL_INT(1, stats.standby_diverged);
+
+    standby_stop(s);
+    void *result;
+    pthread_join(thread, &result);
+    TEST_ASSERT_EQUAL_INT(-1, *(int *)result);
+    TEST_ASSERT_EQUAL_INT(2, current_occupancy(&standby)); // nothing of the new primary was applied
+    standby_destroy(s);
+    replicator_destroy(r);
+}
@@ -0,0 +1,86 @@
+/**
+ * @file test_report_pool.c
+ * @brief Unit tests for the work-stealing report pool in report_pool.c
+ */
+
+#include "unity.h"
+#include "garage.h"
+#include "report_pool.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define POOL_TEST_GARAGES 7
+
+/**
+ * @brief Test that every garage gets its report and the totals are merged.
+ */
+void test_report_pool_writes_all_reports(void) {
+    static Garage garages[POOL_TEST_GARAGES];
+    const Garage *list[POOL_TEST_GARAGES];
+    char names[POOL_TEST_GARAGES][32];
+    const char *paths[POOL_TEST_GARAGES];
+    char plate[20];
+
+    // Garage i gets 10 * i vehicles, every other one leaves after 2 hours
+    for (int i = 0; i < POOL_TEST_GARAGES; ++i) {
+        init_garage(&garages[i]);
+        for (int v = 0; v < 10 * i; ++v) {
+            snprintf(plate, sizeof(plate), "RP%d-%d", i, v);
+            register_entry(&garages[i], plate, (Time){8, v % 60});
+            if (v % 2 == 0) log_exit(&garages[i], plate, (Time){10, v % 60});
+        }
+        snprintf(names[i], sizeof(names[i]), "test_pool_report%d.txt", i);
+        list[i] = &garages[i];
+        paths[i] = names[i];
+    }
+
+    ReportSummary summary;
+    TEST_ASSERT_EQUAL_INT(0, report_pool_run(list, paths, POOL_TEST_GARAGES, 3, &summary));
+    TEST_ASSERT_EQUAL_INT(POOL_TEST_GARAGES, summary.reports);
+    TEST_ASSERT_EQUAL_INT(0, summary.failed);
+    TEST_ASSERT_EQUAL_INT(210, summary.served);
+    TEST_ASSERT_EQUAL_INT(105, summary.still_inside);
+    TEST_ASSERT_EQUAL_INT64(105 * 400, summary.revenue_cents);
+
+    char line[128];
+    for (int i = 0; i < POOL_TEST_GARAGES; ++i) {
+        FILE *fp = fopen(paths[i], "r");
+        TEST_ASSERT_NOT_NULL(fp);
+        TEST_ASSERT_NOT_NULL(fgets(line, sizeof(line), fp));
+        TEST_ASSERT_EQUAL_STRING("Daily Parking Garage Report\n", line);
+        fclose(fp);
+        unlink(paths[i]);
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, write_report_summary(&summary, "test_pool_summary.txt"));
+    FILE *fp = fopen("test_pool_summary.txt", "r");
+    TEST_ASSERT_NOT_NULL(fp);
+    int found = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (strcmp(line, "Vehicles Still Inside: 105\n") == 0) found = 1;
+    }
+    fclose(fp);
+    unlink("test_pool_summary.txt");
+    TEST_ASSERT_TRUE(found);
+}
+
+/**
+ * @brief Test that a report that cannot be written is counted without stopping the batch.
+ */
+void test_report_pool_counts_failures(void) {
+    static Garage garages[2];
+    init_garage(&garages[0]);
+    init_garage(&garages[1]);
+    const Garage *list[2] = {&garages[0], &garages[1]};
+    const char *paths[2] = {"no_such_dir/report.txt", "test_pool_ok.txt"};
+
+    ReportSummary summary;
+    TEST_ASSERT_EQUAL_INT(-1, report_pool_run(list, paths, 2, 0, &summary));
+    TEST_ASSERT_EQUAL_INT(1, summary.reports);
+    TEST_ASSERT_EQUAL_INT(1, summary.failed);
+    unlink("test_pool_ok.txt");
+
+    TEST_ASSERT_EQUAL_INT(0, report_pool_run(list, paths, 0, 4, &summary));
+    TEST_ASSERT_EQUAL_INT(0, summary.reports);
+}
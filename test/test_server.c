@@ -0,0 +1,221 @@
+/**
+ * @file test_server.c
+ * @brief Unit tests for the gate controller server in server.c and the binary protocol in binproto.c
+ */
+
+#include "unity.h"
+#include "garage.h"
+#include "server.h"
+#include "binproto.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * @brief Test that ENTRY and EXIT commands update the garage and report the fee.
+ */
+void test_server_entry_exit_commands(void) {
+    Garage g = {0};
+    char out[64];
+
+    server_handle_line(&g, "ENTRY SRV1 08:00", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("OK\n", out);
+
+    server_handle_line(&g, "EXIT SRV1 09:30", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("FEE 4\n", out);
+
+    server_handle_line(&g, "EXIT SRV1 09:30", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("NOTFOUND\n", out);
+}
+
+/**
+ * @brief Test the occupancy query and rejection of malformed commands.
+ */
+void test_server_occupancy_and_errors(void) {
+    Garage g = {0};
+    char out[64];
+
+    server_handle_line(&g, "ENTRY SRV2 10:00", out, sizeof(out));
+    server_handle_line(&g, "OCC", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("OCC 1 99\n", out);
+
+    server_handle_line(&g, "ENTRY SRV3 25:00", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("ERR\n", out);
+
+    server_handle_line(&g, "PARK SRV3 10:00", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("ERR\n", out);
+    TEST_ASSERT_EQUAL_INT(1, g.count);
+}
+
+static void *server_thread(void *arg) {
+    server_run((Server *)arg);
+    return NULL;
+}
+
+/**
+ * @brief Test pipelined commands over a real socket connection.
+ *
+ * Sends several commands in one write and expects all responses in order.
+ */
+void test_server_pipelined_socket(void) {
+    Garage g = {0};
+    const char *path = "test_server.sock";
+    Server *s = server_create(&g, path);
+    TEST_ASSERT_NOT_NULL(s);
+
+    pthread_t tid;
+    pthread_create(&tid, NULL, server_thread, s);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    TEST_ASSERT_EQUAL_INT(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+
+    const char *batch = "ENTRY PIPE1 08:00\nENTRY PIPE2 08:05\nEXIT PIPE1 10:00\nOCC\n";
+    TEST_ASSERT_EQUAL_INT((int)strlen(batch), (int)write(fd, batch, strlen(batch)));
+
+    const char *expected = "OK\nOK\nFEE 4\nOCC 1 99\n";
+    char buffer[128] = {0};
+    size_t got = 0;
+    while (got < strlen(expected)) {
+        ssize_t n = read(fd, buffer + got, sizeof(buffer) - 1 - got);
+        if (n <= 0) break;
+        got += (size_t)n;
+    }
+    close(fd);
+
+    server_stop(s);
+    pthread_join(tid, NULL);
+    server_destroy(s);
+
+    TEST_ASSERT_EQUAL_STRING(expected, buffer);
+}
+
+/**
+ * @brief Test that a client which pipelines without reading is stopped, and loses no responses.
+ */
+void test_server_backpressure(void) {
+    Garage g = {0};
+    const char *path = "test_server_bp.sock";
+    Server *s = server_create(&g, path);
+    TEST_ASSERT_NOT_NULL(s);
+
+    pthread_t tid;
+    pthread_create(&tid, NULL, server_thread, s);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    TEST_ASSERT_EQUAL_INT(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    // Without backpressure the server would keep reading and queue every response
+    const long limit = 1000000;
+    long sent = 0;
+    int blocked = 0;
+    while (sent < limit) {
+        ssize_t n = write(fd, "OCC\n", 4);
+        if (n == 4) {
+            sent++;
+            blocked = 0;
+            continue;
+        }
+        TEST_ASSERT_TRUE(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+        // blocked for 100 ms in a row: the server has stopped reading
+        if (++blocked == 100) break;
+        usleep(1000);
+    }
+    TEST_ASSERT_TRUE(sent < limit);
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    struct timeval timeout = {5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    char buffer[4096];
+    long lines = 0;
+    while (lines < sent) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n <= 0) break;
+        for (ssize_t i = 0; i < n; ++i) lines += buffer[i] == '\n';
+    }
+    close(fd);
+
+    server_stop(s);
+    pthread_join(tid, NULL);
+    server_destroy(s);
+
+    TEST_ASSERT_EQUAL_INT64(sent, lines);
+}
+
+/**
+ * @brief Test binary request handling without a socket.
+ */
+void test_binproto_handle(void) {
+    Garage g = {0};
+    BinRequest req;
+    BinResponse resp;
+    Time in = {8, 0}, out = {10, 30};
+
+    binproto_make_request(&req, BIN_OP_ENTRY, "BIN1", in, 7);
+    binproto_handle(&g, &req, &resp);
+    TEST_ASSERT_EQUAL_INT(BIN_OK, resp.status);
+    TEST_ASSERT_EQUAL_UINT32(7, resp.tag);
+
+    binproto_make_request(&req, BIN_OP_EXIT, "BIN1", out, 8);
+    binproto_handle(&g, &req, &resp);
+    TEST_ASSERT_EQUAL_INT(BIN_OK, resp.status);
+    TEST_ASSERT_EQUAL_INT(6, resp.value);
+
+    binproto_make_request(&req, BIN_OP_CORRECT_ENTRY, "MISSING", in, 9);
+    binproto_handle(&g, &req, &resp);
+    TEST_ASSERT_EQUAL_INT(BIN_NOT_FOUND, resp.status);
+
+    req.op = 99;
+    binproto_handle(&g, &req, &resp);
+    TEST_ASSERT_EQUAL_INT(BIN_ERROR, resp.status);
+}
+
+/**
+ * @brief Test pipelined binary requests over a socket using the client library.
+ */
+void test_binproto_pipelined_socket(void) {
+    Garage g = {0};
+    const char *path = "test_binproto.sock";
+    Server *s = server_create(&g, path);
+    TEST_ASSERT_NOT_NULL(s);
+
+    pthread_t tid;
+    pthread_create(&tid, NULL, server_thread, s);
+
+    int fd = binclient_connect(path);
+    TEST_ASSERT_TRUE(fd >= 0);
+
+    BinRequest reqs[3];
+    BinResponse resps[3];
+    Time in = {9, 0}, out = {9, 45};
+    binproto_make_request(&reqs[0], BIN_OP_ENTRY, "BINS1", in, 1);
+    binproto_make_request(&reqs[1], BIN_OP_OCCUPANCY, NULL, in, 2);
+    binproto_make_request(&reqs[2], BIN_OP_EXIT, "BINS1", out, 3);
+
+    TEST_ASSERT_EQUAL_INT(0, binclient_send(fd, reqs, 3));
+    TEST_ASSERT_EQUAL_INT(0, binclient_recv(fd, resps, 3));
+    close(fd);
+
+    server_stop(s);
+    pthread_join(tid, NULL);
+    server_destroy(s);
+
+    TEST_ASSERT_EQUAL_UINT32(1, resps[0].tag);
+    TEST_ASSERT_EQUAL_INT(BIN_OK, resps[0].status);
+    TEST_ASSERT_EQUAL_INT(1, resps[1].value);
+    TEST_ASSERT_EQUAL_INT(99, resps[1].value2);
+    TEST_ASSERT_EQUAL_UINT32(3, resps[2].tag);
+    TEST_ASSERT_EQUAL_INT(2, resps[2].value);
+}
@@ -0,0 +1,141 @@
+/**
+ * @file test_stay_index.c
+ * @brief Unit tests for the stay index in stay_index.c and the audit queries built on it
+ */
+
+#include "unity.h"
+#include "stay_index.h"
+#include "garage.h"
+#include "functions.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Brute-force count of the recorded stays, archived ones included, that overlap [from, to] (minutes).
+ */
+static int scan_inside(const Garage *g, int from, int to) {
+    VehicleIterator it;
+    const Vehicle *v;
+    int n = 0;
+    vehicle_iter_init(&it, g, NULL);
+    while ((v = vehicle_iter_next(&it)) != NULL) {
+        int entry = time_to_minutes(v->entry_time), exit = time_to_minutes(v->exit_time);
+        if (v->has_exited && exit < entry) {
+            // overnight: [entry, 24:00) and [00:00, exit)
+            if (entry <= to || exit > from) n++;
+            continue;
+        }
+        if (entry > to) continue;
+        if (!v->has_exited || exit > from) n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Test that bits are added, removed and popped lowest first.
+ */
+void test_stay_index_bitmaps(void) {
+    StayIndex idx;
+    memset(&idx, 0, sizeof(idx));
+    stay_index_add(&idx, 3, 8, 10);
+    stay_index_add(&idx, 70, 9, 9);
+    stay_index_add(&idx, 5, 12, 23);
+    stay_index_remove(&idx, 3, 10, 10);
+
+    StaySet set;
+    stay_index_candidates(&idx, 9, 10, &set);
+    TEST_ASSERT_EQUAL_INT(3, stay_set_pop(&set));
+    TEST_ASSERT_EQUAL_INT(70, stay_set_pop(&set));
+    TEST_ASSERT_EQUAL_INT(-1, stay_set_pop(&set));
+
+    stay_index_candidates(&idx, 10, 11, &set);
+    TEST_ASSERT_EQUAL_INT(-1, stay_set_pop(&set));
+}
+
+/**
+ * @brief Test that archived stays are listed in the hours they overlap, growing as needed.
+ */
+void test_stay_archive_lists(void) {
+    StayArchiveIndex idx;
+    memset(&idx, 0, sizeof(idx));
+    for (int stay = 0; stay < 40; ++stay) {
+        TEST_ASSERT_EQUAL_INT(0, stay_archive_reserve(&idx));
+        stay_archive_add(&idx, stay, stay % 2 ? 8 : 22, stay % 2 ? 9 : 30);
+    }
+
+    TEST_ASSERT_EQUAL_INT(20, idx.count[8]);
+    TEST_ASSERT_EQUAL_INT(20, idx.count[23]);
+    TEST_ASSERT_EQUAL_INT(0, idx.count[12]);
+    TEST_ASSERT_EQUAL_INT(1, idx.stays[9][0]);
+    TEST_ASSERT_EQUAL_INT(38, idx.stays[22][19]);
+
+    stay_archive_free(&idx);
+    TEST_ASSERT_NULL(idx.stays[8]);
+    TEST_ASSERT_EQUAL_INT(0, idx.count[8]);
+}
+
+/**
+ * @brief Test audit queries against a full scan through exits, corrections and slot reuse.
+ */
+void test_garage_inside_at_matches_scan(void) {
+    static Garage g;
+    init_garage(&g);
+    char plate[20];
+
+    for (int i = 0; i < 140; ++i) {
+        snprintf(plate, sizeof(plate), "AUD%d", i);
+        Time in = {(i * 7) % 20, (i * 13) % 60};
+        register_entry(&g, plate, in);
+        if (i % 9 == 4) log_exit(&g, plate, (Time){(in.hour + 20) % 24, (i * 11) % 60});
+        else if (i % 3 != 0) log_exit(&g, plate, (Time){in.hour + 1 + i % 3, (i * 11) % 60});
+        if (i % 10 == 0) update_entry_time(&g, plate, (Time){in.hour / 2, 5});
+        if (i % 7 == 1) update_exit_time(&g, plate, (Time){23, i % 60});
+    }
+
+    const Vehicle *out[2 * GARAGE_CAPACITY];
+    for (int m = 0; m < 24 * 60; m += 17) {
+        Time t = {m / 60, m % 60};
+        int n = garage_inside_at(&g, t, out, 2 * GARAGE_CAPACITY);
+        TEST_ASSERT_EQUAL_INT(scan_inside(&g, m, m), n);
+        for (int i = 0; i < n; ++i) {
+            int entry = time_to_minutes(out[i]->entry_time);
+            int overnight = out[i]->has_exited && time_to_minutes(out[i]->exit_time) < entry;
+            TEST_ASSERT_TRUE(overnight || entry <= m);
+        }
+    }
+
+    const Time ranges[][2] = {{{9, 30}, {11, 0}}, {{0, 0}, {2, 30}}, {{21, 10}, {23, 59}}, {{0, 0}, {23, 59}}};
+    for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); ++r) {
+        int from = time_to_minutes(ranges[r][0]), to = time_to_minutes(ranges[r][1]);
+        TEST_ASSERT_EQUAL_INT(scan_inside(&g, from, to),
+                              garage_inside_between(&g, ranges[r][0], ranges[r][1], out, 2 * GARAGE_CAPACITY));
+    }
+    free_garage(&g);
+}
+
+/**
+ * @brief Test that an overnight stay is inside both before and after midnight.
+ */
+void test_garage_inside_overnight_stay(void) {
+    Garage g = {0};
+    const Vehicle *out[4];
+
+    register_entry(&g, "NIGHT1", (Time){22, 0});
+    register_entry(&g, "DAY1", (Time){9, 0});
+    TEST_ASSERT_EQUAL_INT(4, log_exit(&g, "DAY1", (Time){10, 30}));
+    TEST_ASSERT_EQUAL_INT(8, log_exit(&g, "NIGHT1", (Time){2, 0}));
+
+    TEST_ASSERT_EQUAL_INT(1, garage_inside_at(&g, (Time){23, 0}, out, 4));
+    TEST_ASSERT_EQUAL_STRING("NIGHT1", out[0]->license_plate);
+    TEST_ASSERT_EQUAL_INT(1, garage_inside_at(&g, (Time){1, 0}, out, 4));
+    TEST_ASSERT_EQUAL_STRING("NIGHT1", out[0]->license_plate);
+    TEST_ASSERT_EQUAL_INT(0, garage_inside_at(&g, (Time){2, 0}, out, 4));
+    TEST_ASSERT_EQUAL_INT(0, garage_inside_at(&g, (Time){12, 0}, out, 4));
+    TEST_ASSERT_EQUAL_INT(1, garage_inside_at(&g, (Time){9, 30}, out, 4));
+    TEST_ASSERT_EQUAL_INT(2, garage_inside_between(&g, (Time){1, 30}, (Time){9, 0}, out, 4));
+
+    // correcting the overnight exit moves the stay's early-morning buckets
+    TEST_ASSERT_EQUAL_INT(0, update_exit_time(&g, "NIGHT1", (Time){4, 15}));
+    TEST_ASSERT_EQUAL_INT(1, garage_inside_at(&g, (Time){4, 0}, out, 4));
+    TEST_ASSERT_EQUAL_INT(0, garage_inside_at(&g, (Time){4, 15}, out, 4));
+}